@@ -27,11 +27,11 @@ namespace Backend {
 
         Scope(Scope* parent) {
             this->parent = parent;
-            this->variables = DS::Hashmap<DS::View<char>, InterpreterValue>(&Memory::global_general_allocator, 1);
-            this->functions =  DS::Hashmap<DS::View<char>, Frontend::FunctionDeclaration*>(&Memory::global_general_allocator, 1);
+            this->variables = DS::Hashmap<String::Symbol, InterpreterValue>(&Memory::global_general_allocator, 1);
+            this->functions =  DS::Hashmap<String::Symbol, Frontend::FunctionDeclaration*>(&Memory::global_general_allocator, 1);
         }
 
-        bool has_var(DS::View<char> key) {
+        bool has_var(String::Symbol key) {
             Scope* current = this;
             while (current != nullptr) {
                 if (current->variables.has(key)) {
@@ -44,7 +44,7 @@ namespace Backend {
             return false;
         }
 
-        void put_var(DS::View<char> key, InterpreterValue value) {
+        void put_var(String::Symbol key, InterpreterValue value) {
             Scope* current = this;
             while (current != nullptr) {
                 if (current->variables.has(key)) {
@@ -57,7 +57,7 @@ namespace Backend {
             this->variables.put(key, value);
         }
 
-        InterpreterValue get_var(DS::View<char> key) {
+        InterpreterValue get_var(String::Symbol key) {
             RUNTIME_ASSERT(this->has_var(key));
             
             Scope* current = this;
@@ -74,7 +74,7 @@ namespace Backend {
 
         // ----------------------------------------
 
-        bool has_func(DS::View<char> key) {
+        bool has_func(String::Symbol key) {
             Scope* current = this;
             while (current != nullptr) {
                 if (current->functions.has(key)) {
@@ -87,13 +87,13 @@ namespace Backend {
             return false;
         }
 
-        void put_func(DS::View<char> key, Frontend::FunctionDeclaration* value) {
+        void put_func(String::Symbol key, Frontend::FunctionDeclaration* value) {
             RUNTIME_ASSERT(!this->has_var(key));
             
             this->functions.put(key, value);
         }
 
-        Frontend::FunctionDeclaration* get_func(DS::View<char> key) {
+        Frontend::FunctionDeclaration* get_func(String::Symbol key) {
             RUNTIME_ASSERT(this->has_func(key));
             
             Scope* current = this;
@@ -108,8 +108,8 @@ namespace Backend {
             return nullptr;
         }
     private:
-        DS::Hashmap<DS::View<char>, InterpreterValue> variables;
-        DS::Hashmap<DS::View<char>, Frontend::FunctionDeclaration*> functions;
+        DS::Hashmap<String::Symbol, InterpreterValue> variables;
+        DS::Hashmap<String::Symbol, Frontend::FunctionDeclaration*> functions;
     };
 
     InterpreterValue interpret_nodes(DS::Vector<ASTNode*> nodes, Scope* scope);
@@ -332,7 +332,7 @@ namespace Backend {
             interpret_decleration(decl, &global_scope);
         }
 
-        DS::View main_key = DS::View("main", sizeof("main") - 1);
+        String::Symbol main_key = String::global_interner()->intern("main", sizeof("main") - 1);
         FunctionDeclaration* main_decl = global_scope.get_func(main_key);
         interpret_nodes(main_decl->body, &global_scope);
     }
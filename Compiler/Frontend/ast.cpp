@@ -69,7 +69,7 @@ namespace Frontend {
                 JSON* identifier_root = JSON::Object(allocator);
                 JSON* desc = JSON::Object(allocator);
 
-                desc->object.push("name", JSON::String(allocator, e->identifier->name));
+                desc->object.push("name", JSON::String(allocator, String::global_interner()->view(e->identifier->name)));
                 desc->object.push("type", JSON::String(allocator, e->identifier->type.name));
 
                 identifier_root->object.push("Identifier", desc);
@@ -91,7 +91,7 @@ namespace Frontend {
                 JSON* variable_root = JSON::Object(allocator);
                 
                 JSON* desc = JSON::Object(allocator);
-                desc->push("variable_name", decl->variable->variable_name);
+                desc->push("variable_name", String::global_interner()->view(decl->variable->variable_name));
 
                 // TODO(Jovanni): Make type have a to_string() that can return the modifiers "[]*int"
                 desc->push("type_name", decl->variable->type.name); 
@@ -107,7 +107,7 @@ namespace Frontend {
 
                 JSON* desc = JSON::Object(allocator);
                 JSON* body_json = JSON::Array(allocator);
-                desc->push("function_name", decl->function->function_name);
+                desc->push("function_name", String::global_interner()->view(decl->function->function_name));
                 desc->push("return_type", decl->function->return_type.name);
                 desc->push("body", body_json);
                 for (ASTNode* node : decl->function->body) {
@@ -133,7 +133,7 @@ namespace Frontend {
                 JSON* assignment_root = JSON::Object(allocator);
                 
                 JSON* desc = JSON::Object(allocator);
-                desc->push("variable_name", s->assignment->variable_name);
+                desc->push("variable_name", String::global_interner()->view(s->assignment->variable_name));
                 desc->push("right", expression_to_json(s->assignment->rhs, allocator));
 
                 assignment_root->push("AssignmentStatement", desc);
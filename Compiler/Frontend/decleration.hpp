@@ -9,19 +9,19 @@ namespace Frontend {
     typedef struct ASTNode ASTNode;
 
     struct VariableDecleration {
-        DS::View<char> variable_name;
+        String::Symbol variable_name;
         Type type;
         Expression* rhs;
         u32 line;
     };
 
     struct Parameter {
-        DS::View<char> variable_name;
+        String::Symbol variable_name;
         Type type;
     };
 
     struct FunctionDeclaration {
-        DS::View<char> function_name;
+        String::Symbol function_name;
         DS::Vector<Parameter> parameters;
         Type return_type;
         DS::Vector<ASTNode*> body;
@@ -41,7 +41,7 @@ namespace Frontend {
         };
 
         static Decleration* Variable(
-            Memory::BaseAllocator* allocator, DS::View<char> name, 
+            Memory::BaseAllocator* allocator, String::Symbol name, 
             Type type, Expression* rhs, u32 line
         ) {
             Decleration* ret = (Decleration*)allocator->malloc(sizeof(Decleration));
@@ -56,7 +56,7 @@ namespace Frontend {
         }
 
         static Decleration* Function(
-            Memory::BaseAllocator* allocator, DS::View<char> func_name, 
+            Memory::BaseAllocator* allocator, String::Symbol func_name, 
             DS::Vector<Parameter> parameters, Type return_type, DS::Vector<ASTNode*> body, u32 line
         ) {
             Decleration* ret = (Decleration*)allocator->malloc(sizeof(Decleration));
@@ -41,7 +41,7 @@ namespace Frontend {
         return ret;
     }
 
-    Expression* Expression::Identifier(Memory::BaseAllocator* allocator, DS::View<char> name, Type type, int line) {
+    Expression* Expression::Identifier(Memory::BaseAllocator* allocator, String::Symbol name, Type type, int line) {
         Expression* ret = (Expression*)allocator->malloc(sizeof(Expression));
         ret->type = EXPRESSION_TYPE_IDENTIFIER;
         ret->identifier = (IdentifierExpression*)allocator->malloc(sizeof(IdentifierExpression));
@@ -87,7 +87,7 @@ namespace Frontend {
 
     Expression* Expression::FunctionCall(
         Memory::BaseAllocator* allocator, 
-        DS::View<char> name, Type return_type, 
+        String::Symbol name, Type return_type, 
         DS::Vector<Expression*> arguments,
         u32 line
     ) {
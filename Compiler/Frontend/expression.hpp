@@ -27,7 +27,7 @@ namespace Frontend {
     };
 
     struct IdentifierExpression {
-        DS::View<char> name;
+        String::Symbol name;
         Type type;
         int line;
     };
@@ -58,7 +58,7 @@ namespace Frontend {
     };
 
     struct FunctionCallExpression {
-        DS::View<char> function_name;
+        String::Symbol function_name;
         DS::Vector<Expression*> arguments;
         Type return_type;
         u32 line;
@@ -96,14 +96,14 @@ namespace Frontend {
         static Expression* Float(Memory::BaseAllocator* allocator, float value, int line);
         static Expression* Boolean(Memory::BaseAllocator* allocator, bool value, int line);
 
-        static Expression* Identifier(Memory::BaseAllocator* allocator, DS::View<char> name, Type type, int line);
+        static Expression* Identifier(Memory::BaseAllocator* allocator, String::Symbol name, Type type, int line);
         static Expression* Unary(Memory::BaseAllocator* allocator, Token operation, Expression* operand, int line);
         static Expression* Binary(Memory::BaseAllocator* allocator, Token operation, Expression* left, Expression* right, int line);
         static Expression* Grouping(Memory::BaseAllocator* allocator, Expression* value, int line);
 
         static Expression* FunctionCall(
             Memory::BaseAllocator* allocator, 
-            DS::View<char> name, Type return_type, 
+            String::Symbol name, Type return_type, 
             DS::Vector<Expression*> arguments,
             u32 line
         );
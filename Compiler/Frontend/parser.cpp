@@ -49,7 +49,7 @@ namespace Frontend {
         DS::Vector<Expression*> arguments = DS::Vector<Expression*>(parser->allocator, 1);
         parse_arguments(parser, arguments);
 
-        return Expression::FunctionCall(parser->allocator, identifier.sv, Type(), arguments, identifier.line);
+        return Expression::FunctionCall(parser->allocator, identifier.symbol, Type(), arguments, identifier.line);
     }
 
     // <primary> ::= INTEGER | FLOAT | TRUE | FALSE | STRING | IDENTIFIER | "(" <expression> ")"
@@ -71,7 +71,7 @@ namespace Frontend {
             }
 
             parser->expect(TOKEN_IDENTIFIER);
-            return Expression::Identifier(parser->allocator, current_token.sv, Type(), current_token.line);
+            return Expression::Identifier(parser->allocator, current_token.symbol, Type(), current_token.line);
         } else if (parser->consume_on_match(TS_LEFT_PAREN)) {
             Expression* expression = parse_expression(parser);
             parser->expect(TS_RIGHT_PAREN);
@@ -182,7 +182,7 @@ namespace Frontend {
 
         parser->expect(TS_SEMI_COLON);
 
-        return Decleration::Variable(parser->allocator, variable_name.sv, type, rhs, var.line);
+        return Decleration::Variable(parser->allocator, variable_name.symbol, type, rhs, var.line);
     }
 
     void parse_code_block(Parser* parser, DS::Vector<ASTNode*>& out_code_block) {
@@ -208,7 +208,7 @@ namespace Frontend {
         parser->expect(TS_LEFT_PAREN);
         while (!parser->consume_on_match(TS_RIGHT_PAREN)) {
             Parameter param = {};
-            param.variable_name = parser->expect(TOKEN_IDENTIFIER).sv;
+            param.variable_name = parser->expect(TOKEN_IDENTIFIER).symbol;
             param.type = parse_type(parser);
 
             parameters.push(param);
@@ -233,7 +233,7 @@ namespace Frontend {
         DS::Vector<ASTNode*> body = DS::Vector<ASTNode*>(parser->allocator, 1);
         parse_code_block(parser, body);
 
-        return Decleration::Function(parser->allocator, function_name.sv, parameters, return_type, body, func.line);
+        return Decleration::Function(parser->allocator, function_name.symbol, parameters, return_type, body, func.line);
     }
 
     Statement* parse_assignment_statement(Parser* parser) {
@@ -243,7 +243,7 @@ namespace Frontend {
         Expression* rhs = parse_expression(parser);
         parser->expect(TS_SEMI_COLON);
 
-        return Statement::Assignment(parser->allocator, identifer.sv, rhs, identifer.line);
+        return Statement::Assignment(parser->allocator, identifer.symbol, rhs, identifer.line);
     }
 
     Statement* parse_return_statement(Parser* parser) {
@@ -302,7 +302,7 @@ namespace Frontend {
         return program;
     }
 
-    ASTNode* generate_ast(Memory::BaseAllocator* allocator, const DS::Vector<Token>& tokens) {
+    ASTNode* generate_ast(Memory::BaseAllocator* allocator, TokenStream& tokens) {
         Parser parser = Parser(allocator, tokens);
 
         return ASTNode::Program(allocator, parse_program(&parser));
@@ -4,5 +4,5 @@
 #include "ast.hpp"
 
 namespace Frontend {
-    ASTNode* generate_ast(Memory::BaseAllocator* allocator, const DS::Vector<Token>& tokens);
+    ASTNode* generate_ast(Memory::BaseAllocator* allocator, TokenStream& tokens);
 }
\ No newline at end of file
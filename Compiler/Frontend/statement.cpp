@@ -1,7 +1,7 @@
 #include "statement.hpp"
 
 namespace Frontend {
-    Statement* Statement::Assignment(Memory::BaseAllocator* allocator, DS::View<char> name, Expression* rhs, u32 line) {
+    Statement* Statement::Assignment(Memory::BaseAllocator* allocator, String::Symbol name, Expression* rhs, u32 line) {
         Statement* ret = (Statement*)allocator->malloc(sizeof(Statement));
         ret->type = STATEMENT_TYPE_ASSIGNMENT;
         ret->assignment = (AssignmentStatement*)allocator->malloc(sizeof(AssignmentStatement));
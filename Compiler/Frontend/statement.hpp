@@ -9,7 +9,7 @@ namespace Frontend {
     typedef struct Decleration Decleration;
 
     struct AssignmentStatement {
-        DS::View<char> variable_name;
+        String::Symbol variable_name;
         Expression* rhs;
         u32 line;
     };
@@ -72,7 +72,7 @@ namespace Frontend {
             PrintStatement* print;
         };
 
-        static Statement* Assignment(Memory::BaseAllocator* allocator, DS::View<char> name, Expression* rhs, u32 line);
+        static Statement* Assignment(Memory::BaseAllocator* allocator, String::Symbol name, Expression* rhs, u32 line);
         static Statement* Return(Memory::BaseAllocator* allocator, Expression* expression, u32 line);
         static Statement* Scope(Memory::BaseAllocator* allocator, DS::Vector<ASTNode*> body, u32 line);
         static Statement* Print(Memory::BaseAllocator* allocator, Expression* expr, u32 line);
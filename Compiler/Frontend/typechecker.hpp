@@ -10,7 +10,7 @@ namespace Frontend {
             this->parent = parent;
         }
 
-        bool has_var(DS::View<char> key) {
+        bool has_var(String::Symbol key) {
             TypeEnvironment* current = this;
             while (current != nullptr) {
                 if (current->variables.has(key)) {
@@ -23,13 +23,13 @@ namespace Frontend {
             return false;
         }
 
-        void put_var(DS::View<char> key, VariableDecleration* value) {
+        void put_var(String::Symbol key, VariableDecleration* value) {
             RUNTIME_ASSERT(!this->has_var(key));
             
             this->variables.put(key, value);
         }
 
-        VariableDecleration* get_var(DS::View<char> key) {
+        VariableDecleration* get_var(String::Symbol key) {
             RUNTIME_ASSERT(this->has_var(key));
             
             TypeEnvironment* current = this;
@@ -46,7 +46,7 @@ namespace Frontend {
 
         // ----------------------------------------
 
-        bool has_func(DS::View<char> key) {
+        bool has_func(String::Symbol key) {
             TypeEnvironment* current = this;
             while (current != nullptr) {
                 if (current->functions.has(key)) {
@@ -59,13 +59,13 @@ namespace Frontend {
             return false;
         }
 
-        void put_func(DS::View<char> key, FunctionDeclaration* value) {
+        void put_func(String::Symbol key, FunctionDeclaration* value) {
             RUNTIME_ASSERT(!this->has_var(key));
             
             this->functions.put(key, value);
         }
 
-        FunctionDeclaration* get_func(DS::View<char> key) {
+        FunctionDeclaration* get_func(String::Symbol key) {
             RUNTIME_ASSERT(this->has_func(key));
             
             TypeEnvironment* current = this;
@@ -81,8 +81,8 @@ namespace Frontend {
         }
 
     private:
-        DS::Hashmap<DS::View<char>, VariableDecleration*> variables = DS::Hashmap<DS::View<char>, VariableDecleration*>(&Memory::global_general_allocator);
-        DS::Hashmap<DS::View<char>, FunctionDeclaration*> functions = DS::Hashmap<DS::View<char>, FunctionDeclaration*>(&Memory::global_general_allocator);
+        DS::Hashmap<String::Symbol, VariableDecleration*> variables = DS::Hashmap<String::Symbol, VariableDecleration*>(&Memory::global_general_allocator);
+        DS::Hashmap<String::Symbol, FunctionDeclaration*> functions = DS::Hashmap<String::Symbol, FunctionDeclaration*>(&Memory::global_general_allocator);
     };
 
     void type_check_ast_helper(ASTNode* node, TypeEnvironment* env);
@@ -138,7 +138,8 @@ namespace Frontend {
             } break;
 
             case EXPRESSION_TYPE_IDENTIFIER: {
-                RUNTIME_ASSERT_MSG(env->has_var(e->identifier->name), "Undeclared identifier: %.*s\n", e->identifier->name.length, e->identifier->name.data);
+                DS::View<char> name = String::global_interner()->view(e->identifier->name);
+                RUNTIME_ASSERT_MSG(env->has_var(e->identifier->name), "Undeclared identifier: %.*s\n", name.length, name.data);
                 VariableDecleration* var_decl = env->get_var(e->identifier->name);
                 e->identifier->type = var_decl->type;
 
@@ -158,8 +159,9 @@ namespace Frontend {
     Type type_check_decleration(Decleration* decl, TypeEnvironment* env) {
         switch (decl->type) {
             case DECLERATION_TYPE_VARIABLE: {
+                DS::View<char> variable_name = String::global_interner()->view(decl->variable->variable_name);
                 if (env->has_var(decl->variable->variable_name)) {
-                    RUNTIME_ASSERT_MSG(false, "Duplicate variable decleration: %.*s\n", decl->variable->variable_name.length, decl->variable->variable_name.data);
+                    RUNTIME_ASSERT_MSG(false, "Duplicate variable decleration: %.*s\n", variable_name.length, variable_name.data);
                 }
 
                 env->put_var(decl->variable->variable_name, decl->variable);
@@ -168,7 +170,7 @@ namespace Frontend {
                     Type expression_type = type_check_expression(decl->variable->rhs, env);
 
                     if (expression_type.type == TPT_VOID) {
-                        RUNTIME_ASSERT_MSG(false, "Attempting to assign void to varible: %.*s\n", decl->variable->variable_name.length, decl->variable->variable_name.data);
+                        RUNTIME_ASSERT_MSG(false, "Attempting to assign void to varible: %.*s\n", variable_name.length, variable_name.data);
                     }
 
                     if (decl->variable->type.name.data == nullptr) {
@@ -185,12 +187,13 @@ namespace Frontend {
             } break;
 
             case DECLERATION_TYPE_FUNCTION: {
+                DS::View<char> function_name = String::global_interner()->view(decl->function->function_name);
                 if (env->parent != nullptr) {
-                    RUNTIME_ASSERT_MSG(false, "Not allowed to declare function: %.*s outside of global scope\n", decl->function->function_name.length, decl->function->function_name.data);
+                    RUNTIME_ASSERT_MSG(false, "Not allowed to declare function: %.*s outside of global scope\n", function_name.length, function_name.data);
                 }
 
                 if (env->has_func(decl->function->function_name)) {
-                    RUNTIME_ASSERT_MSG(false, "Duplicate function decleration: %.*s\n", decl->function->function_name.length, decl->function->function_name.data);
+                    RUNTIME_ASSERT_MSG(false, "Duplicate function decleration: %.*s\n", function_name.length, function_name.data);
                 }
 
                 env->put_func(decl->function->function_name, decl->function);
@@ -224,7 +227,7 @@ namespace Frontend {
                             if (decl->function->return_type != actual_return_type) {
                                 RUNTIME_ASSERT_MSG(false, "returning invalid type: %.*s from function: %.*s\n", 
                                     actual_return_type.name.length, actual_return_type.name.data,
-                                    decl->function->function_name.length, decl->function->function_name.data
+                                    function_name.length, function_name.data
                                 );
                             }
                         }
@@ -251,9 +254,10 @@ namespace Frontend {
         switch (s->type) {
             case STATEMENT_TYPE_ASSIGNMENT: {
                 if (!env->has_var(s->assignment->variable_name)) {
+                    DS::View<char> variable_name = String::global_interner()->view(s->assignment->variable_name);
                     RUNTIME_ASSERT_MSG(
                         false, "Error Line: %d | Undeclared identifier '%.*s'\n", 
-                        s->assignment->line, s->assignment->variable_name.length, s->assignment->variable_name.data
+                        s->assignment->line, variable_name.length, variable_name.data
                     );
                 }
 
@@ -323,7 +327,7 @@ namespace Frontend {
         TypeEnvironment global_environment(nullptr);
 
         type_check_ast_helper(node, &global_environment);
-        if (!global_environment.has_func(DS::View("main", sizeof("main") - 1))) {
+        if (!global_environment.has_func(String::global_interner()->intern("main", sizeof("main") - 1))) {
             RUNTIME_ASSERT_MSG(false, "Missing main function");
         }
     }
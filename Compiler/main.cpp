@@ -5,39 +5,64 @@
 
 #define PROGRAM_CAPACITY KB(20)
 
+internal void run_program(Memory::BaseAllocator* allocator, TokenStream& tokens) {
+    tokens.log_tokens = true;
+
+    Frontend::ASTNode* ast = Frontend::generate_ast(allocator, tokens);
+    Frontend::type_check_ast(ast);
+    
+    ast->pretty_print(&Memory::global_general_allocator);
+
+    Backend::interpret_program(ast);
+}
+
+internal void run_source(Memory::BaseAllocator* allocator, u8* data, byte_t file_size, const char* token_cache_directory) {
+    // unchanged sources come straight from the mapped cache file, the lexer only runs on a miss
+    if (token_cache_directory) {
+        TokenCache cache = TokenCache(&Memory::global_general_allocator, DS::View<char>((char*)data, file_size));
+        if (cache.open(token_cache_directory)) {
+            TokenStream tokens = TokenStream(&cache);
+            run_program(allocator, tokens);
+
+            return;
+        }
+    }
+
+    // lexed on demand as the parser pulls, only the lookahead ring is resident
+    TokenStream tokens = TokenStream(data, file_size);
+    run_program(allocator, tokens);
+}
+
 int main(int argc, char** argv) {
     char* executable_name = argv[0];
     if (argc < 2) {
-        LOG_ERROR("Usage: %s <filename>\n", executable_name);
+        LOG_ERROR("Usage: %s <filename> [--token-cache <directory>]\n", executable_name);
         return 0;
     }
 
+    const char* token_cache_directory = nullptr;
+    for (int i = 2; i + 1 < argc; i++) {
+        if (String::equal(argv[i], String::length(argv[i]), "--token-cache", sizeof("--token-cache") - 1)) {
+            token_cache_directory = argv[i + 1];
+        }
+    }
+
     u8 program_memory[PROGRAM_CAPACITY] = {0};
     Memory::ArenaAllocator allocator = Memory::ArenaAllocator::Fixed(program_memory, PROGRAM_CAPACITY, true);
 
     char* file_name = argv[1];
     Error error = ERROR_SUCCESS;
 
+    // the source is mapped rather than copied, the arena only holds the AST
     byte_t file_size = 0;
-    u8* data = Platform::read_entire_file(&allocator, file_name, file_size, error);
+    u8* data = Platform::map_file(file_name, file_size, error);
     if (error != ERROR_SUCCESS) {
         LOG_ERROR("Error failed to read file: %s\n", error_str(error));
+        return 0;
     }
 
-    DS::Vector<Token> tokens = DS::Vector<Token>(&allocator, 50);
-    Lexer::generate_tokens(data, file_size, tokens);
-
-    for (const Token& token : tokens) {
-        const char* token_type_string = token.type_to_string();
-        LOG_DEBUG("%s(%.*s) | Line: %d\n", token_type_string, token.sv.length, token.sv.data, token.line);
-    }
-
-    Frontend::ASTNode* ast = Frontend::generate_ast(&allocator, tokens);
-    Frontend::type_check_ast(ast);
-    
-    ast->pretty_print(&Memory::global_general_allocator);
-
-    Backend::interpret_program(ast);
+    run_source(&allocator, data, file_size, token_cache_directory);
+    Platform::unmap_file(data, file_size);
 
     return 0;
 }
\ No newline at end of file
@@ -49,4 +49,32 @@ constexpr float EPSILON = 0.0001f;
     #define UNUSED_FUNCTION __attribute__((used))
 #elif defined(__GNUC__) || defined(__GNUG__)
     #define UNUSED_FUNCTION __attribute__((used))
-#endif
\ No newline at end of file
+#endif
+
+// SANITIZE_ADDRESS / SANITIZE_THREAD are set when building with AddressSanitizer / ThreadSanitizer
+// (gcc and msvc define __SANITIZE_ADDRESS__, clang only answers __has_feature).
+// NO_SANITIZE_ADDRESS and NO_SANITIZE_THREAD are for functions that read past the end of a buffer on purpose and stay inside the page,
+// ThreadSanitizer also tracks frees and reports those reads when they touch a freed neighbour.
+#if defined(__SANITIZE_ADDRESS__)
+    #define SANITIZE_ADDRESS
+#elif defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define SANITIZE_ADDRESS
+    #endif
+#endif
+
+#if defined(__SANITIZE_THREAD__)
+    #define SANITIZE_THREAD
+#elif defined(__has_feature)
+    #if __has_feature(thread_sanitizer)
+        #define SANITIZE_THREAD
+    #endif
+#endif
+
+#if defined(_MSC_VER)
+    #define NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+    #define NO_SANITIZE_THREAD
+#elif defined(__clang__) || defined(__GNUC__)
+    #define NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+    #define NO_SANITIZE_THREAD __attribute__((no_sanitize_thread))
+#endif
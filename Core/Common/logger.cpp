@@ -18,16 +18,13 @@
 #define COLOR_RESET "\033[0m"
 
 internal byte_t va_sprint(char* buffer, byte_t buffer_size, const char* fmt, va_list args) {
+    // one pass straight into the caller's buffer, vsnprintf still reports the full size
     va_list args_copy;
     va_copy(args_copy, args);
-    byte_t out_size = (byte_t)vsnprintf(nullptr, 0, fmt, args_copy) + 1; // +1 for null terminator
-    RUNTIME_ASSERT(out_size < buffer_size);
+    byte_t out_size = (byte_t)vsnprintf(buffer, buffer_size, fmt, args_copy) + 1; // +1 for null terminator
     va_end(args_copy);
+    RUNTIME_ASSERT(out_size < buffer_size);
 
-    va_copy(args_copy, args);
-    vsnprintf(buffer, out_size, fmt, args_copy);
-    va_end(args_copy); 
-    
     return out_size;
 }
 
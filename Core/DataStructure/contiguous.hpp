@@ -88,8 +88,16 @@ namespace DS {
             this->destory();
         }
 
+        // New elements are whatever the allocator hands back, shrinking keeps the capacity
         void resize(u64 count) {
-            RUNTIME_ASSERT_MSG(false, "resize not implemented!\n");
+            if (count > this->m_capacity) {
+                byte_t old_allocation_size = (this->m_capacity * sizeof(T));
+                this->m_capacity = MAX(count, this->m_capacity * 2);
+                byte_t new_allocation_size = (this->m_capacity * sizeof(T));
+                this->m_data = (T*)this->m_allocator->realloc(this->m_data, old_allocation_size, new_allocation_size);
+            }
+
+            this->m_count = count;
         }
 
         void push(T value) {
@@ -2,4 +2,5 @@
 
 #include "contiguous.hpp"
 #include "hashmap.hpp"
-#include "view.hpp"
\ No newline at end of file
+#include "view.hpp"
+#include "lru_cache.hpp"
\ No newline at end of file
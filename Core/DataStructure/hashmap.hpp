@@ -1,3 +1,5 @@
+#pragma once
+
 #include <initializer_list>
 #include <type_traits>
 
@@ -8,6 +10,11 @@
 #include "../Hashing/hashing.hpp"
 
 #define HASHMAP_DEFAULT_LOAD_FACTOR 0.7f
+#define HASHMAP_HASH_BATCH_COUNT 32
+
+namespace String {
+    u64 length(const char* c_string);
+}
 
 namespace DS {
     typedef u64(HashFunction)(const void*, byte_t);
@@ -42,7 +49,7 @@ namespace DS {
             this->m_entries = (HashmapEntry*)this->m_allocator->malloc(this->m_capacity * sizeof(HashmapEntry));
 
             if constexpr (key_is_trivial && !key_is_pointer) {
-                this->m_hash_func = Hashing::siphash24;
+                this->m_hash_func = Hashing::fast_hash;
                 this->m_equal_func = Memory::equal;
             } else if constexpr (key_is_cstring) {
                 this->m_hash_func = Hashing::cstring_hash;
@@ -66,7 +73,7 @@ namespace DS {
             this->m_entries = (HashmapEntry*)this->m_allocator->malloc(this->m_capacity * sizeof(HashmapEntry));
 
             if constexpr (key_is_trivial && !key_is_pointer) {
-                this->m_hash_func = Hashing::siphash24;
+                this->m_hash_func = Hashing::fast_hash;
                 this->m_equal_func = Memory::equal;
             } else if constexpr (key_is_cstring) {
                 this->m_hash_func = Hashing::cstring_hash;
@@ -120,26 +127,36 @@ namespace DS {
 
         void put(K key, V value) {
             if (this->load_factor() >= HASHMAP_DEFAULT_LOAD_FACTOR) {
-                this->grow_and_rehash();
+                this->rehash(this->capacity_for(1));
             }
 
-            u64 hash = this->safe_hash(key);
-            s64 index = this->resolve_collision(key, hash % this->m_capacity);
-            RUNTIME_ASSERT(index != -1);
+            byte_t key_size = this->safe_key_size(key);
+            u64 hash = this->safe_hash(key, key_size);
+            this->put_hashed(key, key_size, hash, value);
+        }
 
-            HashmapEntry* entry = &this->m_entries[index];
-            if (!entry->filled || entry->dead) {
-                this->m_count += 1;
+        // Bulk insert: grows once up front and hashes the keys in batches before probing
+        void put_many(const K* keys, const V* values, u64 count) {
+            if ((float)(this->m_dead_count + this->m_count + count) / (float)this->m_capacity >= HASHMAP_DEFAULT_LOAD_FACTOR) {
+                this->rehash(this->capacity_for(count));
             }
 
-            entry->key = key;
-            entry->value = value;
-            entry->filled = true;
+            byte_t key_sizes[HASHMAP_HASH_BATCH_COUNT];
+            u64 hashes[HASHMAP_HASH_BATCH_COUNT];
+            for (u64 i = 0; i < count; i += HASHMAP_HASH_BATCH_COUNT) {
+                u64 batch_count = MIN(HASHMAP_HASH_BATCH_COUNT, count - i);
+                this->safe_hash_many(keys + i, batch_count, key_sizes, hashes);
+
+                for (u64 j = 0; j < batch_count; j++) {
+                    this->put_hashed(keys[i + j], key_sizes[j], hashes[j], values[i + j]);
+                }
+            }
         }
 
         bool has(K key) {
-            u64 hash = this->safe_hash(key);
-            s64 index = this->resolve_collision(key, hash % this->m_capacity);
+            byte_t key_size = this->safe_key_size(key);
+            u64 hash = this->safe_hash(key, key_size);
+            s64 index = this->resolve_collision(key, key_size, hash % this->m_capacity);
             if (index == -1) {
                 return false;
             }
@@ -152,8 +169,9 @@ namespace DS {
         V get(K key) {
             RUNTIME_ASSERT_MSG(this->has(key), "Key doesn't exist\n");
 
-            u64 hash = this->safe_hash(key);
-            s64 index = this->resolve_collision(key, hash % this->m_capacity);
+            byte_t key_size = this->safe_key_size(key);
+            u64 hash = this->safe_hash(key, key_size);
+            s64 index = this->resolve_collision(key, key_size, hash % this->m_capacity);
             RUNTIME_ASSERT(index != -1);
             
             HashmapEntry* entry = &this->m_entries[index];
@@ -165,8 +183,9 @@ namespace DS {
         V remove(K key) {
             RUNTIME_ASSERT_MSG(this->has(key), "Key doesn't exist\n");
 
-            u64 hash = this->safe_hash(key);
-            s64 index = this->resolve_collision(key, hash % this->m_capacity);
+            byte_t key_size = this->safe_key_size(key);
+            u64 hash = this->safe_hash(key, key_size);
+            s64 index = this->resolve_collision(key, key_size, hash % this->m_capacity);
             RUNTIME_ASSERT(index != -1);
             
             HashmapEntry* entry = &this->m_entries[index];
@@ -187,6 +206,10 @@ namespace DS {
         u64 count() {
             return this->m_count;
         }
+
+        u64 capacity() {
+            return this->m_capacity;
+        }
     private:
         u64 m_count = 0;
         u64 m_capacity = 0;
@@ -196,33 +219,84 @@ namespace DS {
         EqualFunction* m_equal_func = nullptr;
         Memory::BaseAllocator* m_allocator = nullptr;
 
-        void grow_and_rehash() {
+        void put_hashed(K key, byte_t key_size, u64 hash, V value) {
+            s64 index = this->resolve_collision(key, key_size, hash % this->m_capacity);
+            RUNTIME_ASSERT(index != -1);
+
+            HashmapEntry* entry = &this->m_entries[index];
+            if (!entry->filled || entry->dead) {
+                this->m_count += 1;
+            }
+
+            if (entry->dead) {
+                this->m_dead_count -= 1;
+            }
+
+            entry->key = key;
+            entry->value = value;
+            entry->filled = true;
+            entry->dead = false;
+        }
+
+        // Tombstones count towards the load factor but are dropped by a rehash, so the table only doubles
+        // when the live entries fill half of it. Remove heavy use (like LruCache evictions) rehashes in place.
+        u64 capacity_for(u64 incoming_count) {
+            u64 live_count = this->m_count + incoming_count;
+            u64 new_capacity = MAX(this->m_capacity, (u64)1);
+            if ((float)live_count / (float)new_capacity >= HASHMAP_DEFAULT_LOAD_FACTOR / 2) {
+                new_capacity *= 2;
+            }
+
+            while ((float)live_count / (float)new_capacity >= HASHMAP_DEFAULT_LOAD_FACTOR) {
+                new_capacity *= 2;
+            }
+
+            return new_capacity;
+        }
+
+        void rehash(u64 new_capacity) {
             u64 old_capacity = this->m_capacity;
             HashmapEntry* old_entries = this->m_entries;
 
-            this->m_capacity *= 2;
+            this->m_capacity = new_capacity;
+            this->m_dead_count = 0;
             byte_t new_allocation_size = (this->m_capacity * sizeof(HashmapEntry));
             this->m_entries = (HashmapEntry*)this->m_allocator->malloc(new_allocation_size);
             Memory::zero(this->m_entries, new_allocation_size);
 
-            // rehash
-            for (u64 i = 0; i < old_capacity; i++) {
-                HashmapEntry old_entry = old_entries[i];
-                if (!old_entry.filled || old_entry.dead) {
-                    continue;
+            // rehash, live keys are gathered and hashed in batches
+            K keys[HASHMAP_HASH_BATCH_COUNT];
+            HashmapEntry* sources[HASHMAP_HASH_BATCH_COUNT];
+            byte_t key_sizes[HASHMAP_HASH_BATCH_COUNT];
+            u64 hashes[HASHMAP_HASH_BATCH_COUNT];
+
+            u64 i = 0;
+            while (i < old_capacity) {
+                u64 batch_count = 0;
+                for (; i < old_capacity && batch_count < HASHMAP_HASH_BATCH_COUNT; i++) {
+                    HashmapEntry* old_entry = &old_entries[i];
+                    if (!old_entry->filled || old_entry->dead) {
+                        continue;
+                    }
+
+                    keys[batch_count] = old_entry->key;
+                    sources[batch_count] = old_entry;
+                    batch_count += 1;
                 }
 
-                u64 hash = this->safe_hash(old_entry.key);
-                s64 index = this->resolve_collision(old_entry.key, hash % this->m_capacity);
-                RUNTIME_ASSERT(index != -1);
+                this->safe_hash_many(keys, batch_count, key_sizes, hashes);
+                for (u64 j = 0; j < batch_count; j++) {
+                    s64 index = this->resolve_collision(keys[j], key_sizes[j], hashes[j] % this->m_capacity);
+                    RUNTIME_ASSERT(index != -1);
 
-                this->m_entries[index] = old_entry;
+                    this->m_entries[index] = *sources[j];
+                }
             }
 
             this->m_allocator->free(old_entries);
         }
 
-        s64 resolve_collision(K key, u64 inital_hash_index) {
+        s64 resolve_collision(K key, byte_t key_size, u64 inital_hash_index) {
             s64 cannonical_hash_index = inital_hash_index;
 
             u64 visited_count = 0;
@@ -232,7 +306,7 @@ namespace DS {
                     break;
                 }
 
-                bool equality_match = this->safe_equality(key, entry->key);
+                bool equality_match = this->safe_equality(key, key_size, entry->key);
                 if (equality_match) {
                     break;
                 }
@@ -255,16 +329,31 @@ namespace DS {
         
         #define NOT_USED 0
 
-        u64 safe_hash(K key) {
+        // cstring keys are measured once per operation, the length is shared by the hash and every equality probe
+        byte_t safe_key_size(K key) {
+            constexpr bool key_is_trivial = std::is_trivially_copyable_v<K>;
+            constexpr bool key_is_pointer = std::is_pointer_v<K>;
+            constexpr bool key_is_cstring = std::is_same_v<K, char*> || std::is_same_v<K, const char*>;
+
+            if constexpr (key_is_trivial && !key_is_pointer) {
+                return sizeof(K);
+            } else if constexpr (key_is_cstring) {
+                return String::length(key);
+            } else {
+                return NOT_USED;
+            }
+        }
+
+        u64 safe_hash(K key, byte_t key_size) {
             constexpr bool key_is_trivial = std::is_trivially_copyable_v<K>;
             constexpr bool key_is_pointer = std::is_pointer_v<K>;
             constexpr bool key_is_cstring = std::is_same_v<K, char*> || std::is_same_v<K, const char*>;
             constexpr bool key_is_string_view = std::is_same_v<K, DS::View<char>> || std::is_same_v<K, DS::View<const char>>;
 
             if constexpr (key_is_trivial && !key_is_pointer) {
-                return this->m_hash_func(&key, sizeof(K));
+                return this->m_hash_func(&key, key_size);
             } else if constexpr (key_is_cstring) {
-                return this->m_hash_func((void*)key, NOT_USED);
+                return this->m_hash_func((void*)key, key_size);
             } else if constexpr (key_is_string_view) {
                 return this->m_hash_func(&key, NOT_USED);
             } else {
@@ -272,16 +361,56 @@ namespace DS {
             }
         }
 
-        bool safe_equality(K k1, K k2) {
+        // Uses the batched Hashing::hash_many when the map has the default hash function for its key type
+        void safe_hash_many(const K* keys, u64 count, byte_t* out_key_sizes, u64* out_hashes) {
+            constexpr bool key_is_trivial = std::is_trivially_copyable_v<K>;
+            constexpr bool key_is_pointer = std::is_pointer_v<K>;
+            constexpr bool key_is_cstring = std::is_same_v<K, char*> || std::is_same_v<K, const char*>;
+            constexpr bool key_is_string_view = std::is_same_v<K, DS::View<char>> || std::is_same_v<K, DS::View<const char>>;
+
+            RUNTIME_ASSERT(count <= HASHMAP_HASH_BATCH_COUNT);
+
+            for (u64 i = 0; i < count; i++) {
+                out_key_sizes[i] = this->safe_key_size(keys[i]);
+            }
+
+            if constexpr (key_is_trivial && !key_is_pointer) {
+                if (this->m_hash_func == Hashing::fast_hash) {
+                    Hashing::hash_many(keys, sizeof(K), sizeof(K), count, out_hashes);
+                    return;
+                }
+            } else if constexpr (key_is_cstring) {
+                if (this->m_hash_func == Hashing::cstring_hash) {
+                    DS::View<char> views[HASHMAP_HASH_BATCH_COUNT];
+                    for (u64 i = 0; i < count; i++) {
+                        views[i] = DS::View<char>(keys[i], out_key_sizes[i]);
+                    }
+
+                    Hashing::hash_many(views, count, out_hashes);
+                    return;
+                }
+            } else if constexpr (key_is_string_view) {
+                if (this->m_hash_func == Hashing::string_view_hash) {
+                    Hashing::hash_many((const DS::View<char>*)keys, count, out_hashes);
+                    return;
+                }
+            }
+
+            for (u64 i = 0; i < count; i++) {
+                out_hashes[i] = this->safe_hash(keys[i], out_key_sizes[i]);
+            }
+        }
+
+        bool safe_equality(K k1, byte_t k1_size, K k2) {
             constexpr bool key_is_trivial = std::is_trivially_copyable_v<K>;
             constexpr bool key_is_pointer = std::is_pointer_v<K>;
             constexpr bool key_is_cstring = std::is_same_v<K, char*> || std::is_same_v<K, const char*>;
             constexpr bool key_is_string_view = std::is_same_v<K, DS::View<char>> || std::is_same_v<K, DS::View<const char>>;
 
             if constexpr (key_is_trivial && !key_is_pointer) {
-                return this->m_equal_func(&k1, sizeof(K), &k2, sizeof(K));
+                return this->m_equal_func(&k1, k1_size, &k2, sizeof(K));
             } else if constexpr (key_is_cstring) {
-                return this->m_equal_func(k1, NOT_USED, k2, NOT_USED);
+                return this->m_equal_func(k1, k1_size, k2, NOT_USED);
             } else if constexpr (key_is_string_view) {
                 return this->m_equal_func(&k1, NOT_USED, &k2, NOT_USED);
             } else {
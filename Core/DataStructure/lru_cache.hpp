@@ -0,0 +1,269 @@
+#pragma once
+
+#include <type_traits>
+
+#include "../Memory/memory.hpp"
+#include "../Common/common.hpp"
+#include "hashmap.hpp"
+
+#define LRU_CACHE_INVALID_INDEX 0xFFFFFFFF
+
+namespace DS {
+    /**
+     * Bounded cache that evicts the least recently used entry.
+     * Nodes live in one contiguous array and are linked by index, the hashmap maps key -> node index.
+     *
+     * max_count is always enforced, max_cost is only enforced if it is non-zero
+     * (use it with the cost parameter of put() for byte based budgets).
+     */
+    template <typename K, typename V>
+    struct LruCache {
+        typedef void(EvictFunction)(K key, V value, void* user_data);
+
+        struct LruNode {
+            K key;
+            V value;
+            byte_t cost;
+            u32 prev;
+            u32 next;
+        };
+
+        LruCache(Memory::BaseAllocator* allocator, u32 max_count, byte_t max_cost = 0) : m_map(allocator, (u64)max_count * 2), m_allocator(allocator) {
+            RUNTIME_ASSERT_MSG(max_count > 0, "LruCache max_count can't be zero!\n");
+            RUNTIME_ASSERT(max_count != LRU_CACHE_INVALID_INDEX);
+
+            this->m_max_count = max_count;
+            this->m_max_cost = max_cost;
+            this->init_nodes();
+        }
+
+        LruCache(Memory::BaseAllocator* allocator, HashFunction* hash_func, EqualFunction* equal_func, u32 max_count, byte_t max_cost = 0) : m_map(allocator, hash_func, equal_func, (u64)max_count * 2), m_allocator(allocator) {
+            RUNTIME_ASSERT_MSG(max_count > 0, "LruCache max_count can't be zero!\n");
+            RUNTIME_ASSERT(max_count != LRU_CACHE_INVALID_INDEX);
+
+            this->m_max_count = max_count;
+            this->m_max_cost = max_cost;
+            this->init_nodes();
+        }
+
+        // Prevent copy
+        LruCache(const LruCache& other) = delete;
+        LruCache& operator=(const LruCache& other) = delete;
+
+        ~LruCache() {
+            if (this->m_allocator && this->m_nodes) {
+                this->m_allocator->free(this->m_nodes);
+            }
+
+            this->m_nodes = nullptr;
+            this->m_count = 0;
+        }
+
+        void set_evict_callback(EvictFunction* evict_func, void* user_data = nullptr) {
+            this->m_evict_func = evict_func;
+            this->m_evict_user_data = user_data;
+        }
+
+        void put(K key, V value, byte_t cost = 1) {
+            RUNTIME_ASSERT_MSG(this->m_max_cost == 0 || cost <= this->m_max_cost, "Entry cost is bigger than the whole cache!\n");
+
+            if (this->m_map.has(key)) {
+                u32 index = this->m_map.get(key);
+                LruNode* node = &this->m_nodes[index];
+                this->m_cost -= node->cost;
+
+                node->value = value;
+                node->cost = cost;
+                this->m_cost += cost;
+
+                this->move_to_front(index);
+                this->evict_until_within_budget();
+
+                return;
+            }
+
+            if (this->m_count == this->m_max_count) {
+                this->evict_least_recently_used();
+            }
+
+            u32 index = this->m_free_head;
+            RUNTIME_ASSERT(index != LRU_CACHE_INVALID_INDEX);
+            this->m_free_head = this->m_nodes[index].next;
+
+            LruNode* node = &this->m_nodes[index];
+            node->key = key;
+            node->value = value;
+            node->cost = cost;
+            this->link_front(index);
+
+            this->m_map.put(key, index);
+            this->m_count += 1;
+            this->m_cost += cost;
+
+            this->evict_until_within_budget();
+        }
+
+        bool has(K key) {
+            return this->m_map.has(key);
+        }
+
+        // Marks the entry as most recently used
+        V get(K key) {
+            RUNTIME_ASSERT_MSG(this->has(key), "Key doesn't exist\n");
+
+            u32 index = this->m_map.get(key);
+            this->move_to_front(index);
+
+            return this->m_nodes[index].value;
+        }
+
+        // Doesn't touch the recency order
+        V peek(K key) {
+            RUNTIME_ASSERT_MSG(this->has(key), "Key doesn't exist\n");
+
+            return this->m_nodes[this->m_map.get(key)].value;
+        }
+
+        V remove(K key) {
+            RUNTIME_ASSERT_MSG(this->has(key), "Key doesn't exist\n");
+
+            u32 index = this->m_map.remove(key);
+            V ret = this->m_nodes[index].value;
+            this->release_node(index);
+
+            return ret;
+        }
+
+        // Does not invoke the evict callback
+        void clear() {
+            this->m_map.clear();
+            this->init_free_list();
+        }
+
+        u64 count() const {
+            return this->m_count;
+        }
+
+        byte_t cost() const {
+            return this->m_cost;
+        }
+
+        u32 max_count() const {
+            return this->m_max_count;
+        }
+
+        byte_t max_cost() const {
+            return this->m_max_cost;
+        }
+
+    private:
+        LruNode* m_nodes = nullptr;
+        u32 m_head = LRU_CACHE_INVALID_INDEX; // most recently used
+        u32 m_tail = LRU_CACHE_INVALID_INDEX; // least recently used
+        u32 m_free_head = LRU_CACHE_INVALID_INDEX;
+        u64 m_count = 0;
+        u32 m_max_count = 0;
+        byte_t m_cost = 0;
+        byte_t m_max_cost = 0;
+        DS::Hashmap<K, u32> m_map;
+        EvictFunction* m_evict_func = nullptr;
+        void* m_evict_user_data = nullptr;
+        Memory::BaseAllocator* m_allocator = nullptr;
+
+        void init_nodes() {
+            this->m_nodes = (LruNode*)this->m_allocator->malloc(this->m_max_count * sizeof(LruNode));
+            this->init_free_list();
+        }
+
+        void init_free_list() {
+            for (u32 i = 0; i < this->m_max_count; i++) {
+                this->m_nodes[i].prev = LRU_CACHE_INVALID_INDEX;
+                this->m_nodes[i].next = (i + 1 < this->m_max_count) ? i + 1 : LRU_CACHE_INVALID_INDEX;
+            }
+
+            this->m_free_head = 0;
+            this->m_head = LRU_CACHE_INVALID_INDEX;
+            this->m_tail = LRU_CACHE_INVALID_INDEX;
+            this->m_count = 0;
+            this->m_cost = 0;
+        }
+
+        void link_front(u32 index) {
+            LruNode* node = &this->m_nodes[index];
+            node->prev = LRU_CACHE_INVALID_INDEX;
+            node->next = this->m_head;
+
+            if (this->m_head != LRU_CACHE_INVALID_INDEX) {
+                this->m_nodes[this->m_head].prev = index;
+            }
+
+            this->m_head = index;
+            if (this->m_tail == LRU_CACHE_INVALID_INDEX) {
+                this->m_tail = index;
+            }
+        }
+
+        void unlink(u32 index) {
+            LruNode* node = &this->m_nodes[index];
+
+            if (node->prev != LRU_CACHE_INVALID_INDEX) {
+                this->m_nodes[node->prev].next = node->next;
+            } else {
+                this->m_head = node->next;
+            }
+
+            if (node->next != LRU_CACHE_INVALID_INDEX) {
+                this->m_nodes[node->next].prev = node->prev;
+            } else {
+                this->m_tail = node->prev;
+            }
+
+            node->prev = LRU_CACHE_INVALID_INDEX;
+            node->next = LRU_CACHE_INVALID_INDEX;
+        }
+
+        void move_to_front(u32 index) {
+            if (this->m_head == index) {
+                return;
+            }
+
+            this->unlink(index);
+            this->link_front(index);
+        }
+
+        // The key must already be removed from the map
+        void release_node(u32 index) {
+            this->unlink(index);
+
+            this->m_count -= 1;
+            this->m_cost -= this->m_nodes[index].cost;
+
+            this->m_nodes[index].next = this->m_free_head;
+            this->m_free_head = index;
+        }
+
+        void evict_least_recently_used() {
+            RUNTIME_ASSERT(this->m_tail != LRU_CACHE_INVALID_INDEX);
+
+            u32 index = this->m_tail;
+            LruNode node = this->m_nodes[index];
+
+            this->m_map.remove(node.key);
+            this->release_node(index);
+
+            if (this->m_evict_func) {
+                this->m_evict_func(node.key, node.value, this->m_evict_user_data);
+            }
+        }
+
+        void evict_until_within_budget() {
+            if (this->m_max_cost == 0) {
+                return;
+            }
+
+            while (this->m_cost > this->m_max_cost) {
+                this->evict_least_recently_used();
+            }
+        }
+    };
+}
@@ -7,6 +7,7 @@ static const char* ERROR_STRINGS[ERROR_COUNT] = {
     stringify(ERROR_RESOURCE_TOO_BIG),
     stringify(ERROR_NULL_PARAMETER),
     stringify(ERROR_INVALID_PARAMETER),
+    stringify(ERROR_RESOURCE_EXHAUSTED),
 };
 
 const char* error_str(Error error_code) {
@@ -6,6 +6,7 @@ enum Error {
     ERROR_RESOURCE_TOO_BIG,
     ERROR_NULL_PARAMETER,
     ERROR_INVALID_PARAMETER,
+    ERROR_RESOURCE_EXHAUSTED,
     ERROR_COUNT
 };
 
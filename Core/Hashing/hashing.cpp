@@ -23,6 +23,28 @@
     #endif
 #endif
 
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #pragma intrinsic(_umul128)
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define HASHING_CRC32C_X64
+    #include <nmmintrin.h>
+    #if defined(_MSC_VER)
+        #define TARGET_CRC32C
+    #else
+        #define TARGET_CRC32C __attribute__((target("sse4.2")))
+    #endif
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    #define HASHING_CRC32C_ARM64
+    #define TARGET_CRC32C
+    #include <arm_acle.h>
+#endif
+
+#include <string.h>
+#include <atomic>
+
 namespace Hashing {
     #define ROTATE(x, b) (u64)( ((x) << (b)) | ( (x) >> (64 - (b))) )
 
@@ -89,42 +111,400 @@ namespace Hashing {
         return ret;
     }
 
-    u64 cstring_hash(const void* str, u64 str_length) {
-        (void)str_length;
+    // wyhash (final version 4), public domain
+    // https://github.com/wangyi-fudan/wyhash
+    global const u64 WYHASH_SECRET[4] = {
+        0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+        0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+    };
+
+    internal inline void wy_multiply(u64* a, u64* b) {
+        #if defined(_MSC_VER)
+            u64 high = 0;
+            u64 low = _umul128(*a, *b, &high);
+            *a = low;
+            *b = high;
+        #else
+            __uint128_t r = (__uint128_t)(*a) * (*b);
+            *a = (u64)r;
+            *b = (u64)(r >> 64);
+        #endif
+    }
+
+    internal inline u64 wy_mix(u64 a, u64 b) {
+        wy_multiply(&a, &b);
+        return a ^ b;
+    }
+
+    internal inline u64 wy_read8(const u8* p) {
+        u64 v;
+        memcpy(&v, p, 8);
+        return _le64toh(v);
+    }
+
+    internal inline u64 wy_read4(const u8* p) {
+        return ((u64)p[0]) | ((u64)p[1] << 8) | ((u64)p[2] << 16) | ((u64)p[3] << 24);
+    }
+
+    internal inline u64 wy_read3(const u8* p, u64 k) {
+        return (((u64)p[0]) << 16) | (((u64)p[k >> 1]) << 8) | p[k - 1];
+    }
+
+    u64 wyhash(const void* source, u64 source_size, u64 seed) {
+        const u8* p = (const u8*)source;
+        seed ^= wy_mix(seed ^ WYHASH_SECRET[0], WYHASH_SECRET[1]);
+
+        u64 a = 0;
+        u64 b = 0;
+        if (source_size <= 16) {
+            if (source_size >= 4) {
+                u64 offset = (source_size >> 3) << 2;
+                a = (wy_read4(p) << 32) | wy_read4(p + offset);
+                b = (wy_read4(p + source_size - 4) << 32) | wy_read4(p + source_size - 4 - offset);
+            } else if (source_size > 0) {
+                a = wy_read3(p, source_size);
+            }
+        } else {
+            u64 i = source_size;
+            if (i >= 48) {
+                u64 see1 = seed;
+                u64 see2 = seed;
+                do {
+                    seed = wy_mix(wy_read8(p) ^ WYHASH_SECRET[1], wy_read8(p + 8) ^ seed);
+                    see1 = wy_mix(wy_read8(p + 16) ^ WYHASH_SECRET[2], wy_read8(p + 24) ^ see1);
+                    see2 = wy_mix(wy_read8(p + 32) ^ WYHASH_SECRET[3], wy_read8(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (i >= 48);
+
+                seed ^= see1 ^ see2;
+            }
+
+            while (i > 16) {
+                seed = wy_mix(wy_read8(p) ^ WYHASH_SECRET[1], wy_read8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+
+            a = wy_read8(p + i - 16);
+            b = wy_read8(p + i - 8);
+        }
+
+        a ^= WYHASH_SECRET[1];
+        b ^= seed;
+        wy_multiply(&a, &b);
+
+        return wy_mix(a ^ WYHASH_SECRET[0] ^ source_size, b ^ WYHASH_SECRET[1]);
+    }
+
+    // Keys of 16 bytes or less (ints, enums, small structs) are a single multiply-xorshift mix
+    internal inline u64 fast_hash_inline(const u8* p, u64 source_size) {
+        if (source_size == 8) {
+            u64 a = wy_read8(p);
+            return wy_mix(a ^ WYHASH_SECRET[0], (a >> 32) ^ WYHASH_SECRET[1] ^ 8);
+        } else if (source_size == 4) {
+            u64 a = wy_read4(p);
+            return wy_mix(a ^ WYHASH_SECRET[0], (a << 32) ^ WYHASH_SECRET[1] ^ 4);
+        } else if (source_size <= 16) {
+            u64 a = 0;
+            u64 b = 0;
+            if (source_size >= 4) {
+                u64 offset = (source_size >> 3) << 2;
+                a = (wy_read4(p) << 32) | wy_read4(p + offset);
+                b = (wy_read4(p + source_size - 4) << 32) | wy_read4(p + source_size - 4 - offset);
+            } else if (source_size > 0) {
+                a = wy_read3(p, source_size);
+            }
+
+            return wy_mix(a ^ WYHASH_SECRET[0], b ^ WYHASH_SECRET[1] ^ source_size);
+        }
+
+        return wyhash(p, source_size, 0);
+    }
+
+    u64 fast_hash(const void* source, u64 source_size) {
+        return fast_hash_inline((const u8*)source, source_size);
+    }
+
+    #define HASHER_STRIPE_SIZE 64
+
+    Hasher::Hasher(u64 seed) {
+        for (int i = 0; i < 4; i++) {
+            this->lanes[i] = wy_mix(seed ^ WYHASH_SECRET[i], WYHASH_SECRET[(i + 1) % 4]);
+        }
+    }
+
+    // 4 independent lanes of 16 bytes so the multiplies overlap
+    void Hasher::consume_stripe(const u8* stripe) {
+        for (int i = 0; i < 4; i++) {
+            const u8* p = stripe + (i * 16);
+            this->lanes[i] = wy_mix(wy_read8(p) ^ WYHASH_SECRET[i], wy_read8(p + 8) ^ this->lanes[i]);
+        }
+    }
+
+    void Hasher::update(const void* data, u64 data_size) {
+        const u8* p = (const u8*)data;
+        this->total_size += data_size;
+
+        if (this->buffer_count > 0) {
+            u64 to_copy = MIN(HASHER_STRIPE_SIZE - this->buffer_count, data_size);
+            memcpy(this->buffer + this->buffer_count, p, to_copy);
+            this->buffer_count += to_copy;
+            p += to_copy;
+            data_size -= to_copy;
+
+            if (this->buffer_count < HASHER_STRIPE_SIZE) {
+                return;
+            }
+
+            this->consume_stripe(this->buffer);
+            this->buffer_count = 0;
+        }
+
+        while (data_size >= HASHER_STRIPE_SIZE) {
+            this->consume_stripe(p);
+            p += HASHER_STRIPE_SIZE;
+            data_size -= HASHER_STRIPE_SIZE;
+        }
+
+        if (data_size > 0) {
+            memcpy(this->buffer, p, data_size);
+            this->buffer_count = data_size;
+        }
+    }
+
+    Hash128 Hasher::finish128() const {
+        Hasher state = *this;
+        if (state.buffer_count > 0) {
+            memset(state.buffer + state.buffer_count, 0, HASHER_STRIPE_SIZE - state.buffer_count);
+            state.consume_stripe(state.buffer);
+        }
+
+        // total_size disambiguates the zero padding of the last stripe
+        u64 a = wy_mix(state.lanes[0] ^ WYHASH_SECRET[0], state.lanes[1] ^ state.total_size);
+        u64 b = wy_mix(state.lanes[2] ^ WYHASH_SECRET[1], state.lanes[3] ^ state.total_size);
+
+        Hash128 ret;
+        ret.low = wy_mix(a ^ WYHASH_SECRET[2], b ^ WYHASH_SECRET[3]);
+        ret.high = wy_mix(b ^ WYHASH_SECRET[0], a ^ WYHASH_SECRET[1] ^ state.total_size);
+
+        return ret;
+    }
 
-        u64 hash = 5381;
-        u8* str_ptr = (u8*)str;
-        int c;
+    u64 Hasher::finish() const {
+        return this->finish128().low;
+    }
+
+    Hash128 fingerprint128(const void* data, u64 data_size) {
+        Hasher hasher = Hasher();
+        hasher.update(data, data_size);
+
+        return hasher.finish128();
+    }
+
+    #undef HASHER_STRIPE_SIZE
+
+    #define HASHING_PAGE_SIZE 4096
+
+    // Reads the remaining (< 16) bytes as two zero padded little endian words.
+    // When the 16 byte window can't cross into the next page it is loaded whole and masked,
+    // which keeps variable length keys from mispredicting on a length switch.
+    // The bytes past the key are in a mapped page and masked off, but AddressSanitizer and ThreadSanitizer
+    // would report them as an overflow or a use after free, so sanitized builds always take the copy.
+    internal inline void read_tail16(const u8* p, u64 remaining, u64* out_a, u64* out_b) {
+        #if !defined(SANITIZE_ADDRESS) && !defined(SANITIZE_THREAD)
+        if ((((uintptr_t)p) & (HASHING_PAGE_SIZE - 1)) <= HASHING_PAGE_SIZE - 16) {
+            u64 bits = remaining * 8;
+            u64 mask_a = (bits >= 64) ? ~0ULL : ((1ULL << bits) - 1);
+            u64 mask_b = (bits <= 64) ? 0 : ((1ULL << (bits - 64)) - 1);
+
+            *out_a = wy_read8(p) & mask_a;
+            *out_b = wy_read8(p + 8) & mask_b;
+            return;
+        }
+        #endif
+
+        u8 padded[16] = {0};
+        memcpy(padded, p, remaining);
+        *out_a = wy_read8(padded);
+        *out_b = wy_read8(padded + 8);
+    }
+
+    internal u64 portable_string_hash(const char* data, u64 length) {
+        return wyhash(data, length, 0);
+    }
+
+    #if defined(HASHING_CRC32C_X64) || defined(HASHING_CRC32C_ARM64)
+        #if defined(HASHING_CRC32C_X64)
+            #define CRC32C_U64(crc, value) _mm_crc32_u64((crc), (value))
+        #else
+            #define CRC32C_U64(crc, value) __crc32cd((u32)(crc), (value))
+        #endif
+
+        struct Crc32cState {
+            const u8* p;
+            u64 remaining;
+            u64 length;
+            u64 lane_a;
+            u64 lane_b;
+        };
+
+        TARGET_CRC32C internal inline void crc32c_begin(Crc32cState* state, const char* data, u64 length) {
+            state->p = (const u8*)data;
+            state->remaining = length;
+            state->length = length;
+            state->lane_a = 0x9E3779B9;
+            state->lane_b = 0x85EBCA6B;
+        }
+
+        // Two independent crc32c lanes so 16 bytes are in flight per step
+        TARGET_CRC32C internal inline void crc32c_step(Crc32cState* state) {
+            state->lane_a = CRC32C_U64(state->lane_a, wy_read8(state->p));
+            state->lane_b = CRC32C_U64(state->lane_b, wy_read8(state->p + 8));
+            state->p += 16;
+            state->remaining -= 16;
+        }
+
+        // The tail (0-15 bytes) is zero padded to 16 and both lanes take one more step,
+        // the lanes are then folded together with one multiply.
+        TARGET_CRC32C internal inline u64 crc32c_end(Crc32cState* state) {
+            while (state->remaining >= 16) {
+                crc32c_step(state);
+            }
 
-        while ((c = *str_ptr++)) {
-            hash = ((hash << 5) + hash) + c;
+            u64 tail_a = 0;
+            u64 tail_b = 0;
+            read_tail16(state->p, state->remaining, &tail_a, &tail_b);
+            state->lane_a = CRC32C_U64(state->lane_a, tail_a);
+            state->lane_b = CRC32C_U64(state->lane_b, tail_b);
+
+            return wy_mix(((state->lane_a << 32) | state->lane_b) ^ WYHASH_SECRET[0], state->length ^ WYHASH_SECRET[1]);
         }
 
-        return hash;
+        TARGET_CRC32C internal u64 crc32c_string_hash(const char* data, u64 length) {
+            Crc32cState state;
+            crc32c_begin(&state, data, length);
+
+            return crc32c_end(&state);
+        }
+
+        // No indirect call per key and no dependency between iterations, so the crc chains
+        // of consecutive keys overlap. Every key still produces exactly crc32c_string_hash(key).
+        TARGET_CRC32C internal void crc32c_string_hash_many(const DS::View<char>* keys, u64 count, u64* out_hashes) {
+            for (u64 i = 0; i < count; i++) {
+                Crc32cState state;
+                crc32c_begin(&state, keys[i].data, keys[i].length);
+                out_hashes[i] = crc32c_end(&state);
+            }
+        }
+
+        #undef CRC32C_U64
+    #endif
+
+    internal bool has_hardware_crc32c() {
+        #if defined(HASHING_CRC32C_X64) && defined(_MSC_VER)
+            int info[4] = {0};
+            __cpuid(info, 1);
+            return (info[2] >> 20) & 1;
+        #elif defined(HASHING_CRC32C_X64)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.2");
+        #elif defined(HASHING_CRC32C_ARM64)
+            return true;
+        #else
+            return false;
+        #endif
+    }
+
+    typedef u64(StringHashFunction)(const char* data, u64 length);
+    internal u64 resolve_string_hash(const char* data, u64 length);
+
+    // Starts at the resolver so it is valid before any dynamic initialization,
+    // the first call swaps in the implementation the cpu supports.
+    // Atomic because threads can hash their first string at the same time, they all store the same pointer.
+    global std::atomic<StringHashFunction*> g_string_hash = resolve_string_hash;
+
+    internal inline StringHashFunction* string_hash_function() {
+        return g_string_hash.load(std::memory_order_relaxed);
+    }
+
+    internal u64 resolve_string_hash(const char* data, u64 length) {
+        #if defined(HASHING_CRC32C_X64) || defined(HASHING_CRC32C_ARM64)
+            StringHashFunction* hash_function = has_hardware_crc32c() ? crc32c_string_hash : portable_string_hash;
+        #else
+            StringHashFunction* hash_function = portable_string_hash;
+        #endif
+
+        g_string_hash.store(hash_function, std::memory_order_relaxed);
+
+        return hash_function(data, length);
+    }
+
+    u64 string_hash(const char* data, u64 length) {
+        return string_hash_function()(data, length);
+    }
+
+    void hash_many(const DS::View<char>* keys, u64 count, u64* out_hashes) {
+        if (string_hash_function() == resolve_string_hash) {
+            resolve_string_hash("", 0);
+        }
+
+        StringHashFunction* hash_function = string_hash_function();
+        #if defined(HASHING_CRC32C_X64) || defined(HASHING_CRC32C_ARM64)
+            if (hash_function == crc32c_string_hash) {
+                crc32c_string_hash_many(keys, count, out_hashes);
+                return;
+            }
+        #endif
+
+        for (u64 i = 0; i < count; i++) {
+            out_hashes[i] = hash_function(keys[i].data, keys[i].length);
+        }
+    }
+
+    void hash_many(const void* keys, u64 key_size, u64 key_stride, u64 count, u64* out_hashes) {
+        const u8* p = (const u8*)keys;
+
+        // Independent iterations with the hash inlined, the 4 multiplies per group overlap
+        u64 i = 0;
+        for (; i + 4 <= count; i += 4) {
+            out_hashes[i + 0] = fast_hash_inline(p + (key_stride * 0), key_size);
+            out_hashes[i + 1] = fast_hash_inline(p + (key_stride * 1), key_size);
+            out_hashes[i + 2] = fast_hash_inline(p + (key_stride * 2), key_size);
+            out_hashes[i + 3] = fast_hash_inline(p + (key_stride * 3), key_size);
+            p += key_stride * 4;
+        }
+
+        for (; i < count; i++) {
+            out_hashes[i] = fast_hash_inline(p, key_size);
+            p += key_stride;
+        }
+    }
+
+    u64 cstring_hash(const void* str, u64 str_length) {
+        return string_hash_function()((const char*)str, str_length);
     }
 
     bool cstring_equality(const void* c1, byte_t c1_size, const void* c2, byte_t c2_size) {
-        (void)c1_size;
         (void)c2_size;
 
-        u64 c1_length = String::length((const char*)c1);
-        u64 c2_length = String::length((const char*)c2);
-        
-        return String::equal((const char*)c1, c1_length, (const char*)c2, c2_length);
+        // c1_size is the length of c1, c2 is only scanned as far as c1 needs it
+        const char* s1 = (const char*)c1;
+        const char* s2 = (const char*)c2;
+        for (byte_t i = 0; i < c1_size; i++) {
+            if (s1[i] != s2[i]) {
+                return false;
+            }
+        }
+
+        return s2[c1_size] == '\0';
     }
 
     u64 string_view_hash(const void* view, u64 str_length) {
         (void)str_length;
         DS::View<char>* str_view = (DS::View<char>*)view;
-        u64 hash = 5381;
-        int c;
-
-        for (u64 i = 0; i < str_view->length; i++) {
-            c = str_view->data[i];
-            hash = ((hash << 5) + hash) + c;
-        }
 
-        return hash;
+        return string_hash_function()(str_view->data, str_view->length);
     }
 
     bool string_view_equality(const void* c1, byte_t c1_size, const void* c2, byte_t c2_size) {
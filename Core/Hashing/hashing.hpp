@@ -1,9 +1,63 @@
+#pragma once
+
 #include "../Common/common.hpp"
+#include "../DataStructure/view.hpp"
 
 namespace Hashing {
+    struct Hash128 {
+        u64 low;
+        u64 high;
+
+        bool operator==(const Hash128& rhs) const {
+            return this->low == rhs.low && this->high == rhs.high;
+        }
+
+        bool operator!=(const Hash128& rhs) const {
+            return (*this == rhs) == false;
+        }
+    };
+
+    /**
+     * @brief Streaming hash for inputs that don't fit in memory (mmap windows, chunked reads).
+     * The result only depends on the bytes and the seed, never on how update() calls split them.
+     * Not DoS resistant, it is meant for content fingerprints and cache keys.
+     */
+    struct Hasher {
+        Hasher(u64 seed = 0);
+
+        void update(const void* data, u64 data_size);
+        u64 finish() const;
+        Hash128 finish128() const;
+
+    private:
+        u64 lanes[4];
+        u8 buffer[64];
+        u64 buffer_count = 0;
+        u64 total_size = 0;
+
+        void consume_stripe(const u8* stripe);
+    };
+
+    // Keyed and DoS resistant, opt in for keys that come from untrusted input
     u64 siphash24(const void* source, u64 source_size);
+    u64 wyhash(const void* source, u64 source_size, u64 seed);
+    // Default for trivially copyable keys, not DoS resistant
+    u64 fast_hash(const void* source, u64 source_size);
+
+    // crc32c (SSE4.2 / ARMv8 crc) 16 bytes per step when the cpu has it, otherwise wyhash
+    u64 string_hash(const char* data, u64 length);
+    // str_length must be the length of str, the hashmap computes it once per lookup
     u64 cstring_hash(const void* str, u64 str_length);
+    // c1_size must be the length of c1, c2 is NUL terminated
     bool cstring_equality(const void* c1, byte_t c1_size, const void* c2, byte_t c2_size);
     u64 string_view_hash(const void* view, u64 str_length);
     bool string_view_equality(const void* c1, byte_t c1_size, const void* c2, byte_t c2_size);
+
+    // Batched forms, out_hashes[i] is identical to string_hash(keys[i]) / fast_hash(key i)
+    // but independent keys are interleaved so their dependency chains overlap.
+    void hash_many(const DS::View<char>* keys, u64 count, u64* out_hashes);
+    void hash_many(const void* keys, u64 key_size, u64 key_stride, u64 count, u64* out_hashes);
+
+    // One-shot Hasher, identical to update(data, data_size) followed by finish128()
+    Hash128 fingerprint128(const void* data, u64 data_size);
 }
\ No newline at end of file
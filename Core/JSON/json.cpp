@@ -1,110 +1,74 @@
 #include "json.hpp"
+#include "../String/builder.hpp"
 
 #include "../Lexer/lexer.hpp"
 #include "../Parser/parser.hpp"
 
 
-static const char* indent_from_depth(Memory::BaseAllocator* allocator, int depth, const char* indent) {
-    if (depth == 0) {
-        return "";
-    }
-
-    byte_t allocation_size = String::length(indent) * depth;
-    char* ret = (char*)allocator->malloc(allocation_size + 1);
-    for (int i = 0; i < allocation_size; i++) {
-        ret[i] = ' ';
-    }
-
-    return ret;
-}
-
-static const char* to_string_helper(JSON* root, const char* indent, int depth) {
+// Single pass, every value is appended straight into the one output buffer
+static void to_string_helper(JSON* root, String::Builder* builder, u64 indent_length, int depth) {
     switch (root->type) {
         case JSON_VALUE_BOOL: {
-            return String::sprintf(root->allocator, nullptr, "%s", root->boolean ? "true" : "false");
+            builder->append(root->boolean ? "true" : "false");
         } break;
 
         case JSON_VALUE_INT: {
-            return String::sprintf(root->allocator, nullptr, "%d", root->integer);
+            builder->append_int(root->integer);
         } break;
 
         case JSON_VALUE_FLOAT: {
-            return String::sprintf(root->allocator, nullptr, "%f", root->floating);
+            builder->append_float(root->floating);
         } break;
 
         case JSON_VALUE_STRING: {
-            return String::sprintf(root->allocator, nullptr, "\"%.*s\"", root->string.length, root->string.data);
+            builder->append_char('"');
+            builder->append(root->string);
+            builder->append_char('"');
         } break;
 
         case JSON_VALUE_NULL: {
-            return "null";
+            builder->append("null", sizeof("null") - 1);
         } break;
 
         case JSON_VALUE_ARRAY: {
             int array_count = root->array.elements.count();
-            DS::Vector<byte_t> buffer_sizes = DS::Vector<byte_t>(root->allocator, array_count);
-            const char** buffers = (const char**)root->allocator->malloc(sizeof(char*) * array_count);
 
-            byte_t total_allocation_size = 1; // 1 for the null terminator
-            const char* member_indent = indent_from_depth(root->allocator, depth + 1, indent);
+            builder->append("[\n", 2);
             for (int i = 0; i < array_count; i++) {
-                byte_t temp_size = 0;
-                JSON* element = root->array.elements[i];
-                const char* value = to_string_helper(element, indent, depth + 1);
-                if (i == array_count - 1) {
-                    buffers[i] = String::sprintf(root->allocator, &temp_size, "%s%s", member_indent, value);
-                } else {
-                    buffers[i] = String::sprintf(root->allocator, &temp_size, "%s%s,\n", member_indent, value);
+                builder->indent(indent_length * (depth + 1));
+                to_string_helper(root->array.elements[i], builder, indent_length, depth + 1);
+                if (i != array_count - 1) {
+                    builder->append(",\n", 2);
                 }
-
-                buffer_sizes.push(temp_size);
-                total_allocation_size += temp_size;
-            }
-            
-            byte_t string_length = 0;
-            char* buffer = (char*)root->allocator->malloc(total_allocation_size);
-            for (int i = 0; i < array_count; i++) {
-                String::append(buffer, string_length, total_allocation_size, buffers[i], buffer_sizes[i]);
-                string_length += buffer_sizes[i];
             }
 
-            return String::sprintf(root->allocator, nullptr, "[\n%s\n%s]", buffer, indent_from_depth(root->allocator, depth, indent));
+            builder->append_char('\n');
+            builder->indent(indent_length * depth);
+            builder->append_char(']');
         } break;
 
         case JSON_VALUE_OBJECT: {
             int object_member_count = root->object.pairs.count();
-            DS::Vector<byte_t> buffer_sizes = DS::Vector<byte_t>( root->allocator, object_member_count);
-            const char** buffers = (const char**)root->allocator->malloc(sizeof(char*) * object_member_count);
 
-            byte_t total_allocation_size = 1; // 1 for the null terminator
-            const char* member_indent = indent_from_depth(root->allocator, depth + 1, indent);
+            builder->append("{\n", 2);
             for (int i = 0; i < object_member_count; i++) {
                 KeyJsonPair pair = root->object.pairs[i];
-                byte_t temp_size = 0;
 
-                const char* value = to_string_helper(pair.value, indent, depth + 1);
-                if (i == object_member_count - 1) {
-                    buffers[i] = String::sprintf(root->allocator, &temp_size, "%s\"%s\": %s", member_indent, pair.key, value);
-                } else {
-                    buffers[i] = String::sprintf(root->allocator, &temp_size, "%s\"%s\": %s,\n", member_indent, pair.key, value);
+                builder->indent(indent_length * (depth + 1));
+                builder->append_char('"');
+                builder->append(pair.key);
+                builder->append("\": ", 3);
+                to_string_helper(pair.value, builder, indent_length, depth + 1);
+                if (i != object_member_count - 1) {
+                    builder->append(",\n", 2);
                 }
-
-                buffer_sizes.push(temp_size);
-                total_allocation_size += temp_size;
-            }
-            
-            byte_t string_length = 0;
-            char* buffer = (char*)root->allocator->malloc(total_allocation_size);
-            for (int i = 0; i < object_member_count; i++) {
-                String::append(buffer, string_length, total_allocation_size, buffers[i], buffer_sizes[i]);
-                string_length += buffer_sizes[i];
             }
 
-            return String::sprintf(root->allocator, nullptr, "{\n%s\n%s}", buffer, indent_from_depth(root->allocator, depth, indent));
+            builder->append_char('\n');
+            builder->indent(indent_length * depth);
+            builder->append_char('}');
         } break;
     }
-
-    return nullptr;
 }
 
 const char* JSON::to_string(JSON* root, const char* indent) {
@@ -112,7 +76,10 @@ const char* JSON::to_string(JSON* root, const char* indent) {
         return "JSON* root = null";
     }
 
-    return to_string_helper(root, indent, 0);
+    String::Builder builder = String::Builder(root->allocator);
+    to_string_helper(root, &builder, String::length(indent), 0);
+
+    return builder.release();
 }
 
 
@@ -202,14 +169,10 @@ static JSON* parse_helper(JSON* root, Parser* parser) {
 }
 
 JSON* JSON::parse(Memory::BaseAllocator* allocator, const char* json_string, u64 json_string_length) {
-    DS::Vector<Token> tokens = DS::Vector<Token>(allocator, 40);
-    Lexer::generate_tokens((u8*)json_string, json_string_length, tokens);
-    for (const Token& token : tokens) {
-        const char* token_type_string = token.type_to_string();
-        LOG_DEBUG("%s(%.*s)\n", token_type_string, token.sv.length, token.sv.data);
-    }
+    TokenStream tokens = TokenStream((u8*)json_string, json_string_length);
+    tokens.log_tokens = true;
 
-    if (tokens[0].type != TS_LEFT_CURLY) {
+    if (tokens.peek_nth_token().type != TS_LEFT_CURLY) {
         return nullptr;
     }
 
@@ -103,6 +103,8 @@ struct JSON {
     }
 
     static const char* to_string(JSON* root, const char* indent = "    ");
+    // Lexes json_string in place, a Platform::map_file mapping works as is.
+    // String values are views into it (keys are copied), so it has to outlive the result.
     static JSON* parse(Memory::BaseAllocator* allocator, const char* json_string, u64 json_string_length);
 
     static JSON* Integer(Memory::BaseAllocator* allocator, int value);
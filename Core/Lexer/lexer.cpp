@@ -1,54 +1,672 @@
 #include "lexer.hpp"
+#include "../Platform/platform.hpp"
+
+#include <string.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define LEXER_SIMD_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define LEXER_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+// Class of the first byte of a token, consume_next_token dispatches on it with a single switch
+enum LexerCharClass : u8 {
+    LCC_ILLEGAL,
+    LCC_WHITESPACE,
+    LCC_DIGIT,
+    LCC_ALPHA,
+    LCC_SIGN, // '+' and '-' start a number literal when a digit follows
+    LCC_DOUBLE_QUOTE,
+    LCC_SINGLE_QUOTE,
+    LCC_SLASH, // comment or division
+    LCC_SYNTAX
+};
+
+// What a byte can continue, used by the inner loops of each token kind
+#define LEXER_FLAG_WHITESPACE (1 << 0) // ' ' '\t' '\n' '\r' '\0'
+#define LEXER_FLAG_IDENTIFIER (1 << 1) // [A-Za-z0-9_]
+#define LEXER_FLAG_NUMBER     (1 << 2) // [0-9.]
+
+#define X(name, str) + 1
+    internal constexpr u32 LEXER_SYNTAX_ENTRY_CAPACITY = 0 X_SYNTAX_TOKENS;
+#undef X
+
+struct LexerSyntaxEntry {
+    const char* lexeme;
+    u32 length;
+    TokenType type;
+};
 
-static bool is_whitespace(char c) {
-    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\0';
+struct LexerTables {
+    u8 char_class[256];
+    u8 char_flags[256];
+
+    // grouped by first byte, longest first, so the first entry that matches is the maximal munch
+    LexerSyntaxEntry syntax[LEXER_SYNTAX_ENTRY_CAPACITY];
+    u8 syntax_first[256];
+    u8 syntax_count[256];
+};
+
+internal constexpr bool lexeme_equal(const char* a, u32 a_length, const char* b, u32 b_length) {
+    if (a_length != b_length) {
+        return false;
+    }
+
+    for (u32 i = 0; i < a_length; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
-#define char_is_digit(c) (c >= '0' && c <= '9')
-#define char_is_upper(c) (c >= 'A' && c <= 'Z')
-#define char_is_lower(c) (c >= 'a' && c <= 'z')
+internal constexpr LexerTables make_lexer_tables() {
+    LexerTables ret = {};
+
+    for (int c = 0; c < 256; c++) {
+        bool is_digit = c >= '0' && c <= '9';
+        bool is_alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool is_whitespace = c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\0';
+
+        ret.char_flags[c] = (u8)(
+            (is_whitespace ? LEXER_FLAG_WHITESPACE : 0) |
+            ((is_alpha || is_digit || c == '_') ? LEXER_FLAG_IDENTIFIER : 0) |
+            ((is_digit || c == '.') ? LEXER_FLAG_NUMBER : 0)
+        );
 
-UNUSED_FUNCTION static bool char_is_alpha(char c) {
-    c = (char)((int)c & (0b11011111)); // mask off the 32 bit
-    return char_is_upper(c);
+        ret.char_class[c] = is_whitespace ? LCC_WHITESPACE : is_digit ? LCC_DIGIT : is_alpha ? LCC_ALPHA : LCC_ILLEGAL;
+    }
+
+    // later duplicates win, "==" is listed twice and has always lexed as the last entry
+    const LexerSyntaxEntry entries[] = {
+        #define X(name, str) { str, sizeof(str) - 1, name },
+            X_SYNTAX_TOKENS
+        #undef X
+    };
+
+    u32 count = 0;
+    for (const LexerSyntaxEntry& entry : entries) {
+        bool replaced = false;
+        for (u32 i = 0; i < count; i++) {
+            if (lexeme_equal(ret.syntax[i].lexeme, ret.syntax[i].length, entry.lexeme, entry.length)) {
+                ret.syntax[i].type = entry.type;
+                replaced = true;
+            }
+        }
+
+        if (!replaced) {
+            ret.syntax[count++] = entry;
+        }
+    }
+
+    for (u32 i = 1; i < count; i++) {
+        LexerSyntaxEntry entry = ret.syntax[i];
+        u32 j = i;
+        while (j > 0) {
+            LexerSyntaxEntry previous = ret.syntax[j - 1];
+            bool goes_after = (u8)previous.lexeme[0] < (u8)entry.lexeme[0] || ((u8)previous.lexeme[0] == (u8)entry.lexeme[0] && previous.length >= entry.length);
+            if (goes_after) {
+                break;
+            }
+
+            ret.syntax[j] = previous;
+            j -= 1;
+        }
+
+        ret.syntax[j] = entry;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        u8 first = (u8)ret.syntax[i].lexeme[0];
+        if (ret.syntax_count[first] == 0) {
+            ret.syntax_first[first] = (u8)i;
+        }
+
+        ret.syntax_count[first] += 1;
+        ret.char_class[first] = LCC_SYNTAX;
+    }
+
+    ret.char_class['+'] = LCC_SIGN;
+    ret.char_class['-'] = LCC_SIGN;
+    ret.char_class['/'] = LCC_SLASH;
+    ret.char_class['"'] = LCC_DOUBLE_QUOTE;
+    ret.char_class['\''] = LCC_SINGLE_QUOTE;
+
+    return ret;
 }
 
-UNUSED_FUNCTION static bool char_is_alpha_numeric(char c) {
-    return char_is_alpha(c) || char_is_digit(c);
+internal constexpr LexerTables LEXER_TABLES = make_lexer_tables();
+
+// Runs the inner loops skip 16 bytes at a time, the scalar loops after them only finish the tail
+enum LexerScan {
+    LEXER_SCAN_WHITESPACE,
+    LEXER_SCAN_IDENTIFIER,
+    LEXER_SCAN_STRING,       // stops at '"'
+    LEXER_SCAN_BLOCK_COMMENT // stops at the '*' of "*/"
+};
+
+#if defined(LEXER_SIMD_SSE2) || defined(LEXER_SIMD_NEON)
+    #if defined(LEXER_SIMD_SSE2)
+        typedef __m128i LexerBlock;
+        #define LEXER_MASK_BITS_PER_BYTE 1
+        #define LEXER_MASK_FULL 0xFFFFULL
+
+        internal inline LexerBlock lexer_load(const char* data) { return _mm_loadu_si128((const __m128i*)data); }
+        internal inline LexerBlock lexer_eq(LexerBlock block, char c) { return _mm_cmpeq_epi8(block, _mm_set1_epi8(c)); }
+        internal inline LexerBlock lexer_or(LexerBlock a, LexerBlock b) { return _mm_or_si128(a, b); }
+        internal inline LexerBlock lexer_and(LexerBlock a, LexerBlock b) { return _mm_and_si128(a, b); }
+        internal inline LexerBlock lexer_to_lower(LexerBlock block) { return _mm_or_si128(block, _mm_set1_epi8(0x20)); }
+
+        // signed compare, bytes >= 0x80 are negative so they never land in an ASCII range
+        internal inline LexerBlock lexer_in_range(LexerBlock block, char low, char high) {
+            return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(low - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(high + 1), block));
+        }
+
+        internal inline u64 lexer_mask(LexerBlock block) { return (u64)(u32)_mm_movemask_epi8(block); }
+    #else
+        typedef uint8x16_t LexerBlock;
+        #define LEXER_MASK_BITS_PER_BYTE 4
+        #define LEXER_MASK_FULL 0xFFFFFFFFFFFFFFFFULL
+
+        internal inline LexerBlock lexer_load(const char* data) { return vld1q_u8((const u8*)data); }
+        internal inline LexerBlock lexer_eq(LexerBlock block, char c) { return vceqq_u8(block, vdupq_n_u8((u8)c)); }
+        internal inline LexerBlock lexer_or(LexerBlock a, LexerBlock b) { return vorrq_u8(a, b); }
+        internal inline LexerBlock lexer_and(LexerBlock a, LexerBlock b) { return vandq_u8(a, b); }
+        internal inline LexerBlock lexer_to_lower(LexerBlock block) { return vorrq_u8(block, vdupq_n_u8(0x20)); }
+
+        internal inline LexerBlock lexer_in_range(LexerBlock block, char low, char high) {
+            return vandq_u8(vcgeq_u8(block, vdupq_n_u8((u8)low)), vcleq_u8(block, vdupq_n_u8((u8)high)));
+        }
+
+        // 4 bits per byte
+        internal inline u64 lexer_mask(LexerBlock block) {
+            return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(block), 4)), 0);
+        }
+    #endif
+
+    internal inline u32 lexer_count_trailing_zeros(u64 value) {
+        #if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return (u32)index;
+        #else
+            return (u32)__builtin_ctzll(value);
+        #endif
+    }
+
+    internal inline u32 lexer_popcount(u64 value) {
+        #if defined(_MSC_VER)
+            return (u32)__popcnt64(value);
+        #else
+            return (u32)__builtin_popcountll(value);
+        #endif
+    }
+
+    // One bit (or nibble) per byte that ends the run
+    internal inline u64 lexer_stop_mask(LexerScan scan, const char* data, LexerBlock block) {
+        switch (scan) {
+            case LEXER_SCAN_WHITESPACE: {
+                LexerBlock whitespace = lexer_or(lexer_or(lexer_eq(block, ' '), lexer_eq(block, '\t')), lexer_or(lexer_eq(block, '\n'), lexer_eq(block, '\r')));
+                return lexer_mask(lexer_or(whitespace, lexer_eq(block, '\0'))) ^ LEXER_MASK_FULL;
+            } break;
+
+            case LEXER_SCAN_IDENTIFIER: {
+                LexerBlock alpha = lexer_in_range(lexer_to_lower(block), 'a', 'z');
+                LexerBlock identifier = lexer_or(lexer_or(alpha, lexer_in_range(block, '0', '9')), lexer_eq(block, '_'));
+                return lexer_mask(identifier) ^ LEXER_MASK_FULL;
+            } break;
+
+            case LEXER_SCAN_STRING: {
+                return lexer_mask(lexer_eq(block, '\"'));
+            } break;
+
+            case LEXER_SCAN_BLOCK_COMMENT: {
+                return lexer_mask(lexer_and(lexer_eq(block, '*'), lexer_eq(lexer_load(data + 1), '/')));
+            } break;
+        }
+
+        return 0;
+    }
+#endif
+
+internal inline bool lexer_is_stop(LexerScan scan, const char* data, u32 position, u32 length) {
+    switch (scan) {
+        case LEXER_SCAN_WHITESPACE: {
+            return (LEXER_TABLES.char_flags[(u8)data[position]] & LEXER_FLAG_WHITESPACE) == 0;
+        } break;
+
+        case LEXER_SCAN_IDENTIFIER: {
+            return (LEXER_TABLES.char_flags[(u8)data[position]] & LEXER_FLAG_IDENTIFIER) == 0;
+        } break;
+
+        case LEXER_SCAN_STRING: {
+            return data[position] == '\"';
+        } break;
+
+        case LEXER_SCAN_BLOCK_COMMENT: {
+            return data[position] == '*' && position + 1 < length && data[position + 1] == '/';
+        } break;
+    }
+
+    return true;
 }
 
-Lexer::Lexer(DS::View<char> source, DS::Vector<Token>& tokens) : source(source), tokens(tokens) {
+// Returns the offset of the first byte that ends the run or length, and adds the '\n' it passed to out_line unless it's nullptr.
+// Most runs are a few bytes, so the first LEXER_SCAN_PROBE bytes are checked one at a time before going wide.
+#define LEXER_SCAN_PROBE 8
+
+internal inline u32 lexer_scan(LexerScan scan, const char* data, u32 position, u32 length, u32* out_line) {
+    u32 probe_end = position + LEXER_SCAN_PROBE < length ? position + LEXER_SCAN_PROBE : length;
+    for (; position < probe_end; position++) {
+        if (lexer_is_stop(scan, data, position, length)) {
+            return position;
+        }
+
+        if (out_line) {
+            *out_line += data[position] == '\n';
+        }
+    }
+
+    #if defined(LEXER_SIMD_SSE2) || defined(LEXER_SIMD_NEON)
+        // the block comment mask also reads the byte after the block
+        u32 over_read = scan == LEXER_SCAN_BLOCK_COMMENT ? 1 : 0;
+
+        while ((u64)position + 16 + over_read <= length) {
+            LexerBlock block = lexer_load(data + position);
+            u64 stop = lexer_stop_mask(scan, data + position, block);
+            u64 newlines = (scan == LEXER_SCAN_IDENTIFIER || !out_line) ? 0 : lexer_mask(lexer_eq(block, '\n'));
+
+            if (stop) {
+                u32 bit = lexer_count_trailing_zeros(stop);
+                if (newlines) {
+                    *out_line += lexer_popcount(newlines & ((1ULL << bit) - 1)) / LEXER_MASK_BITS_PER_BYTE;
+                }
+
+                return position + (bit / LEXER_MASK_BITS_PER_BYTE);
+            }
+
+            if (newlines) {
+                *out_line += lexer_popcount(newlines) / LEXER_MASK_BITS_PER_BYTE;
+            }
+
+            position += 16;
+        }
+    #endif
+
+    for (; position < length; position++) {
+        if (lexer_is_stop(scan, data, position, length)) {
+            return position;
+        }
+
+        if (out_line) {
+            *out_line += data[position] == '\n';
+        }
+    }
+
+    return length;
+}
+
+Lexer::Lexer(DS::View<char> source) : source(source) {
     this->left_pos = 0;
     this->right_pos = 0;
     this->line = 1;
     this->c = '\0';
+    this->out_token = nullptr;
+    this->has_token = false;
+    this->track_lines = true;
+    this->speculative = false;
+    this->failed = false;
 };
 
 void Lexer::generate_tokens(u8* data, byte_t file_size, DS::Vector<Token>& out_tokens) {
-    Lexer lexer = Lexer(DS::View<char>((char*)data, file_size), out_tokens);
-    while (!lexer.is_eof()) {
+    // validate once up front so the token loop never has to care about encoding
+    u64 error_offset = 0;
+    RUNTIME_ASSERT_MSG(String::utf8_validate((char*)data, file_size, &error_offset), "Invalid UTF-8 at byte offset %llu\n", (unsigned long long)error_offset);
+
+    Lexer lexer = Lexer(DS::View<char>((char*)data, file_size));
+    Token token = Token();
+    while (lexer.next_token(&token)) {
+        out_tokens.push(token);
+    }
+}
+
+struct LexerChunk {
+    DS::View<char> source;
+    u32 start; // just after a '\n', or 0
+    u32 end;
+    u32 stop;     // where the speculative lexer stopped, >= end unless it failed
+    u32 newlines; // '\n' in [start, end)
+    bool failed;
+
+    bool utf8_valid;
+    u64 utf8_error_offset;
+
+    DS::Vector<Token> tokens; // lines count from 1 at start
+};
+
+internal u32 count_newlines(const char* data, u64 length) {
+    u32 ret = 0;
+    const char* end = data + length;
+    while (data < end) {
+        const char* newline = (const char*)memchr(data, '\n', (u64)(end - data));
+        if (!newline) {
+            break;
+        }
+
+        ret += 1;
+        data = newline + 1;
+    }
+
+    return ret;
+}
+
+void Lexer::lex_chunk(void* user_data) {
+    LexerChunk* chunk = (LexerChunk*)user_data;
+    chunk->newlines = count_newlines(chunk->source.data + chunk->start, chunk->end - chunk->start);
+
+    u64 error_offset = 0;
+    chunk->utf8_valid = String::utf8_validate(chunk->source.data + chunk->start, chunk->end - chunk->start, &error_offset);
+    chunk->utf8_error_offset = chunk->start + error_offset;
+    if (!chunk->utf8_valid) {
+        chunk->failed = true;
+
+        return;
+    }
+
+    Lexer lexer = Lexer(chunk->source);
+    lexer.speculative = true;
+    lexer.right_pos = chunk->start;
+
+    Token token = Token();
+    lexer.out_token = &token;
+    while (!lexer.is_eof() && lexer.right_pos < chunk->end) {
+        lexer.has_token = false;
         lexer.consume_next_token();
+
+        if (lexer.has_token) {
+            chunk->tokens.push(token);
+        }
     }
+
+    chunk->stop = lexer.right_pos;
+    chunk->failed = lexer.failed;
 }
 
-void Lexer::consume_next_char() {
-    this->c = this->source.data[this->right_pos];
+internal void push_stitched_token(DS::Vector<Token>& out_tokens, Token token, u32 line_offset) {
+    token.line += line_offset;
+    if (token.type == TOKEN_IDENTIFIER) {
+        token.symbol = String::global_interner()->intern(token.sv);
+    }
 
-    if (this->c == '\n') {
-        this->line += 1;
+    out_tokens.push(token);
+}
+
+internal bool same_token(const Token& a, const Token& b) {
+    return a.type == b.type && a.sv.data == b.sv.data && a.sv.length == b.sv.length;
+}
+
+void Lexer::generate_tokens_parallel(u8* data, byte_t file_size, DS::Vector<Token>& out_tokens, u32 thread_count) {
+    if (thread_count == 0) {
+        thread_count = Platform::get_processor_count();
     }
 
-    this->right_pos += 1;
+    u64 chunk_count = MIN((u64)thread_count, (u64)LEXER_PARALLEL_MAX_CHUNKS);
+    chunk_count = MIN(chunk_count, (u64)file_size / LEXER_PARALLEL_MIN_CHUNK_SIZE);
+    if (chunk_count <= 1) {
+        Lexer::generate_tokens(data, file_size, out_tokens);
+
+        return;
+    }
+
+    DS::View<char> source = DS::View<char>((char*)data, file_size);
+    LexerChunk chunks[LEXER_PARALLEL_MAX_CHUNKS];
+    u64 count = 0;
+    u32 start = 0;
+    for (u64 i = 1; i <= chunk_count && start < file_size; i++) {
+        u32 end = (u32)file_size;
+        if (i < chunk_count) {
+            u64 target = MAX((u64)file_size * i / chunk_count, (u64)start);
+            const char* newline = (const char*)memchr(source.data + target, '\n', file_size - target);
+            end = newline ? (u32)(newline - source.data) + 1 : (u32)file_size;
+        }
+
+        LexerChunk& chunk = chunks[count++];
+        chunk.source = source;
+        chunk.start = start;
+        chunk.end = end;
+        chunk.stop = end;
+        chunk.newlines = 0;
+        chunk.failed = false;
+        chunk.utf8_valid = true;
+        chunk.utf8_error_offset = 0;
+        chunk.tokens = DS::Vector<Token>(&Memory::global_general_allocator, MAX((u64)(end - start) / 16, (u64)16));
+
+        start = end;
+    }
+
+    // the calling thread takes the first chunk, a chunk whose thread can't be started runs here too
+    Platform::Thread threads[LEXER_PARALLEL_MAX_CHUNKS] = {0};
+    for (u64 i = 1; i < count; i++) {
+        Error error = ERROR_SUCCESS;
+        threads[i] = Platform::create_thread(Lexer::lex_chunk, &chunks[i], error);
+    }
+
+    Lexer::lex_chunk(&chunks[0]);
+    for (u64 i = 1; i < count; i++) {
+        if (threads[i]) {
+            Platform::join_thread(threads[i]);
+        } else {
+            Lexer::lex_chunk(&chunks[i]);
+        }
+    }
+
+    for (u64 i = 0; i < count; i++) {
+        RUNTIME_ASSERT_MSG(chunks[i].utf8_valid, "Invalid UTF-8 at byte offset %llu\n", (unsigned long long)chunks[i].utf8_error_offset);
+    }
+
+    // stitch: position is where the sequential lexer would start its next token
+    u32 position = 0;
+    u32 newlines_before = 0; // prefix sum of '\n' before chunks[i].start
+    for (u64 i = 0; i < count; newlines_before += chunks[i].newlines, i++) {
+        LexerChunk& chunk = chunks[i];
+        if (position >= chunk.end) {
+            continue; // swallowed by a token or comment that started in an earlier chunk
+        }
+
+        if (position == chunk.start && !chunk.failed) {
+            for (u64 k = 0; k < chunk.tokens.count(); k++) {
+                push_stitched_token(out_tokens, chunk.tokens[k], newlines_before);
+            }
+
+            position = chunk.stop;
+            continue;
+        }
+
+        // the speculation was wrong, lex for real until a token lines up with a speculative one
+        Lexer fixer = Lexer(source);
+        fixer.right_pos = position;
+        fixer.line = 1 + newlines_before + count_newlines(source.data + chunk.start, position - chunk.start);
+
+        Token token = Token();
+        fixer.out_token = &token;
+        u64 cursor = 0;
+        bool resynced = false;
+        while (!fixer.is_eof() && fixer.right_pos < chunk.end) {
+            fixer.has_token = false;
+            fixer.consume_next_token();
+            if (!fixer.has_token) {
+                continue;
+            }
+
+            if (!chunk.failed) {
+                while (cursor < chunk.tokens.count() && chunk.tokens[cursor].sv.data < token.sv.data) {
+                    cursor += 1;
+                }
+
+                if (cursor < chunk.tokens.count() && same_token(chunk.tokens[cursor], token)) {
+                    resynced = true;
+                    break;
+                }
+            }
+
+            out_tokens.push(token);
+        }
+
+        if (resynced) {
+            for (u64 k = cursor; k < chunk.tokens.count(); k++) {
+                push_stitched_token(out_tokens, chunk.tokens[k], newlines_before);
+            }
+
+            position = chunk.stop;
+        } else {
+            position = fixer.right_pos;
+        }
+    }
 }
 
-bool Lexer::consume_whitespace() {
-    if (is_whitespace(this->c)) {
-        return true;
+void Lexer::generate_compact_tokens(u8* data, byte_t file_size, DS::Vector<CompactToken>& out_tokens, DS::Vector<TokenValue>& out_literals) {
+    u64 error_offset = 0;
+    RUNTIME_ASSERT_MSG(String::utf8_validate((char*)data, file_size, &error_offset), "Invalid UTF-8 at byte offset %llu\n", (unsigned long long)error_offset);
+
+    Lexer lexer = Lexer(DS::View<char>((char*)data, file_size));
+    lexer.track_lines = false;
+
+    Token token = Token();
+    while (lexer.next_token(&token)) {
+        out_tokens.push(token.compact(lexer.source, out_literals));
+    }
+}
+
+// Where the lexer was when it started the token, strings drop their quotes from the view
+internal u32 token_start(TokenType type, u32 offset) {
+    return type == TL_STRING ? offset - 1 : offset;
+}
+
+LexerSplice Lexer::relex(DS::Vector<CompactToken>& tokens, DS::Vector<TokenValue>& literals, LexerEdit edit, DS::View<char> new_source) {
+    s64 delta = (s64)edit.inserted_length - (s64)edit.removed_length;
+    u32 inserted_end = edit.offset + edit.inserted_length;
+    RUNTIME_ASSERT_MSG(inserted_end <= new_source.length, "Edit ends at %u but the new source is %llu bytes\n", inserted_end, (unsigned long long)new_source.length);
+
+    // the last token that starts before the edit, it can grow into the edit ("a" + "b" -> "ab", "=" + "=" -> "==")
+    u64 count = tokens.count();
+    CompactToken* old_tokens = tokens.data();
+    u64 low = 0;
+    u64 high = count;
+    while (low < high) {
+        u64 middle = low + ((high - low) / 2);
+        if (token_start((TokenType)old_tokens[middle].type, old_tokens[middle].offset) < edit.offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    // with no token before the edit it may sit in a leading comment, so start over from the top
+    u64 first = low > 0 ? low - 1 : 0;
+    u32 restart = low > 0 ? token_start((TokenType)old_tokens[first].type, old_tokens[first].offset) : 0;
+
+    // validate the new bytes, ending on an ASCII byte so a sequence isn't cut in half
+    u64 validate_end = MIN((u64)inserted_end + 4, new_source.length);
+    while (validate_end < new_source.length && ((u8)new_source.data[validate_end] & 0x80)) {
+        validate_end += 1;
+    }
+
+    u64 error_offset = 0;
+    RUNTIME_ASSERT_MSG(String::utf8_validate(new_source.data + restart, validate_end - restart, &error_offset), "Invalid UTF-8 at byte offset %llu\n", (unsigned long long)(restart + error_offset));
+
+    Lexer lexer = Lexer(new_source);
+    lexer.track_lines = false;
+    lexer.right_pos = restart;
+
+    DS::Vector<CompactToken> fresh = DS::Vector<CompactToken>(&Memory::global_general_allocator, 16);
+    u64 cursor = first;
+    u64 resync = count;
+    Token token = Token();
+    while (lexer.next_token(&token)) {
+        u32 start = token_start(token.type, (u32)(token.sv.data - new_source.data));
+
+        // past the edit the text is the old text shifted by delta, the same start means the same tokens from here on
+        if (start >= inserted_end) {
+            u32 old_start = (u32)((s64)start - delta);
+            while (cursor < count && token_start((TokenType)old_tokens[cursor].type, old_tokens[cursor].offset) < old_start) {
+                cursor += 1;
+            }
+
+            if (cursor < count && token_start((TokenType)old_tokens[cursor].type, old_tokens[cursor].offset) == old_start) {
+                resync = cursor;
+                break;
+            }
+        }
+
+        fresh.push(token.compact(new_source, literals));
+    }
+
+    LexerSplice ret = {};
+    ret.first_token = first;
+    ret.removed_count = resync - first;
+    ret.inserted_count = fresh.count();
+
+    // slide the reused tail into place, then drop the fresh tokens in front of it
+    u64 tail_count = count - resync;
+    u64 new_count = count - ret.removed_count + ret.inserted_count;
+    if (new_count > count) {
+        tokens.resize(new_count);
+    }
+
+    CompactToken* data = tokens.data();
+    Memory::copy(data + first + ret.inserted_count, tail_count * sizeof(CompactToken), data + resync, tail_count * sizeof(CompactToken));
+    if (new_count < count) {
+        tokens.resize(new_count);
+    }
+
+    for (u64 i = first + ret.inserted_count; i < new_count; i++) {
+        data[i].offset = (u32)((s64)data[i].offset + delta);
+    }
+
+    if (ret.inserted_count) {
+        Memory::copy(data + first, ret.inserted_count * sizeof(CompactToken), fresh.data(), ret.inserted_count * sizeof(CompactToken));
+    }
+
+    return ret;
+}
+
+bool Lexer::next_token(Token* out_token) {
+    this->out_token = out_token;
+    this->has_token = false;
+
+    while (!this->is_eof()) {
+        this->consume_next_token();
+
+        if (this->has_token) {
+            return true;
+        }
     }
 
     return false;
 }
 
+void Lexer::emit(Token token) {
+    *this->out_token = token;
+    this->has_token = true;
+}
+
+void Lexer::consume_next_char() {
+    this->c = this->source.data[this->right_pos];
+
+    if (this->c == '\n') {
+        this->line += 1;
+    }
+
+    this->right_pos += 1;
+}
+
 char Lexer::peek_nth_char(u64 n) {
     if ((this->right_pos + n) >= this->source.length) {
         return '\0';
@@ -62,6 +680,14 @@ DS::View<char> Lexer::get_scratch_buffer() {
 }
 
 void Lexer::report_error(const char* msg) {
+    if (this->speculative) {
+        // the chunk may have started inside a string or comment, the stitch pass decides if this error is real
+        this->failed = true;
+        this->right_pos = this->source.length;
+
+        return;
+    }
+
     DS::View<char> scratch = this->get_scratch_buffer();
     LOG_ERROR("String: %.*s\n", (int)scratch.length, scratch.data); 
 
@@ -78,61 +704,74 @@ void Lexer::report_error(const char* msg) {
     RUNTIME_ASSERT_MSG(false, "[LEXER ERROR] line: %d | %s", this->line, msg);
 }
 
-bool Lexer::consume_on_match(char expected) {
-    if (this->peek_nth_char() != expected) {
-        return false;
-    }
-
-    this->consume_next_char();
-    return true;
+void Lexer::consume_whitespace() {
+    this->right_pos = lexer_scan(LEXER_SCAN_WHITESPACE, this->source.data, this->right_pos, this->source.length, this->track_lines ? &this->line : nullptr);
 }
 
 void Lexer::consume_digit_literal() {
-    if (this->consume_on_match('-')) {}
-    else if (this->consume_on_match('+')) {}
-    
-    while (char_is_digit(peek_nth_char()) || peek_nth_char() == '.') {
-        this->consume_next_char();
+    // one sign may directly follow the first character, kept for compatibility ("5-3" is one malformed literal)
+    char next = this->peek_nth_char();
+    if (next == '-' || next == '+') {
+        this->right_pos += 1;
+    }
+
+    const char* data = this->source.data;
+    u32 position = this->right_pos;
+    while (position < this->source.length && (LEXER_TABLES.char_flags[(u8)data[position]] & LEXER_FLAG_NUMBER)) {
+        position += 1;
     }
+    this->right_pos = position;
 
     DS::View<char> sv = this->get_scratch_buffer();
+    if (this->speculative) {
+        // LiteralTokenFromSourceView asserts on overflow, a chunk that started inside a string can hit that spuriously
+        s64 integer = 0;
+        float floating = 0.0f;
+        if (String::parse_number(sv, &integer, &floating) == String::NUMBER_INTEGER_OVERFLOW) {
+            this->report_error("Integer literal doesn't fit in 64 bits\n");
+            return;
+        }
+    }
+
     Token token = Token::LiteralTokenFromSourceView(sv, this->line);
-    this->tokens.push(token);
+    this->emit(token);
 }
 
 void Lexer::consume_string_literal() {
-    while (this->peek_nth_char() != '\"') {
-        if (this->is_eof()) {
-            this->report_error("String literal doesn't have a closing double quote!\n");
-        }
-        
-        this->consume_next_char();
+    u32 position = lexer_scan(LEXER_SCAN_STRING, this->source.data, this->right_pos, this->source.length, this->track_lines ? &this->line : nullptr);
+    if (position >= this->source.length) {
+        this->right_pos = position;
+        this->report_error("String literal doesn't have a closing double quote!\n");
+        return;
     }
 
-    this->consume_next_char();
+    this->right_pos = position + 1;
 
     DS::View<char> sv = this->get_scratch_buffer();
     sv.data += 1;
     sv.length -= 2;
-    
+
     Token token = Token();
     token.type = TL_STRING;
     token.line = this->line;
     token.sv = sv;
 
-    this->tokens.push(token);
+    this->emit(token);
 }
 
 void Lexer::consume_character_literal() {
-    if (this->consume_on_match('\'')) {
+    if (this->peek_nth_char() == '\'') {
+        this->consume_next_char();
         this->report_error("character literal doesn't have any ascii data in between\n");
+        return;
     }
 
     while (this->peek_nth_char() != '\'') {
         if (this->is_eof()) {
-            this->report_error("String literal doesn't have a closing double quote!\n");
+            this->report_error("Character literal doesn't have a closing single quote!\n");
+            return;
         }
-        
+
         this->consume_next_char();
     }
 
@@ -140,145 +779,110 @@ void Lexer::consume_character_literal() {
 
     DS::View<char> sv = this->get_scratch_buffer();
     Token token = Token::LiteralTokenFromSourceView(sv, this->line);
-    this->tokens.push(token);
+    this->emit(token);
 }
 
-bool Lexer::consume_literal() {
-    bool has_unary = (this->c == '-' || this->c == '+' );
-    if (char_is_digit(this->c) || (has_unary && char_is_digit(peek_nth_char()))) {
-        this->consume_digit_literal();
-        return true;
-    } else if (this->c == '\"') {
-        this->consume_string_literal();
-        return true;
-    } else if (this->c == '\'') {
-        this->consume_character_literal();
-        return true;
-    }
+void Lexer::consume_word() {
+    this->right_pos = lexer_scan(LEXER_SCAN_IDENTIFIER, this->source.data, this->right_pos, this->source.length, this->track_lines ? &this->line : nullptr);
 
-    return false;
+    this->emit(Token::WordTokenFromSourceView(this->get_scratch_buffer(), this->line, !this->speculative));
 }
 
-bool Lexer::try_consume_word() {
-    if (!char_is_alpha(this->c)) {
-        return false;
-    }
-
-    while (char_is_alpha_numeric(peek_nth_char()) || peek_nth_char() == '_') {
-        if (this->is_eof()) {
-            break;
-        }
-
-        this->consume_next_char();
-    }
+// Stops in front of the '\n' so the whitespace path counts it, memchr is already vectorized
+void Lexer::consume_line_comment() {
+    u32 remaining = this->source.length - this->right_pos;
+    const char* newline = remaining ? (const char*)memchr(this->source.data + this->right_pos, '\n', remaining) : nullptr;
 
-    return true;
+    this->right_pos = newline ? (u32)(newline - this->source.data) : this->source.length;
 }
 
-bool Lexer::consume_word() {
-    if (!this->try_consume_word()) {
-        return false;
+void Lexer::consume_block_comment() {
+    u32 position = lexer_scan(LEXER_SCAN_BLOCK_COMMENT, this->source.data, this->right_pos, this->source.length, this->track_lines ? &this->line : nullptr);
+    if (position >= this->source.length) {
+        this->right_pos = position;
+        this->report_error("Multiline comment doesn't terminate\n");
+        return;
     }
 
-    DS::View<char> sv = this->get_scratch_buffer();
-
-    Token token = Token::PrimiveTypeTokenFromSourceView(sv, this->line);
-    if (token.type != TOKEN_ILLEGAL_TOKEN) {
-        this->tokens.push(token);
-        
-        return true;
-    }
-
-    token = Token::KeywordTokenFromSourceView(sv, this->line);
-    if (token.type != TOKEN_ILLEGAL_TOKEN) {
-        this->tokens.push(token);
-        
-        return true;
-    }
-
-    token.type = TOKEN_IDENTIFIER;
-    this->tokens.push(token);
-
-    return true;
+    this->right_pos = position + 2;
 }
 
-void Lexer::consume_until_new_line() {
-    while (!this->is_eof() && peek_nth_char() != '\n') {
-        this->consume_next_char();
-    }
-}
+// Maximal munch over the operator table generated from X_SYNTAX_TOKENS
+void Lexer::consume_syntax() {
+    u8 first = (u8)this->c;
+    u64 available = this->source.length - this->left_pos;
+    const char* start = this->source.data + this->left_pos;
 
-bool Lexer::consume_syntax() {
-    if (this->c == '/') {
-        if (this->consume_on_match('/')) {
-            this->consume_until_new_line();
-            // add_token(lexer, SPL_TOKEN_COMMENT);
-            return true;
-        } else if (this->consume_on_match('*')) {
-            while (!(this->peek_nth_char() == '*' && peek_nth_char(1) == '/')) {
-                if (this->is_eof()) {
-                    this->report_error("Multiline comment doesn't terminate\n");
-                }
-                
-                this->consume_next_char();
-            }
+    const LexerSyntaxEntry* entries = LEXER_TABLES.syntax + LEXER_TABLES.syntax_first[first];
+    for (u32 i = 0; i < LEXER_TABLES.syntax_count[first]; i++) {
+        const LexerSyntaxEntry& entry = entries[i];
+        if (entry.length <= available && lexeme_equal(start, entry.length, entry.lexeme, entry.length)) {
+            this->right_pos = this->left_pos + entry.length;
+            this->emit(Token(entry.type, this->get_scratch_buffer(), this->line));
 
-            this->consume_next_char(); // consume '*'
-            this->consume_next_char(); // consume '/'
-            // add_token(lexer, SPL_TOKEN_COMMENT);
-            return true;
+            return;
         }
-    } else if (this->c == '<') {
-        this->consume_on_match('<');
-        this->consume_on_match('=');
-    } else if (this->c == '>') {
-        this->consume_on_match('>');
-        this->consume_on_match('=');
-    } else if (this->c == '-') {
-        if (this->consume_on_match('-')) {} 
-        else if(this->consume_on_match('=')) {}
-        else if(this->consume_on_match('>')) {}
-    } else if (this->c == '+') {
-        if (!this->consume_on_match('+')) {
-            this->consume_on_match('=');
-        }
-    } else if (this->c == '|') {
-        if (!this->consume_on_match('|')) {
-            this->consume_on_match('=');
-        }
-    } else if (this->c == '&') {
-        if (!this->consume_on_match('&')) {
-            this->consume_on_match('=');
-        }
-    } else if (this->c == '!' || this->c == '^' || this->c == '*' || this->c == '=') {
-        this->consume_on_match('=');
-    } else if (this->c == ':') {
-        this->consume_on_match('=');
-    }
-
-    DS::View<char> sv = this->get_scratch_buffer();
-    Token token = Token::SyntaxTokenFromSourceView(sv, this->line);
-    if (token.type != TOKEN_ILLEGAL_TOKEN) {
-        this->tokens.push(token);
-        return true;
     }
 
-    return false;
+    this->report_error("Illegal token found\n");
 }
 
 void Lexer::consume_next_token() {
     this->left_pos = this->right_pos;
     this->consume_next_char();
 
-    if (this->consume_whitespace()) {}
-    else if (this->consume_literal()) {}
-    else if (this->consume_word()) {}
-    else if (this->consume_syntax()) {}
-    else {
-        this->report_error("Illegal token found\n");
+    switch ((LexerCharClass)LEXER_TABLES.char_class[(u8)this->c]) {
+        case LCC_WHITESPACE: {
+            this->consume_whitespace();
+        } break;
+
+        case LCC_DIGIT: {
+            this->consume_digit_literal();
+        } break;
+
+        case LCC_ALPHA: {
+            this->consume_word();
+        } break;
+
+        case LCC_SIGN: {
+            char next = this->peek_nth_char();
+            if (next >= '0' && next <= '9') {
+                this->consume_digit_literal();
+            } else {
+                this->consume_syntax();
+            }
+        } break;
+
+        case LCC_DOUBLE_QUOTE: {
+            this->consume_string_literal();
+        } break;
+
+        case LCC_SINGLE_QUOTE: {
+            this->consume_character_literal();
+        } break;
+
+        case LCC_SLASH: {
+            char next = this->peek_nth_char();
+            if (next == '/') {
+                this->consume_line_comment();
+            } else if (next == '*') {
+                this->right_pos += 1;
+                this->consume_block_comment();
+            } else {
+                this->consume_syntax();
+            }
+        } break;
+
+        case LCC_SYNTAX: {
+            this->consume_syntax();
+        } break;
+
+        case LCC_ILLEGAL: {
+            this->report_error("Illegal token found\n");
+        } break;
     }
 }
 
 bool Lexer::is_eof() {
     return this->right_pos >= this->source.length;
-}
\ No newline at end of file
+}
@@ -3,34 +3,86 @@
 #include "../DataStructure/ds.hpp"
 #include "token.hpp"
 
+#define LEXER_PARALLEL_MIN_CHUNK_SIZE KB(64)
+#define LEXER_PARALLEL_MAX_CHUNKS 64
+
+// The old source range [offset, offset + removed_length) was replaced by inserted_length bytes
+struct LexerEdit {
+    u32 offset;
+    u32 removed_length;
+    u32 inserted_length;
+};
+
+// What relex rewrote: tokens[first_token, first_token + inserted_count) are new, everything after only moved
+struct LexerSplice {
+    u64 first_token;
+    u64 removed_count;
+    u64 inserted_count;
+};
+
 struct Lexer {
+    Lexer(DS::View<char> source);
+
+    // Materializes every token, use TokenStream to lex on demand instead
     static void generate_tokens(u8* data, byte_t file_size, DS::Vector<Token>& out_tokens);
 
+    /**
+     * Same tokens as generate_tokens, but the source is cut at newlines into one chunk per thread.
+     * Every chunk is lexed speculatively assuming it doesn't start inside a string or comment,
+     * then the chunks are stitched in order: a chunk whose start doesn't line up with where the previous
+     * one really stopped is re-lexed from there until it falls back onto its speculative tokens.
+     * Identifiers are interned during the stitch so symbols come out in source order.
+     * Sources under LEXER_PARALLEL_MIN_CHUNK_SIZE per thread just lex sequentially, thread_count 0 uses every core.
+     */
+    static void generate_tokens_parallel(u8* data, byte_t file_size, DS::Vector<Token>& out_tokens, u32 thread_count = 0);
+
+    // 16 byte tokens without lines, build a SourceMap over the same source for diagnostics
+    static void generate_compact_tokens(u8* data, byte_t file_size, DS::Vector<CompactToken>& out_tokens, DS::Vector<TokenValue>& out_literals);
+
+    /**
+     * Brings tokens from generate_compact_tokens up to date after an edit, new_source is the whole text after it.
+     * Lexing restarts at the last token that starts before the edit and stops as soon as a token starts
+     * where an old token started (shifted by the edit), from there on the old tokens are reused with moved offsets.
+     * The cost is the edit plus the tokens it disturbs, not the file. Rebuild the SourceMap for lines afterwards,
+     * literals of replaced tokens stay in the pool until the next full lex.
+     */
+    static LexerSplice relex(DS::Vector<CompactToken>& tokens, DS::Vector<TokenValue>& literals, LexerEdit edit, DS::View<char> new_source);
+
+    // Pull style, returns false once the source is exhausted. The source must already be valid UTF-8.
+    bool next_token(Token* out_token);
+
     private:
         DS::View<char> source;
-        DS::Vector<Token>& tokens;
         u32 left_pos;
         u32 right_pos;
         u32 line;
         char c;
 
-        Lexer(DS::View<char> source, DS::Vector<Token>& tokens);
+        Token* out_token; // where emit writes, set by next_token
+        bool has_token;
+
+        bool track_lines; // off for CompactToken, which gets lines from a SourceMap instead
+
+        // generate_tokens_parallel workers: errors stop the lexer instead of asserting, identifiers aren't interned
+        bool speculative;
+        bool failed;
+
+        void emit(Token token);
+        static void lex_chunk(void* user_data);
 
         void consume_next_char();
-        bool consume_whitespace();
         char peek_nth_char(u64 n = 0);
         DS::View<char> get_scratch_buffer();
         void report_error(const char* msg);
-        bool consume_on_match(char expected);
 
+        void consume_whitespace();
         void consume_digit_literal();
         void consume_string_literal();
         void consume_character_literal();
-        bool consume_literal();
-        bool try_consume_word();
-        bool consume_word();
-        void consume_until_new_line();
-        bool consume_syntax();
+        void consume_word();
+        void consume_line_comment();
+        void consume_block_comment();
+        void consume_syntax();
         void consume_next_token();
         bool is_eof();
     };
\ No newline at end of file
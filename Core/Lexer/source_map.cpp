@@ -0,0 +1,115 @@
+#include "source_map.hpp"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define SOURCE_MAP_SIMD_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define SOURCE_MAP_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined(SOURCE_MAP_SIMD_SSE2) || defined(SOURCE_MAP_SIMD_NEON)
+    internal inline u32 source_map_count_trailing_zeros(u64 value) {
+        #if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return (u32)index;
+        #else
+            return (u32)__builtin_ctzll(value);
+        #endif
+    }
+#endif
+
+// rough guess of 40 bytes per line so the table rarely grows
+SourceMap::SourceMap(Memory::BaseAllocator* allocator, DS::View<char> source) : m_source(source), m_line_starts(allocator, source.length / 40 + 1) {
+    RUNTIME_ASSERT_MSG(source.length <= 0xFFFFFFFFULL, "SourceMap offsets are 32 bit, source is %llu bytes\n", (unsigned long long)source.length);
+
+    this->m_line_starts.push(0);
+
+    const char* data = source.data;
+    u64 i = 0;
+
+    #if defined(SOURCE_MAP_SIMD_SSE2)
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; i + 16 <= source.length; i += 16) {
+            u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + i)), newline));
+            while (mask) {
+                this->m_line_starts.push((u32)(i + source_map_count_trailing_zeros(mask) + 1));
+                mask &= mask - 1;
+            }
+        }
+    #elif defined(SOURCE_MAP_SIMD_NEON)
+        const uint8x16_t newline = vdupq_n_u8('\n');
+        for (; i + 16 <= source.length; i += 16) {
+            uint8x16_t matches = vceqq_u8(vld1q_u8((const u8*)(data + i)), newline);
+
+            // 4 bits per byte, keep one of them so every set bit is one '\n'
+            u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0) & 0x8888888888888888ULL;
+            while (mask) {
+                this->m_line_starts.push((u32)(i + (source_map_count_trailing_zeros(mask) / 4) + 1));
+                mask &= mask - 1;
+            }
+        }
+    #endif
+
+    for (; i < source.length; i++) {
+        if (data[i] == '\n') {
+            this->m_line_starts.push((u32)(i + 1));
+        }
+    }
+}
+
+u32 SourceMap::line_of(u32 offset) const {
+    // number of line starts <= offset
+    const u32* starts = this->m_line_starts.data();
+    u64 low = 0;
+    u64 high = this->m_line_starts.count();
+    while (low < high) {
+        u64 middle = low + ((high - low) / 2);
+        if (starts[middle] <= offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return (u32)low;
+}
+
+u32 SourceMap::line_of(u32 offset, u32 line_hint) const {
+    const u32* starts = this->m_line_starts.data();
+    u64 count = this->m_line_starts.count();
+    if (line_hint == 0 || line_hint > count || starts[line_hint - 1] > offset) {
+        return this->line_of(offset);
+    }
+
+    // amortized O(1) when the offsets come in order, no mispredicted binary search per token
+    u64 line = line_hint;
+    while (line < count && starts[line] <= offset) {
+        line += 1;
+    }
+
+    return (u32)line;
+}
+
+SourceLocation SourceMap::location_of(u32 offset) const {
+    SourceLocation ret = {};
+    ret.line = this->line_of(offset);
+    ret.column = offset - this->m_line_starts.data()[ret.line - 1] + 1;
+
+    return ret;
+}
+
+u32 SourceMap::line_start(u32 line) const {
+    RUNTIME_ASSERT_MSG(line >= 1 && line <= this->line_count(), "Line %u is outside of the source\n", line);
+
+    return this->m_line_starts.data()[line - 1];
+}
+
+u32 SourceMap::line_count() const {
+    return (u32)this->m_line_starts.count();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../Common/common.hpp"
+#include "../Memory/memory.hpp"
+#include "../DataStructure/ds.hpp"
+
+// 1 based like Token::line, column counts bytes
+struct SourceLocation {
+    u32 line;
+    u32 column;
+};
+
+/**
+ * Offset -> line/column for sources whose tokens don't carry lines (CompactToken).
+ * The newline table is built once with SIMD, lookups are a binary search over it,
+ * so the lexer never has to count lines and only diagnostics pay for them.
+ */
+struct SourceMap {
+    SourceMap(Memory::BaseAllocator* allocator, DS::View<char> source);
+
+    // Prevent copy
+    SourceMap(const SourceMap& other) = delete;
+    SourceMap& operator=(const SourceMap& other) = delete;
+
+    u32 line_of(u32 offset) const; // 1 + the '\n' before offset, a '\n' belongs to the line it ends
+    u32 line_of(u32 offset, u32 line_hint) const; // walks forward from a line at or before offset, for offsets that only grow
+    SourceLocation location_of(u32 offset) const;
+    u32 line_start(u32 line) const; // offset of the first byte of the line
+    u32 line_count() const;
+
+private:
+    DS::View<char> m_source;
+    DS::Vector<u32> m_line_starts; // [0] is 0, then one past every '\n'
+};
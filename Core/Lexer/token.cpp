@@ -1,46 +1,124 @@
 #include "token.hpp"
-#include <stdlib.h>
+#include "../String/string.hpp"
+
+#include <string.h>
 
 Token::Token(TokenType token_type, DS::View<char> sv, int line) : sv(sv) {
     this->type = token_type;
     this->line = line;
 }
 
-Token Token::PrimiveTypeTokenFromSourceView(DS::View<char> sv, int line) {
-    Memory::GeneralAllocator general_allocator = Memory::GeneralAllocator();
+// Perfect hash over X_KEYWORD_TOKENS and X_PRIMITIVE_TYPES_TOKENS: (first * a + last * b + length) & mask.
+// The multipliers are searched at compile time, so a word is classified with one table read and one compare.
+#define WORD_HASH_TABLE_SIZE 64
 
-    static DS::Hashmap<DS::View<char>, TokenType> primitive_type_map = {
-        #define X(name, str) { DS::View<char>(str, sizeof(str) - 1), name },
+struct WordHashEntry {
+    const char* lexeme;
+    u32 length;
+    TokenType type;
+};
+
+struct WordHashTable {
+    u32 first_multiplier;
+    u32 last_multiplier;
+    WordHashEntry entries[WORD_HASH_TABLE_SIZE];
+};
+
+internal constexpr u32 word_hash(u32 first_multiplier, u32 last_multiplier, const char* word, u64 length) {
+    return ((u32)(u8)word[0] * first_multiplier + (u32)(u8)word[length - 1] * last_multiplier + (u32)length) & (WORD_HASH_TABLE_SIZE - 1);
+}
+
+internal constexpr WordHashTable make_word_hash_table() {
+    const WordHashEntry words[] = {
+        #define X(name, str) { str, sizeof(str) - 1, name },
+            X_KEYWORD_TOKENS
             X_PRIMITIVE_TYPES_TOKENS
         #undef X
     };
 
+    for (u32 a = 1; a < WORD_HASH_TABLE_SIZE; a++) {
+        for (u32 b = 1; b < WORD_HASH_TABLE_SIZE; b++) {
+            WordHashTable ret = {};
+            ret.first_multiplier = a;
+            ret.last_multiplier = b;
+
+            bool collision = false;
+            for (const WordHashEntry& word : words) {
+                WordHashEntry& slot = ret.entries[word_hash(a, b, word.lexeme, word.length)];
+                if (slot.lexeme) {
+                    collision = true;
+                    break;
+                }
+
+                slot = word;
+            }
+
+            if (!collision) {
+                return ret;
+            }
+        }
+    }
+
+    return {}; // first_multiplier == 0 trips the static assert below
+}
+
+internal constexpr WordHashTable WORD_HASH_TABLE = make_word_hash_table();
+STATIC_ASSERT(WORD_HASH_TABLE.first_multiplier != 0, "No perfect hash found for the keywords, grow WORD_HASH_TABLE_SIZE");
+
+// Returns TOKEN_IDENTIFIER for anything that isn't a keyword or primitive type
+internal TokenType classify_word(DS::View<char> sv) {
+    if (sv.length == 0) {
+        return TOKEN_IDENTIFIER;
+    }
+
+    const WordHashEntry& entry = WORD_HASH_TABLE.entries[word_hash(WORD_HASH_TABLE.first_multiplier, WORD_HASH_TABLE.last_multiplier, sv.data, sv.length)];
+    if (entry.length != sv.length || memcmp(entry.lexeme, sv.data, sv.length) != 0) {
+        return TOKEN_IDENTIFIER;
+    }
+
+    return entry.type;
+}
+
+internal bool is_keyword(TokenType type) {
+    #define X(name, str) || type == name
+        return false X_KEYWORD_TOKENS;
+    #undef X
+}
+
+Token Token::PrimiveTypeTokenFromSourceView(DS::View<char> sv, int line) {
     Token ret = Token(); // Invalid
     ret.sv = sv;
     ret.line = line;
 
-    if (primitive_type_map.has(sv)) {
-        ret.type = primitive_type_map.get(sv);
+    TokenType type = classify_word(sv);
+    if (type != TOKEN_IDENTIFIER && !is_keyword(type)) {
+        ret.type = type;
     }
 
     return ret;
 }
 
 Token Token::KeywordTokenFromSourceView(DS::View<char> sv, int line) {
-    Memory::GeneralAllocator general_allocator = Memory::GeneralAllocator();
-
-    static DS::Hashmap<DS::View<char>, TokenType> syntax_map = {
-        #define X(name, str) { DS::View<char>(str, sizeof(str) - 1), name },
-            X_KEYWORD_TOKENS
-        #undef X
-    };
-
     Token ret = Token(); // Invalid
     ret.sv = sv;
     ret.line = line;
 
-    if (syntax_map.has(sv)) {
-        ret.type = syntax_map.get(sv);
+    TokenType type = classify_word(sv);
+    if (is_keyword(type)) {
+        ret.type = type;
+        ret.b = ret.type == TKW_TRUE; // the value consumers like JSON::parse read for TKW_TRUE/TKW_FALSE
+    }
+
+    return ret;
+}
+
+Token Token::WordTokenFromSourceView(DS::View<char> sv, int line, bool intern) {
+    Token ret = Token(classify_word(sv), sv, line);
+    if (ret.type == TOKEN_IDENTIFIER) {
+        // without intern the caller interns later, the global interner isn't thread safe
+        ret.symbol = intern ? String::global_interner()->intern(sv) : SYMBOL_INVALID;
+    } else {
+        ret.b = ret.type == TKW_TRUE;
     }
 
     return ret;
@@ -79,40 +157,90 @@ Token Token::LiteralTokenFromSourceView(DS::View<char> sv, int line) {
         return ret;
     }
 
-    if (String::equal(ret.sv.data, sv.length, "true", sizeof("true") - 1)) {
-        ret.type = TKW_TRUE;
-        ret.b = true;
+    s64 integer = 0;
+    float floating = 0.0f;
+    switch (String::parse_number(sv, &integer, &floating)) {
+        case String::NUMBER_INTEGER: {
+            ret.type = TL_INTEGER;
+            ret.i = integer;
+        } break;
+
+        case String::NUMBER_FLOAT: {
+            ret.type = TL_FLOAT;
+            ret.f = floating;
+        } break;
+
+        case String::NUMBER_INTEGER_OVERFLOW: {
+            RUNTIME_ASSERT_MSG(false, "Line: %d | Integer literal doesn't fit in 64 bits: %.*s\n", line, (int)sv.length, sv.data);
+        } break;
+
+        case String::NUMBER_INVALID: {
+            // stays TOKEN_ILLEGAL_TOKEN
+        } break;
+    }
 
-        return ret;
-    } else if (String::equal(ret.sv.data, sv.length, "false", sizeof("false") - 1)) {
-        ret.type = TKW_FALSE;
-        ret.b = false;
+    return ret;
+}
 
-        return ret;
+CompactToken Token::compact(DS::View<char> source, DS::Vector<TokenValue>& out_literals) const {
+    CompactToken ret = {};
+    ret.type = (u8)this->type;
+    ret.offset = (u32)(this->sv.data - source.data);
+    ret.length = (u32)this->sv.length;
+
+    if (this->type == TOKEN_IDENTIFIER) {
+        ret.literal = this->symbol;
+    } else if (this->type == TL_INTEGER || this->type == TL_FLOAT) {
+        TokenValue value = {};
+        if (this->type == TL_INTEGER) {
+            value.i = this->i;
+        } else {
+            value.f = this->f;
+        }
+
+        ret.literal = (u32)out_literals.count();
+        out_literals.push(value);
     }
 
-    char buffer[128];
-    RUNTIME_ASSERT(sv.length < sizeof(buffer));
+    return ret;
+}
 
-    Memory::copy(buffer, ret.sv.length, ret.sv.data, ret.sv.length);
-    buffer[ret.sv.length] = '\0';
-    
-    char* endptr_int = nullptr;
-    long i = strtol(buffer, &endptr_int, 10);
-    if ((byte_t)(endptr_int - buffer) == sv.length) {
-        ret.type = TL_INTEGER;
-        ret.i = (int)i;
+Token Token::FromCompactToken(CompactToken compact, DS::View<char> source, DS::View<TokenValue> literals, const SourceMap& source_map) {
+    // the lexer reports the line it is on once the token is consumed, which is the line of the byte after sv
+    // (the closing quote for strings, newlines inside the literal count)
+    return Token::FromCompactToken(compact, source, literals, source_map.line_of(compact.offset + compact.length));
+}
 
-        return ret;
-    }
-    
-    char* endptr = nullptr;
-    float f = strtof(buffer, &endptr);
-    if ((byte_t)(endptr - buffer) == sv.length) {
-        ret.type = TL_FLOAT;
-        ret.f = f;
+Token Token::FromCompactToken(CompactToken compact, DS::View<char> source, DS::View<TokenValue> literals, u32 line) {
+    DS::View<char> sv = DS::View<char>(source.data + compact.offset, compact.length);
 
-        return ret;
+    Token ret = Token((TokenType)compact.type, sv, (int)line);
+    ret.i = 0;
+
+    switch (ret.type) {
+        case TOKEN_IDENTIFIER: {
+            ret.symbol = compact.literal;
+        } break;
+
+        case TL_INTEGER: {
+            ret.i = literals.data[compact.literal].i;
+        } break;
+
+        case TL_FLOAT: {
+            ret.f = literals.data[compact.literal].f;
+        } break;
+
+        case TL_CHARACTER: {
+            ret.c = sv.data[1];
+        } break;
+
+        case TKW_TRUE:
+        case TKW_FALSE: {
+            ret.b = ret.type == TKW_TRUE;
+        } break;
+
+        default: {
+        } break;
     }
 
     return ret;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../DataStructure/ds.hpp"
+#include "../String/interner.hpp"
+#include "source_map.hpp"
 
 #define X_SYNTAX_TOKENS          \
     X(TS_PLUS, "+")              \
@@ -87,6 +89,29 @@ enum TokenType {
     TOKEN_COUNT
 };
 
+// The value part of a token, CompactToken keeps these in a side pool
+union TokenValue {
+    s64 i;
+    float f;
+    char c;
+    bool b;
+    String::Symbol symbol;
+};
+
+/**
+ * 16 byte token for materializing whole files, half of a Token.
+ * No pointers and no line: sv is [offset, offset + length) of the source (quotes excluded for strings like Token::sv),
+ * lines come from a SourceMap only when something needs them.
+ * literal is the Symbol for TOKEN_IDENTIFIER, an index into the literal pool for TL_INTEGER and TL_FLOAT and 0 otherwise,
+ * characters and booleans are recovered from the source and the type.
+ */
+struct CompactToken {
+    u8 type; // TokenType
+    u32 offset;
+    u32 length;
+    u32 literal;
+};
+
 struct Token {
     TokenType type = TOKEN_ILLEGAL_TOKEN;
     u32 line = 404;
@@ -94,10 +119,11 @@ struct Token {
     DS::View<char> sv; // used for identifer names, string literals, the source_view
 
     union {
-        int i;
+        s64 i;
         float f;
         char c;
         bool b;
+        String::Symbol symbol; // TOKEN_IDENTIFIER only
     };
 
     Token() = default;
@@ -107,7 +133,15 @@ struct Token {
     static Token SyntaxTokenFromSourceView(DS::View<char> sv, int line);
     static Token LiteralTokenFromSourceView(DS::View<char> sv, int line);
     static Token PrimiveTypeTokenFromSourceView(DS::View<char> sv, int line);
+    static Token WordTokenFromSourceView(DS::View<char> sv, int line, bool intern = true); // keyword, primitive type or (interned) identifier
+    static Token FromCompactToken(CompactToken compact, DS::View<char> source, DS::View<TokenValue> literals, const SourceMap& source_map);
+    static Token FromCompactToken(CompactToken compact, DS::View<char> source, DS::View<TokenValue> literals, u32 line);
+
+    CompactToken compact(DS::View<char> source, DS::Vector<TokenValue>& out_literals) const;
 
     void print();
     const char* type_to_string() const;
-};
\ No newline at end of file
+};
+
+STATIC_ASSERT(TOKEN_COUNT <= 256, "CompactToken stores the type in a u8");
+STATIC_ASSERT(sizeof(CompactToken) == 16, "CompactToken should stay 16 bytes");
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "token_cache.hpp"
+#include "../Platform/platform.hpp"
+
+#include <stdio.h>
+#include <atomic>
+
+global std::atomic<u32> g_token_cache_writer_count = 0;
+
+TokenCache::TokenCache(Memory::BaseAllocator* allocator, DS::View<char> source) : m_source(source), m_source_map(allocator, source), m_symbols(allocator, 16) {
+    this->m_source_hash = Hashing::fingerprint128(source.data, source.length);
+}
+
+TokenCache::~TokenCache() {
+    this->unload();
+}
+
+void TokenCache::unload() {
+    Platform::unmap_file(this->m_mapping, this->m_mapping_size);
+    this->m_mapping = nullptr;
+    this->m_mapping_size = 0;
+    this->m_tokens = nullptr;
+    this->m_token_count = 0;
+    this->m_literals = DS::View<TokenValue>();
+    this->m_symbols.resize(0);
+}
+
+bool TokenCache::open(const char* directory) {
+    char cache_path[TOKEN_CACHE_MAX_PATH];
+    int path_length = snprintf(
+        cache_path, sizeof(cache_path), "%s/%016llx%016llx" TOKEN_CACHE_EXTENSION, directory,
+        (unsigned long long)this->m_source_hash.high, (unsigned long long)this->m_source_hash.low
+    );
+
+    if (path_length < 0 || path_length >= (int)sizeof(cache_path)) {
+        LOG_ERROR("Token cache path is longer than %d bytes: %s\n", TOKEN_CACHE_MAX_PATH, directory);
+        return false;
+    }
+
+    if (this->load(cache_path)) {
+        return true;
+    }
+
+    Error error = ERROR_SUCCESS;
+
+    return this->store(cache_path, error) && this->load(cache_path);
+}
+
+bool TokenCache::load(const char* cache_path) {
+    this->unload();
+
+    // a miss is the normal case, don't let map_file log it
+    if (!Platform::file_path_exists(cache_path)) {
+        return false;
+    }
+
+    Error error = ERROR_SUCCESS;
+    byte_t size = 0;
+    u8* mapping = Platform::map_file(cache_path, size, error);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    this->m_mapping = mapping;
+    this->m_mapping_size = size;
+
+    const TokenCacheHeader* header = (const TokenCacheHeader*)mapping;
+    bool valid = size >= sizeof(TokenCacheHeader) &&
+                 header->magic == TOKEN_CACHE_MAGIC &&
+                 header->version == TOKEN_CACHE_VERSION &&
+                 header->token_type_count == TOKEN_COUNT &&
+                 header->source_size == this->m_source.length &&
+                 header->source_hash == this->m_source_hash;
+
+    // each count is bounded first so a garbage header can't overflow the size sum
+    valid = valid &&
+            header->token_count <= size / sizeof(CompactToken) &&
+            header->literal_count <= size / sizeof(TokenValue) &&
+            header->name_count <= size / sizeof(u32) &&
+            size == sizeof(TokenCacheHeader) + (header->token_count * sizeof(CompactToken)) + (header->literal_count * sizeof(TokenValue)) + (header->name_count * sizeof(u32));
+
+    if (!valid) {
+        this->unload();
+        return false;
+    }
+
+    const CompactToken* tokens = (const CompactToken*)(mapping + sizeof(TokenCacheHeader));
+    const TokenValue* literals = (const TokenValue*)(tokens + header->token_count);
+    const u32* names = (const u32*)(literals + header->literal_count);
+
+    this->m_tokens = tokens;
+    this->m_token_count = header->token_count;
+    this->m_literals = DS::View<TokenValue>(literals, header->literal_count);
+
+    for (u64 i = 0; i < header->name_count; i++) {
+        u32 name_token = names[i];
+        if (name_token >= header->token_count || tokens[name_token].type != TOKEN_IDENTIFIER) {
+            this->unload();
+            return false;
+        }
+
+        const CompactToken& compact = tokens[name_token];
+        this->m_symbols.push(String::global_interner()->intern(this->m_source.data + compact.offset, compact.length));
+    }
+
+    return true;
+}
+
+bool TokenCache::store(const char* cache_path, Error& error) const {
+    // same guess as the parallel lexer chunks, a token per 16 source bytes, the vector grows past it
+    DS::Vector<CompactToken> tokens = DS::Vector<CompactToken>(&Memory::global_general_allocator, MAX(this->m_source.length / 16, (u64)16));
+    DS::Vector<TokenValue> literals = DS::Vector<TokenValue>(&Memory::global_general_allocator, 16);
+    Lexer::generate_compact_tokens((u8*)this->m_source.data, this->m_source.length, tokens, literals);
+
+    // symbols are dense so a flat table maps them to name index + 1, 0 is a name not seen yet
+    u64 symbol_count = String::global_interner()->count() + 1;
+    DS::Vector<u32> name_of_symbol = DS::Vector<u32>(&Memory::global_general_allocator, symbol_count);
+    name_of_symbol.resize(symbol_count);
+    Memory::zero(name_of_symbol.data(), symbol_count * sizeof(u32));
+
+    DS::Vector<u32> names = DS::Vector<u32>(&Memory::global_general_allocator, 16);
+    CompactToken* token_data = tokens.data();
+    for (u64 i = 0; i < tokens.count(); i++) {
+        if (token_data[i].type != TOKEN_IDENTIFIER) {
+            continue;
+        }
+
+        u32& name = name_of_symbol[(int)token_data[i].literal];
+        if (name == 0) {
+            names.push((u32)i);
+            name = (u32)names.count();
+        }
+
+        token_data[i].literal = name - 1;
+    }
+
+    TokenCacheHeader header = {};
+    header.magic = TOKEN_CACHE_MAGIC;
+    header.version = TOKEN_CACHE_VERSION;
+    header.token_type_count = TOKEN_COUNT;
+    header.source_hash = this->m_source_hash;
+    header.source_size = this->m_source.length;
+    header.token_count = tokens.count();
+    header.literal_count = literals.count();
+    header.name_count = names.count();
+
+    byte_t tokens_size = tokens.count() * sizeof(CompactToken);
+    byte_t literals_size = literals.count() * sizeof(TokenValue);
+    byte_t names_size = names.count() * sizeof(u32);
+    byte_t file_size = sizeof(TokenCacheHeader) + tokens_size + literals_size + names_size;
+
+    u8* buffer = (u8*)Memory::global_general_allocator.malloc(file_size);
+    u8* cursor = buffer;
+    Memory::copy(cursor, sizeof(TokenCacheHeader), &header, sizeof(TokenCacheHeader));
+    cursor += sizeof(TokenCacheHeader);
+    Memory::copy(cursor, tokens_size, tokens.data(), tokens_size);
+    cursor += tokens_size;
+    Memory::copy(cursor, literals_size, literals.data(), literals_size);
+    cursor += literals_size;
+    Memory::copy(cursor, names_size, names.data(), names_size);
+
+    // written next to the final name and renamed over it, so a concurrent run never maps half a file.
+    // Every writer gets its own temp file (pid + counter), two runs writing one temp file could rename it half written.
+    char temp_path[TOKEN_CACHE_MAX_PATH + 32];
+    u32 writer = g_token_cache_writer_count.fetch_add(1, std::memory_order_relaxed);
+    snprintf(temp_path, sizeof(temp_path), "%s.%u.%u.tmp", cache_path, Platform::get_process_id(), writer);
+
+    bool success = Platform::write_entire_file(temp_path, buffer, file_size, error);
+    Memory::global_general_allocator.free(buffer);
+    if (!success) {
+        return false;
+    }
+
+    if (rename(temp_path, cache_path) != 0) {
+        // another run got there first (Windows won't rename over an existing file)
+        remove(temp_path);
+
+        return Platform::file_path_exists(cache_path);
+    }
+
+    return true;
+}
+
+u64 TokenCache::token_count() const {
+    return this->m_token_count;
+}
+
+Token TokenCache::token(u64 index, u32 line_hint) const {
+    CompactToken compact = this->m_tokens[index];
+    if (compact.type == TOKEN_IDENTIFIER) {
+        compact.literal = this->m_symbols.data()[compact.literal];
+    }
+
+    u32 line = this->m_source_map.line_of(compact.offset + compact.length, line_hint);
+
+    return Token::FromCompactToken(compact, this->m_source, this->m_literals, line);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../Error/error.hpp"
+#include "../Hashing/hashing.hpp"
+#include "lexer.hpp"
+
+#define TOKEN_CACHE_MAGIC 0x4E4B4F54 // "TOKN" as little endian bytes, a byte swapped file reads as a miss
+#define TOKEN_CACHE_VERSION 1        // bump whenever CompactToken, TokenValue or what the lexer emits changes
+#define TOKEN_CACHE_EXTENSION ".tokens"
+#define TOKEN_CACHE_MAX_PATH 1024
+
+/**
+ * Start of a token cache file, the rest is three flat arrays:
+ *
+ *     CompactToken tokens[token_count]
+ *     TokenValue literals[literal_count]
+ *     u32 names[name_count]
+ *
+ * Symbols only mean something inside one process, so identifier tokens store an index into names instead
+ * and names[k] is the index of the first token spelling that name.
+ */
+struct TokenCacheHeader {
+    u32 magic;
+    u32 version;
+    u32 token_type_count; // TOKEN_COUNT when written, types are stored as numbers
+    u32 reserved;
+    Hashing::Hash128 source_hash;
+    u64 source_size;
+    u64 token_count;
+    u64 literal_count;
+    u64 name_count;
+};
+
+STATIC_ASSERT(sizeof(TokenCacheHeader) == 64, "TokenCacheHeader keeps the token array 16 byte aligned");
+
+/**
+ * The tokens of one source kept on disk, so a source that hasn't changed skips the lexer on the next run.
+ * The file is named after the fingerprint128 of the source and mapped read-only, the token array is used in place.
+ * A hit costs one hash of the source, interning each distinct name once and a SourceMap for lines.
+ *
+ *     TokenCache cache = TokenCache(allocator, source);
+ *     if (cache.open(directory)) { TokenStream tokens = TokenStream(&cache); ... }
+ *
+ * Files from another version, another TokenType or other bytes are misses and get rewritten.
+ * Like any build output the directory is trusted, past the header checks token offsets aren't validated.
+ */
+struct TokenCache {
+    TokenCache(Memory::BaseAllocator* allocator, DS::View<char> source);
+    ~TokenCache();
+
+    // Prevent copy
+    TokenCache(const TokenCache& other) = delete;
+    TokenCache& operator=(const TokenCache& other) = delete;
+
+    // Loads <directory>/<hash>.tokens, on a miss lexes the source and writes it first.
+    // False if it can be neither loaded nor written, the caller should just lex.
+    bool open(const char* directory);
+    // Maps an existing cache file, false with nothing loaded if it is missing or stale
+    bool load(const char* cache_path);
+    // Lexes the source and writes the cache file, doesn't load it
+    bool store(const char* cache_path, Error& error) const;
+
+    u64 token_count() const;
+    // index < token_count(), line_hint is the line of an earlier token (TokenStream passes the previous one) or 0
+    Token token(u64 index, u32 line_hint = 0) const;
+
+private:
+    DS::View<char> m_source;
+    Hashing::Hash128 m_source_hash;
+    SourceMap m_source_map;
+
+    u8* m_mapping = nullptr;
+    byte_t m_mapping_size = 0;
+    const CompactToken* m_tokens = nullptr;
+    u64 m_token_count = 0;
+    DS::View<TokenValue> m_literals;
+    DS::Vector<String::Symbol> m_symbols; // name index -> Symbol in this process
+
+    void unload();
+};
@@ -0,0 +1,71 @@
+#include "token_stream.hpp"
+#include "../String/string.hpp"
+
+#define TOKEN_STREAM_MASK (TOKEN_STREAM_LOOKAHEAD - 1)
+STATIC_ASSERT((TOKEN_STREAM_LOOKAHEAD & TOKEN_STREAM_MASK) == 0, "TOKEN_STREAM_LOOKAHEAD must be a power of two");
+
+TokenStream::TokenStream(u8* data, byte_t file_size) : m_lexer(DS::View<char>((char*)data, file_size)) {
+    // one pass up front is still cheap next to lexing, and the lexer never has to care about encoding
+    u64 error_offset = 0;
+    RUNTIME_ASSERT_MSG(String::utf8_validate((char*)data, file_size, &error_offset), "Invalid UTF-8 at byte offset %llu\n", (unsigned long long)error_offset);
+}
+
+TokenStream::TokenStream(const TokenCache* cache) : m_lexer(DS::View<char>()) {
+    RUNTIME_ASSERT(cache);
+    this->m_cache = cache;
+}
+
+bool TokenStream::fill(u32 n) {
+    while (this->m_count <= n) {
+        Token& slot = this->m_ring[(this->m_head + this->m_count) & TOKEN_STREAM_MASK];
+        if (this->m_cache) {
+            if (this->m_cache_cursor == this->m_cache->token_count()) {
+                return false;
+            }
+
+            slot = this->m_cache->token(this->m_cache_cursor, this->m_cache_line);
+            this->m_cache_cursor += 1;
+            this->m_cache_line = slot.line;
+        } else if (!this->m_lexer.next_token(&slot)) {
+            return false;
+        }
+
+        if (this->log_tokens) {
+            LOG_DEBUG("%s(%.*s) | Line: %d\n", slot.type_to_string(), (int)slot.sv.length, slot.sv.data, slot.line);
+        }
+
+        this->m_count += 1;
+    }
+
+    return true;
+}
+
+Token TokenStream::peek_nth_token(u32 n) {
+    RUNTIME_ASSERT_MSG(n < TOKEN_STREAM_LOOKAHEAD, "TokenStream can only look %d tokens ahead\n", TOKEN_STREAM_LOOKAHEAD - 1);
+
+    if (!this->fill(n)) {
+        return Token(); // invalid
+    }
+
+    return this->m_ring[(this->m_head + n) & TOKEN_STREAM_MASK];
+}
+
+Token TokenStream::consume_next_token() {
+    if (!this->fill(0)) {
+        return Token(); // invalid
+    }
+
+    this->m_previous = this->m_ring[this->m_head];
+    this->m_head = (this->m_head + 1) & TOKEN_STREAM_MASK;
+    this->m_count -= 1;
+
+    return this->m_previous;
+}
+
+Token TokenStream::previous_token() const {
+    return this->m_previous;
+}
+
+bool TokenStream::is_eof() {
+    return !this->fill(0);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "lexer.hpp"
+#include "token_cache.hpp"
+
+#define TOKEN_STREAM_LOOKAHEAD 4 // power of two, the parsers peek at most one token past the current one
+
+/**
+ * Lexes on demand instead of materializing a DS::Vector<Token>, so only the lookahead ring
+ * is resident no matter how large the source is, and every token is still hot in cache when the parser reads it.
+ *
+ *     TokenStream tokens = TokenStream(data, file_size);
+ *     while (tokens.peek_nth_token().type != TOKEN_ILLEGAL_TOKEN) { ... tokens.consume_next_token() ... }
+ *
+ * Past the end of the source peek_nth_token and consume_next_token return Token() (TOKEN_ILLEGAL_TOKEN),
+ * the same sentinel the parsers already stop on. Built over a loaded TokenCache it reads the cached tokens instead of lexing.
+ */
+struct TokenStream {
+    bool log_tokens = false; // LOG_DEBUG every token as it is lexed
+
+    TokenStream(u8* data, byte_t file_size);
+    TokenStream(const TokenCache* cache); // the cache has to outlive the stream
+
+    // Prevent copy
+    TokenStream(const TokenStream& other) = delete;
+    TokenStream& operator=(const TokenStream& other) = delete;
+
+    Token peek_nth_token(u32 n = 0);
+    Token consume_next_token();
+    Token previous_token() const; // the last token handed out by consume_next_token
+    bool is_eof();
+
+private:
+    Lexer m_lexer;
+    const TokenCache* m_cache = nullptr;
+    u64 m_cache_cursor = 0;
+    u32 m_cache_line = 1;
+    Token m_ring[TOKEN_STREAM_LOOKAHEAD];
+    u32 m_head = 0;
+    u32 m_count = 0;
+    Token m_previous = Token();
+
+    // Lexes until n + 1 tokens are buffered, false if the source runs out first
+    bool fill(u32 n);
+};
@@ -1,14 +1,13 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "memory.hpp"
 
 namespace Memory {
     void zero(void* data, byte_t data_size_in_bytes) {
         RUNTIME_ASSERT(data);
-        
-        for (byte_t i = 0; i < data_size_in_bytes; i++) {
-            ((u8*)data)[i] = 0;
-        }
+
+        memset(data, 0, data_size_in_bytes);
     }
 
     void copy(void* destination, byte_t destination_size, const void* source, byte_t source_size) {
@@ -19,19 +18,8 @@ namespace Memory {
             return;
         }
 
-        u8* src = (u8*)source;
-        u8* dst = (u8*)destination;
-
-        bool overlap = dst < src || dst >= src + source_size;
-        if (overlap) {
-            for (byte_t i = 0; i < source_size; i++) {
-                dst[i] = src[i];
-            }
-        } else {
-            for (byte_t i = source_size; i-- > 0;) {
-                dst[i] = src[i];
-            }
-        }
+        // memmove handles overlapping ranges in either direction
+        memmove(destination, source, source_size);
     }
 
     bool equal(const void* buffer_one, byte_t b1_size, const void* buffer_two, byte_t b2_size) {
@@ -3,15 +3,11 @@
 #include <cstdio>
 
 Token Parser::peek_nth_token(int n) {
-    if (this->current + n >= this->tokens.count()) {
-        return Token(); // invalid
-    }
-
-    return this->tokens[this->current + n];
+    return this->tokens.peek_nth_token((u32)n);
 }
 
 Token Parser::previous_token() {
-    return this->tokens[this->current - 1];
+    return this->tokens.previous_token();
 }
 
 void Parser::report_error(const char* fmt, ...) {
@@ -27,7 +23,7 @@ void Parser::report_error(const char* fmt, ...) {
 }
 
 Token Parser::consume_next_token() {
-    return this->tokens[this->current++];
+    return this->tokens.consume_next_token();
 }
 
 Token Parser::expect(TokenType expected_type) {
@@ -1,12 +1,12 @@
 #pragma once
 
 #include "../Memory/allocator.hpp"
-#include "../Lexer/token.hpp"
+#include "../Lexer/token_stream.hpp"
 
 struct Parser {
     Memory::BaseAllocator* allocator;
     
-    Parser(Memory::BaseAllocator* allocator, const DS::Vector<Token>& tokens) : allocator(allocator), tokens(tokens) {}
+    Parser(Memory::BaseAllocator* allocator, TokenStream& tokens) : allocator(allocator), tokens(tokens) {}
 
     Token peek_nth_token(int n = 0);
     Token previous_token();
@@ -15,6 +15,5 @@ struct Parser {
     Token expect(TokenType expected_type);
     bool consume_on_match(TokenType expected_type);
 private:
-    const DS::Vector<Token>& tokens;
-    int current = 0;
+    TokenStream& tokens;
 };
\ No newline at end of file
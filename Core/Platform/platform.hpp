@@ -6,8 +6,29 @@
 // Date: August 04, 2025
 // NOTE(Jovanni): Im cheating here a bit I should have like win32 platform and linux platform but im just gonna do glfw and win32
 
+#define PLATFORM_MAP_PADDING 64 // zero bytes readable past the end of every map_file mapping, 4 SIMD blocks of over-read
+#define PLATFORM_READ_FILES_IN_FLIGHT 64 // io_uring queue depth for read_files_async
+#define PLATFORM_READ_FILES_THREADS 8 // fallback pool, reads block on IO rather than the cpu so it isn't tied to core count
+#define PLATFORM_COPY_BUFFER_SIZE MB(1) // copy_file when the kernel can't copy file to file itself
+
 namespace Platform {
     typedef void* DLL;
+    typedef void* Thread;
+    typedef void(ThreadFunction)(void* user_data);
+    // data is nullptr when error != ERROR_SUCCESS, otherwise the callback owns it (Memory::global_general_allocator)
+    typedef void(ReadFileCallback)(u64 file_index, u8* data, byte_t file_size, Error error, void* user_data);
+
+    /**
+     * A copy driven by copy_file_step, bytes_copied / total_bytes is the progress.
+     * total_bytes is the source size when the copy began, the copy still runs to the end of the source
+     * (files that grow, /proc files that report 0) and total_bytes follows bytes_copied once it is done.
+     * state is the platform side, it is released when the copy finishes, fails or is cancelled.
+     */
+    struct FileCopy {
+        byte_t bytes_copied = 0;
+        byte_t total_bytes = 0;
+        void* state = nullptr;
+    };
 
     bool initialize();
     void shutdown();
@@ -15,15 +36,78 @@ namespace Platform {
     double get_seconds_elapsed();
     bool file_path_exists(const char* path);
     /**
-     * @brief returns true if copy succeeded
+     * @brief returns true if copy succeeded, the data is copied inside the kernel where it can
+     * (copy_file_range, then sendfile, then PLATFORM_COPY_BUFFER_SIZE reads and writes) and the permissions come along.
+     * block_until_success retries every 10ms, for a source that is still being written (hot reload).
      * 
      * @param source_path 
      * @param dest_path 
      * @param block_until_success
      */
     bool copy_file(const char* source_path, const char* dest_path, bool block_until_success = true);
+    /**
+     * @brief the non-blocking form of copy_file, opens both files and leaves the copying to copy_file_step.
+     * Returns false and sets error if either file can't be opened, nothing is left to release then.
+     *
+     *     Platform::FileCopy copy;
+     *     if (Platform::copy_file_begin(&copy, source_path, dest_path, error)) {
+     *         while (Platform::copy_file_step(&copy, MB(8), error)) { report(copy.bytes_copied, copy.total_bytes); }
+     *     }
+     * 
+     * @param copy 
+     * @param source_path 
+     * @param dest_path 
+     * @param error
+     */
+    bool copy_file_begin(FileCopy* copy, const char* source_path, const char* dest_path, Error& error);
+    // Copies at most max_bytes (0 is the rest), true while there is more to copy. Once it returns false the copy
+    // is released and error says whether it finished.
+    bool copy_file_step(FileCopy* copy, byte_t max_bytes, Error& error);
+    // Stops a copy early and releases it, the destination keeps whatever was copied so far
+    void copy_file_cancel(FileCopy* copy);
     u8* read_entire_file(Memory::BaseAllocator* allocator, const char* file_path, byte_t& out_file_size, Error& error);
+    // Creates or truncates the file, returns false and sets error if it couldn't be fully written
+    bool write_entire_file(const char* file_path, const void* data, byte_t data_size, Error& error);
+    /**
+     * @brief maps the file read-only instead of copying it, nothing comes out of an allocator.
+     * The pages are hinted for sequential reads and at least PLATFORM_MAP_PADDING zero bytes follow the data,
+     * so scanners can load whole blocks past the end. An empty file maps to shared zero padding with out_file_size 0.
+     * Returns nullptr and sets error on failure, unmap_file needs the same file_size back.
+     * 
+     * @param file_path 
+     * @param out_file_size 
+     * @param error
+     */
+    u8* map_file(const char* file_path, byte_t& out_file_size, Error& error);
+    void unmap_file(u8* data, byte_t file_size);
     DLL load_dll(const char* dll_path, Error& error);
     DLL free_dll(DLL dll, Error& error);
     void* get_proc_address(DLL dll, const char* proc_name, Error& error);
+
+    /**
+     * @brief starts thread_func(user_data) on a new OS thread, returns nullptr and sets error if the OS refuses
+     * 
+     * @param thread_func 
+     * @param user_data 
+     * @param error
+     */
+    Thread create_thread(ThreadFunction* thread_func, void* user_data, Error& error);
+    // Waits for the thread to return and releases it
+    void join_thread(Thread thread);
+    u32 get_processor_count();
+    u32 get_process_id();
+
+    /**
+     * @brief reads many files with their opens and reads in flight together, and calls callback for each file as
+     * it completes (completion order, file_index says which), so work on the first file overlaps the rest of the IO.
+     * io_uring on Linux, a pool of PLATFORM_READ_FILES_THREADS blocking readers elsewhere or when io_uring is unavailable.
+     * Callbacks run one at a time on the calling thread, it returns once every file has been handed out.
+     * data is followed by PLATFORM_MAP_PADDING zero bytes like map_file.
+     * 
+     * @param file_paths 
+     * @param file_count 
+     * @param callback 
+     * @param user_data
+     */
+    void read_files_async(const char** file_paths, u64 file_count, ReadFileCallback* callback, void* user_data = nullptr);
 }
\ No newline at end of file
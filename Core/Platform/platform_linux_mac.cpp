@@ -1,4 +1,5 @@
 #include "platform.hpp"
+#include "platform_read_files.hpp"
 
 #if defined(PLATFORM_LINUX) || defined(PLATFORM_APPLE)
     #include "../Common/logger.hpp"
@@ -8,11 +9,43 @@
     #include <unistd.h>
     #include <dlfcn.h>
     #include <stdio.h>
+    #include <time.h>
+    #include <pthread.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <errno.h>
+
+    #if defined(PLATFORM_LINUX)
+        #include <sys/sendfile.h>
+    #endif
+
+    #if defined(PLATFORM_LINUX) && !defined(PLATFORM_NO_IO_URING)
+        #define PLATFORM_IO_URING
+        #include <linux/io_uring.h>
+        #include <sys/syscall.h>
+    #endif
 
     namespace Platform {
-        bool initialize() { return true; }
+        global double g_start_time = 0.0;
+
+        internal double monotonic_seconds() {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+
+            return (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000.0);
+        }
+
+        bool initialize() {
+            g_start_time = monotonic_seconds();
+            return true;
+        }
+
         void shutdown() {}
-        double get_seconds_elapsed() { return 0.0; }
+
+        double get_seconds_elapsed() {
+            return monotonic_seconds() - g_start_time;
+        }
 
         bool file_path_exists(const char* path) {
             FILE *fptr = fopen(path, "r");
@@ -26,41 +59,192 @@
             return true;
         }
 
-        int copy_file(const char* source_path, const char* dest_path, int block_until_success) {
-            const byte_t BUFFER_SIZE = 4096;
+        enum CopyMethod {
+            COPY_METHOD_COPY_FILE_RANGE, // in the kernel, reflinks or server side copies where the filesystem can
+            COPY_METHOD_SENDFILE,        // in the kernel, page cache to page cache
+            COPY_METHOD_BUFFER           // read and write through PLATFORM_COPY_BUFFER_SIZE
+        };
+
+        struct PosixFileCopy {
+            int source_fd;
+            int dest_fd;
+            CopyMethod method;
+            u8* buffer;
+        };
+
+        internal void release_file_copy(FileCopy* copy) {
+            PosixFileCopy* state = (PosixFileCopy*)copy->state;
+            if (state == nullptr) {
+                return;
+            }
+
+            close(state->source_fd);
+            close(state->dest_fd);
+            if (state->buffer) {
+                Memory::global_general_allocator.free(state->buffer);
+            }
 
+            Memory::global_general_allocator.free(state);
+            copy->state = nullptr;
+        }
+
+        // Every method moves the file offsets of both fds, so falling back halfway through picks up where it stopped.
+        // Returns the bytes copied, 0 at the end of the source, -1 with errno set on failure.
+        // Only read returning 0 is trusted as the end, the in kernel methods return 0 early on some filesystems
+        // and for files whose size isn't known up front (/proc), those fall back to the next method instead.
+        internal ssize_t copy_chunk(PosixFileCopy* state, byte_t count) {
             for (;;) {
-                FILE* in = fopen(source_path, "rb");
-                if (!in) {
-                    if (!block_until_success) return 0;
-                    sleep(10);
+                ssize_t bytes = -1;
+                #if defined(PLATFORM_LINUX)
+                    if (state->method == COPY_METHOD_COPY_FILE_RANGE) {
+                        bytes = copy_file_range(state->source_fd, nullptr, state->dest_fd, nullptr, (size_t)count, 0);
+                    } else if (state->method == COPY_METHOD_SENDFILE) {
+                        bytes = sendfile(state->dest_fd, state->source_fd, nullptr, (size_t)count);
+                    }
+                #endif
+
+                if (state->method == COPY_METHOD_BUFFER) {
+                    if (state->buffer == nullptr) {
+                        state->buffer = (u8*)Memory::global_general_allocator.malloc(PLATFORM_COPY_BUFFER_SIZE);
+                    }
+
+                    bytes = read(state->source_fd, state->buffer, (size_t)MIN(count, PLATFORM_COPY_BUFFER_SIZE));
+                    ssize_t written = 0;
+                    while (bytes > 0 && written < bytes) {
+                        ssize_t result = write(state->dest_fd, state->buffer + written, (size_t)(bytes - written));
+                        if (result < 0 && errno == EINTR) {
+                            continue;
+                        }
+
+                        if (result < 0) {
+                            return -1;
+                        }
+
+                        written += result;
+                    }
+                }
+
+                if (bytes == 0 && state->method != COPY_METHOD_BUFFER) {
+                    state->method = (CopyMethod)(state->method + 1);
                     continue;
                 }
 
-                FILE* out = fopen(dest_path, "wb");
-                if (!out) {
-                    fclose(in);
-                    if (!block_until_success) return 0;
-                    sleep(10);
+                if (bytes >= 0) {
+                    return bytes;
+                }
+
+                if (errno == EINTR) {
                     continue;
                 }
 
-                char buffer[BUFFER_SIZE];
-                byte_t bytes;
-                int success = 1;
+                // older kernels, cross filesystem copies before 5.3 and filesystems without support
+                bool unsupported = errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP;
+                if (unsupported && state->method != COPY_METHOD_BUFFER) {
+                    state->method = (CopyMethod)(state->method + 1);
+                    continue;
+                }
+
+                return -1;
+            }
+        }
+
+        // No logging in here, the blocking copy_file polls a source that may not be there yet
+        bool copy_file_begin(FileCopy* copy, const char* source_path, const char* dest_path, Error& error) {
+            RUNTIME_ASSERT(copy);
+            *copy = FileCopy();
+
+            int source_fd = open(source_path, O_RDONLY | O_CLOEXEC);
+            if (source_fd == -1) {
+                error = ERROR_RESOURCE_NOT_FOUND;
+                return false;
+            }
+
+            struct stat source_stat;
+            if (fstat(source_fd, &source_stat) != 0) {
+                error = ERROR_RESOURCE_NOT_FOUND;
+                close(source_fd);
+
+                return false;
+            }
+
+            // same permission bits, a copied executable or shared library stays loadable
+            int dest_fd = open(dest_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, source_stat.st_mode & 0777);
+            if (dest_fd == -1) {
+                error = ERROR_RESOURCE_NOT_FOUND;
+                close(source_fd);
+
+                return false;
+            }
+
+            fchmod(dest_fd, source_stat.st_mode & 0777); // O_CREAT ignores the mode of a file that already exists
+
+            PosixFileCopy* state = (PosixFileCopy*)Memory::global_general_allocator.malloc(sizeof(PosixFileCopy));
+            state->source_fd = source_fd;
+            state->dest_fd = dest_fd;
+            state->buffer = nullptr;
+            #if defined(PLATFORM_LINUX)
+                state->method = COPY_METHOD_COPY_FILE_RANGE;
+            #else
+                state->method = COPY_METHOD_BUFFER;
+            #endif
+
+            copy->total_bytes = (byte_t)source_stat.st_size;
+            copy->state = state;
+
+            return true;
+        }
+
+        bool copy_file_step(FileCopy* copy, byte_t max_bytes, Error& error) {
+            RUNTIME_ASSERT(copy && copy->state);
+            PosixFileCopy* state = (PosixFileCopy*)copy->state;
+
+            // the fstat size is only a hint, the copy ends when the source does
+            byte_t budget = max_bytes == 0 ? (byte_t)-1 : max_bytes;
+            while (budget > 0) {
+                ssize_t bytes = copy_chunk(state, MIN(budget, (byte_t)GB(1)));
+                if (bytes < 0) {
+                    error = errno == ENOSPC || errno == EDQUOT ? ERROR_RESOURCE_EXHAUSTED : ERROR_RESOURCE_NOT_FOUND;
+                    release_file_copy(copy);
+
+                    return false;
+                }
+
+                if (bytes == 0) {
+                    copy->total_bytes = copy->bytes_copied;
+                    release_file_copy(copy);
+
+                    return false;
+                }
 
-                while ((bytes = fread(buffer, 1, BUFFER_SIZE, in)) > 0) {
-                    if (fwrite(buffer, 1, bytes, out) != bytes) {
-                        success = 0;
-                        break;
+                copy->bytes_copied += (byte_t)bytes;
+                copy->total_bytes = MAX(copy->total_bytes, copy->bytes_copied);
+                budget -= MIN((byte_t)bytes, budget);
+            }
+
+            return true;
+        }
+
+        void copy_file_cancel(FileCopy* copy) {
+            RUNTIME_ASSERT(copy);
+            release_file_copy(copy);
+        }
+
+        bool copy_file(const char* source_path, const char* dest_path, bool block_until_success) {
+            for (;;) {
+                Error error = ERROR_SUCCESS;
+                FileCopy copy;
+                if (copy_file_begin(&copy, source_path, dest_path, error)) {
+                    while (copy_file_step(&copy, 0, error)) {}
+
+                    if (error == ERROR_SUCCESS) {
+                        return true;
                     }
                 }
 
-                fclose(in);
-                fclose(out);
+                if (!block_until_success) {
+                    return false;
+                }
 
-                if (success) return 1;
-                if (!block_until_success) return 0;
                 sleep(10);
             }
         }
@@ -119,6 +303,113 @@
             return file_data;
         }
 
+        bool write_entire_file(const char* file_path, const void* data, byte_t data_size, Error& error) {
+            FILE* file_handle = fopen(file_path, "wb");
+            if (file_handle == nullptr) {
+                LOG_ERROR("fopen() failed: write_entire_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_NOT_FOUND;
+
+                return false;
+            }
+
+            bool success = data_size == 0 || fwrite(data, data_size, 1, file_handle) == 1;
+            success = (fclose(file_handle) == 0) && success;
+            if (!success) {
+                LOG_ERROR("fwrite() failed: write_entire_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_EXHAUSTED;
+
+                return false;
+            }
+
+            return true;
+        }
+
+        global const u8 g_empty_mapping[PLATFORM_MAP_PADDING] = {0};
+
+        // bytes past the end of the file in its last page read as zero, only a file ending too close
+        // to a page boundary needs one more page behind it
+        internal byte_t mapping_size(byte_t file_size, bool* out_needs_padding_page) {
+            byte_t page_size = (byte_t)sysconf(_SC_PAGESIZE);
+            byte_t mapped_size = ((file_size + page_size - 1) / page_size) * page_size;
+            *out_needs_padding_page = mapped_size - file_size < PLATFORM_MAP_PADDING;
+
+            return *out_needs_padding_page ? mapped_size + page_size : mapped_size;
+        }
+
+        u8* map_file(const char* file_path, byte_t& out_file_size, Error& error) {
+            out_file_size = 0;
+
+            int fd = open(file_path, O_RDONLY);
+            if (fd == -1) {
+                LOG_ERROR("open() failed, the file_path is likely wrong: map_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_NOT_FOUND;
+
+                return nullptr;
+            }
+
+            struct stat file_stat;
+            if (fstat(fd, &file_stat) != 0) {
+                LOG_ERROR("fstat() failed: map_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_NOT_FOUND;
+                close(fd);
+
+                return nullptr;
+            }
+
+            byte_t file_size = (byte_t)file_stat.st_size;
+            if (file_size == 0) {
+                close(fd);
+
+                return (u8*)g_empty_mapping;
+            }
+
+            bool needs_padding_page = false;
+            byte_t total_size = mapping_size(file_size, &needs_padding_page);
+
+            // reserve zero pages for the whole range first, then put the file over the front of it
+            void* base = nullptr;
+            if (needs_padding_page) {
+                base = mmap(nullptr, (size_t)total_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (base == MAP_FAILED) {
+                    LOG_ERROR("mmap() failed to reserve padding: map_file(%s)\n", file_path);
+                    error = ERROR_RESOURCE_EXHAUSTED;
+                    close(fd);
+
+                    return nullptr;
+                }
+            }
+
+            // the mapping keeps its own reference to the file
+            int flags = needs_padding_page ? (MAP_PRIVATE | MAP_FIXED) : MAP_PRIVATE;
+            void* mapping = mmap(base, (size_t)file_size, PROT_READ, flags, fd, 0);
+            close(fd);
+            if (mapping == MAP_FAILED) {
+                LOG_ERROR("mmap() failed: map_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_EXHAUSTED;
+                if (base) {
+                    munmap(base, (size_t)total_size);
+                }
+
+                return nullptr;
+            }
+
+            // read-ahead more aggressively and drop pages behind the reader
+            madvise(mapping, (size_t)file_size, MADV_SEQUENTIAL);
+
+            out_file_size = file_size;
+
+            return (u8*)mapping;
+        }
+
+        void unmap_file(u8* data, byte_t file_size) {
+            if (data == nullptr || file_size == 0) {
+                return;
+            }
+
+            bool needs_padding_page = false;
+            munmap(data, (size_t)mapping_size(file_size, &needs_padding_page));
+        }
+
         DLL load_dll(const char* dll_path, Error& error)  {
             DLL library = dlopen(dll_path, RTLD_LAZY);
             if (!library) {
@@ -151,5 +442,389 @@
 
             return proc;
         }
+
+        struct PosixThread {
+            pthread_t handle;
+            ThreadFunction* thread_func;
+            void* user_data;
+        };
+
+        internal void* posix_thread_entry(void* parameter) {
+            PosixThread* thread = (PosixThread*)parameter;
+            thread->thread_func(thread->user_data);
+
+            return nullptr;
+        }
+
+        Thread create_thread(ThreadFunction* thread_func, void* user_data, Error& error) {
+            RUNTIME_ASSERT(thread_func);
+
+            PosixThread* thread = (PosixThread*)Memory::global_general_allocator.malloc(sizeof(PosixThread));
+            thread->thread_func = thread_func;
+            thread->user_data = user_data;
+
+            if (pthread_create(&thread->handle, nullptr, posix_thread_entry, thread) != 0) {
+                LOG_ERROR("pthread_create() failed: create_thread()\n");
+                error = ERROR_RESOURCE_EXHAUSTED;
+                Memory::global_general_allocator.free(thread);
+
+                return nullptr;
+            }
+
+            return thread;
+        }
+
+        void join_thread(Thread thread) {
+            RUNTIME_ASSERT(thread);
+
+            PosixThread* posix_thread = (PosixThread*)thread;
+            pthread_join(posix_thread->handle, nullptr);
+            Memory::global_general_allocator.free(posix_thread);
+        }
+
+        u32 get_processor_count() {
+            long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+            return count > 0 ? (u32)count : 1;
+        }
+
+        u32 get_process_id() {
+            return (u32)getpid();
+        }
+
+        ReadFileResult read_file_blocking(const char* file_path) {
+            ReadFileResult ret = {nullptr, 0, ERROR_SUCCESS};
+
+            int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+            if (fd == -1) {
+                LOG_ERROR("open() failed, the file_path is likely wrong: read_files_async(%s)\n", file_path);
+                ret.error = ERROR_RESOURCE_NOT_FOUND;
+
+                return ret;
+            }
+
+            struct stat file_stat;
+            if (fstat(fd, &file_stat) != 0) {
+                LOG_ERROR("fstat() failed: read_files_async(%s)\n", file_path);
+                ret.error = ERROR_RESOURCE_NOT_FOUND;
+                close(fd);
+
+                return ret;
+            }
+
+            byte_t file_size = (byte_t)file_stat.st_size;
+            u8* data = allocate_file_data(file_size);
+            byte_t bytes_read = 0;
+            while (bytes_read < file_size) {
+                ssize_t bytes = pread(fd, data + bytes_read, (size_t)(file_size - bytes_read), (off_t)bytes_read);
+                if (bytes < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if (bytes < 0) {
+                    LOG_ERROR("pread() failed: read_files_async(%s)\n", file_path);
+                    ret.error = ERROR_RESOURCE_NOT_FOUND;
+                    Memory::global_general_allocator.free(data);
+                    close(fd);
+
+                    return ret;
+                }
+
+                if (bytes == 0) {
+                    break; // the file shrank since fstat
+                }
+
+                bytes_read += (byte_t)bytes;
+            }
+
+            close(fd);
+            Memory::zero(data + bytes_read, PLATFORM_MAP_PADDING);
+
+            ret.data = data;
+            ret.file_size = bytes_read;
+
+            return ret;
+        }
+
+        #if defined(PLATFORM_IO_URING)
+            // raw syscalls, the three rings are shared memory with the kernel
+            struct IoUring {
+                int fd;
+                u32 entries;
+                u32 tail; // ours, published to *sq_tail on submit
+
+                u8* sq_ring;
+                byte_t sq_ring_size;
+                u8* cq_ring;
+                byte_t cq_ring_size;
+                io_uring_sqe* sqes;
+                byte_t sqes_size;
+
+                u32* sq_head;
+                u32* sq_tail;
+                u32* sq_mask;
+                u32* sq_array;
+                u32* cq_head;
+                u32* cq_tail;
+                u32* cq_mask;
+                io_uring_cqe* cqes;
+            };
+
+            internal bool io_uring_create(IoUring* ring, u32 entries) {
+                io_uring_params params;
+                Memory::zero(&params, sizeof(io_uring_params));
+
+                int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+                if (fd < 0) {
+                    return false; // old kernel, or seccomp/sysctl turned it off
+                }
+
+                // OPENAT and READ arrived in 5.6, FAST_POLL (5.7) is the closest feature bit that implies both
+                if ((params.features & IORING_FEAT_FAST_POLL) == 0) {
+                    close(fd);
+                    return false;
+                }
+
+                ring->fd = fd;
+                ring->entries = params.sq_entries;
+                ring->sq_ring_size = params.sq_off.array + (params.sq_entries * sizeof(u32));
+                ring->cq_ring_size = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+                ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+                bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single_mmap) {
+                    ring->sq_ring_size = MAX(ring->sq_ring_size, ring->cq_ring_size);
+                    ring->cq_ring_size = ring->sq_ring_size;
+                }
+
+                void* sq_ring = mmap(nullptr, (size_t)ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+                void* cq_ring = single_mmap ? sq_ring : mmap(nullptr, (size_t)ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+                void* sqes = mmap(nullptr, (size_t)ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+                if (sq_ring == MAP_FAILED || cq_ring == MAP_FAILED || sqes == MAP_FAILED) {
+                    if (sqes != MAP_FAILED) {
+                        munmap(sqes, (size_t)ring->sqes_size);
+                    }
+
+                    if (!single_mmap && cq_ring != MAP_FAILED) {
+                        munmap(cq_ring, (size_t)ring->cq_ring_size);
+                    }
+
+                    if (sq_ring != MAP_FAILED) {
+                        munmap(sq_ring, (size_t)ring->sq_ring_size);
+                    }
+
+                    close(fd);
+                    return false;
+                }
+
+                ring->sq_ring = (u8*)sq_ring;
+                ring->cq_ring = (u8*)cq_ring;
+                ring->sqes = (io_uring_sqe*)sqes;
+
+                ring->sq_head = (u32*)(ring->sq_ring + params.sq_off.head);
+                ring->sq_tail = (u32*)(ring->sq_ring + params.sq_off.tail);
+                ring->sq_mask = (u32*)(ring->sq_ring + params.sq_off.ring_mask);
+                ring->sq_array = (u32*)(ring->sq_ring + params.sq_off.array);
+                ring->cq_head = (u32*)(ring->cq_ring + params.cq_off.head);
+                ring->cq_tail = (u32*)(ring->cq_ring + params.cq_off.tail);
+                ring->cq_mask = (u32*)(ring->cq_ring + params.cq_off.ring_mask);
+                ring->cqes = (io_uring_cqe*)(ring->cq_ring + params.cq_off.cqes);
+                ring->tail = *ring->sq_tail;
+
+                return true;
+            }
+
+            internal void io_uring_destroy(IoUring* ring) {
+                munmap(ring->sqes, (size_t)ring->sqes_size);
+                if (ring->cq_ring != ring->sq_ring) {
+                    munmap(ring->cq_ring, (size_t)ring->cq_ring_size);
+                }
+
+                munmap(ring->sq_ring, (size_t)ring->sq_ring_size);
+                close(ring->fd);
+            }
+
+            // The caller keeps at most entries operations in flight, so there is always a free sqe
+            internal io_uring_sqe* io_uring_next_sqe(IoUring* ring) {
+                u32 index = ring->tail & *ring->sq_mask;
+                ring->tail += 1;
+
+                io_uring_sqe* sqe = &ring->sqes[index];
+                Memory::zero(sqe, sizeof(io_uring_sqe));
+                ring->sq_array[index] = index;
+
+                return sqe;
+            }
+
+            // Submits everything queued, with wait_for = 1 it also blocks until something completes
+            internal void io_uring_submit(IoUring* ring, u32 wait_for) {
+                __atomic_store_n(ring->sq_tail, ring->tail, __ATOMIC_RELEASE);
+
+                for (;;) {
+                    u32 unconsumed = ring->tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+                    if (unconsumed == 0 && wait_for == 0) {
+                        return;
+                    }
+
+                    long ret = syscall(__NR_io_uring_enter, ring->fd, unconsumed, wait_for, wait_for ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                    if (ret >= 0 || errno == EAGAIN || errno == EBUSY) {
+                        return; // busy means reap first, whatever is left goes out on the next submit
+                    }
+
+                    RUNTIME_ASSERT_MSG(errno == EINTR, "io_uring_enter() failed with errno %d\n", errno);
+                }
+            }
+
+            struct UringFile {
+                int fd; // -1 while the open is in flight
+                u8* data;
+                byte_t file_size;
+                byte_t bytes_read;
+                Error error;
+            };
+
+            internal void io_uring_queue_read(IoUring* ring, UringFile* file, u64 file_index) {
+                io_uring_sqe* sqe = io_uring_next_sqe(ring);
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = file->fd;
+                sqe->addr = (u64)(file->data + file->bytes_read);
+                sqe->len = (u32)MIN(file->file_size - file->bytes_read, (byte_t)GB(1));
+                sqe->off = file->bytes_read;
+                sqe->user_data = file_index;
+            }
+
+            internal void io_uring_queue_opens(IoUring* ring, const char** file_paths, u64 file_count, UringFile* files, u64* next_file, u64* in_flight) {
+                // one operation per file at a time, so the rings never overflow
+                while (*in_flight < ring->entries && *next_file < file_count) {
+                    u64 file_index = *next_file;
+                    files[file_index] = UringFile{-1, nullptr, 0, 0, ERROR_SUCCESS};
+
+                    io_uring_sqe* sqe = io_uring_next_sqe(ring);
+                    sqe->opcode = IORING_OP_OPENAT;
+                    sqe->fd = AT_FDCWD;
+                    sqe->addr = (u64)file_paths[file_index];
+                    sqe->open_flags = O_RDONLY | O_CLOEXEC;
+                    sqe->user_data = file_index;
+
+                    *next_file += 1;
+                    *in_flight += 1;
+                }
+            }
+
+            // Advances the file one step (open -> fstat -> reads), true once it is finished either way
+            internal bool io_uring_complete(IoUring* ring, const char* file_path, UringFile* file, u64 file_index, s32 result) {
+                if (file->fd == -1) {
+                    if (result < 0) {
+                        LOG_ERROR("openat failed, the file_path is likely wrong: read_files_async(%s)\n", file_path);
+                        file->error = ERROR_RESOURCE_NOT_FOUND;
+
+                        return true;
+                    }
+
+                    file->fd = result;
+
+                    // the inode is cached right after the open, a plain fstat doesn't block on the disk
+                    struct stat file_stat;
+                    if (fstat(file->fd, &file_stat) != 0) {
+                        LOG_ERROR("fstat() failed: read_files_async(%s)\n", file_path);
+                        file->error = ERROR_RESOURCE_NOT_FOUND;
+                        close(file->fd);
+
+                        return true;
+                    }
+
+                    file->file_size = (byte_t)file_stat.st_size;
+                    file->data = allocate_file_data(file->file_size);
+                } else if (result == -EINTR || result == -EAGAIN) {
+                    // retried below
+                } else if (result < 0) {
+                    LOG_ERROR("read failed: read_files_async(%s)\n", file_path);
+                    file->error = ERROR_RESOURCE_NOT_FOUND;
+                    Memory::global_general_allocator.free(file->data);
+                    file->data = nullptr;
+                    close(file->fd);
+
+                    return true;
+                } else if (result == 0) {
+                    file->file_size = file->bytes_read; // the file shrank since fstat
+                } else {
+                    file->bytes_read += (byte_t)result;
+                }
+
+                if (file->bytes_read < file->file_size) {
+                    io_uring_queue_read(ring, file, file_index);
+                    return false;
+                }
+
+                close(file->fd);
+                Memory::zero(file->data + file->file_size, PLATFORM_MAP_PADDING);
+
+                return true;
+            }
+
+            internal bool read_files_io_uring(const char** file_paths, u64 file_count, ReadFileCallback* callback, void* user_data) {
+                IoUring ring;
+                if (!io_uring_create(&ring, PLATFORM_READ_FILES_IN_FLIGHT)) {
+                    return false;
+                }
+
+                UringFile* files = (UringFile*)Memory::global_general_allocator.malloc(file_count * sizeof(UringFile));
+                u64* ready = (u64*)Memory::global_general_allocator.malloc(MIN(file_count, (u64)ring.entries) * sizeof(u64));
+                u64 next_file = 0;
+                u64 in_flight = 0;
+                u64 delivered = 0;
+
+                while (delivered < file_count) {
+                    io_uring_queue_opens(&ring, file_paths, file_count, files, &next_file, &in_flight);
+                    io_uring_submit(&ring, 1);
+
+                    u64 ready_count = 0;
+                    u32 head = *ring.cq_head;
+                    u32 tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+                    for (; head != tail; head++) {
+                        const io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+                        u64 file_index = cqe->user_data;
+                        if (io_uring_complete(&ring, file_paths[file_index], &files[file_index], file_index, cqe->res)) {
+                            ready[ready_count++] = file_index;
+                            in_flight -= 1;
+                        }
+                    }
+
+                    __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+
+                    // the reads and opens these completions made room for go out before the callbacks run
+                    io_uring_queue_opens(&ring, file_paths, file_count, files, &next_file, &in_flight);
+                    io_uring_submit(&ring, 0);
+
+                    for (u64 i = 0; i < ready_count; i++) {
+                        UringFile* file = &files[ready[i]];
+                        callback(ready[i], file->data, file->file_size, file->error, user_data);
+                    }
+
+                    delivered += ready_count;
+                }
+
+                Memory::global_general_allocator.free(files);
+                Memory::global_general_allocator.free(ready);
+                io_uring_destroy(&ring);
+
+                return true;
+            }
+        #endif
+
+        void read_files_async(const char** file_paths, u64 file_count, ReadFileCallback* callback, void* user_data) {
+            RUNTIME_ASSERT(callback);
+            if (file_count == 0) {
+                return;
+            }
+
+            #if defined(PLATFORM_IO_URING)
+                if (read_files_io_uring(file_paths, file_count, callback, user_data)) {
+                    return;
+                }
+            #endif
+
+            read_files_pool(file_paths, file_count, callback, user_data);
+        }
     }
 #endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "platform_read_files.hpp"
+
+#include "../Common/assert.hpp"
+
+#include <atomic>
+
+namespace Platform {
+    u8* allocate_file_data(byte_t file_size) {
+        u8* data = (u8*)Memory::global_general_allocator.malloc(file_size + PLATFORM_MAP_PADDING);
+        Memory::zero(data + file_size, PLATFORM_MAP_PADDING);
+
+        return data;
+    }
+
+    struct ReadFilesPool {
+        const char** file_paths;
+        u64 file_count;
+        ReadFileResult* results;
+        u64* completed; // file indices + 1 in completion order, 0 is a slot nobody has written yet
+        std::atomic<u64> next_file;
+        std::atomic<u64> next_slot;
+        std::atomic<u64> published;
+    };
+
+    internal void read_files_worker(void* user_data) {
+        ReadFilesPool* pool = (ReadFilesPool*)user_data;
+
+        for (;;) {
+            u64 file_index = pool->next_file.fetch_add(1);
+            if (file_index >= pool->file_count) {
+                return;
+            }
+
+            pool->results[file_index] = read_file_blocking(pool->file_paths[file_index]);
+
+            u64 slot = pool->next_slot.fetch_add(1);
+            std::atomic_ref<u64>(pool->completed[slot]).store(file_index + 1, std::memory_order_release);
+            pool->published.fetch_add(1, std::memory_order_release);
+            pool->published.notify_one();
+        }
+    }
+
+    void read_files_pool(const char** file_paths, u64 file_count, ReadFileCallback* callback, void* user_data) {
+        ReadFilesPool pool;
+        pool.file_paths = file_paths;
+        pool.file_count = file_count;
+        pool.results = (ReadFileResult*)Memory::global_general_allocator.malloc(file_count * sizeof(ReadFileResult));
+        pool.completed = (u64*)Memory::global_general_allocator.malloc(file_count * sizeof(u64));
+        Memory::zero(pool.completed, file_count * sizeof(u64));
+
+        Thread threads[PLATFORM_READ_FILES_THREADS];
+        u32 thread_count = 0;
+        u32 wanted = (u32)MIN(file_count, (u64)PLATFORM_READ_FILES_THREADS);
+        for (u32 i = 0; i < wanted; i++) {
+            Error error = ERROR_SUCCESS;
+            Thread thread = create_thread(read_files_worker, &pool, error);
+            if (!thread) {
+                break;
+            }
+
+            threads[thread_count++] = thread;
+        }
+
+        // without any thread the reads happen right here and the loop below only hands them out
+        if (thread_count == 0) {
+            read_files_worker(&pool);
+        }
+
+        for (u64 slot = 0; slot < file_count; slot++) {
+            std::atomic_ref<u64> entry = std::atomic_ref<u64>(pool.completed[slot]);
+            u64 seen = pool.published.load(std::memory_order_acquire);
+            u64 completed = entry.load(std::memory_order_acquire);
+            while (completed == 0) {
+                pool.published.wait(seen, std::memory_order_acquire);
+                seen = pool.published.load(std::memory_order_acquire);
+                completed = entry.load(std::memory_order_acquire);
+            }
+
+            ReadFileResult result = pool.results[completed - 1];
+            callback(completed - 1, result.data, result.file_size, result.error, user_data);
+        }
+
+        for (u32 i = 0; i < thread_count; i++) {
+            join_thread(threads[i]);
+        }
+
+        Memory::global_general_allocator.free(pool.results);
+        Memory::global_general_allocator.free(pool.completed);
+    }
+}
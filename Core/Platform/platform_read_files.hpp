@@ -0,0 +1,23 @@
+#pragma once
+
+#include "platform.hpp"
+
+// Shared by the platform files, not part of the public Platform api.
+// The thread pool fallback of read_files_async lives in platform_read_files.cpp,
+// each platform only provides read_file_blocking and its own async submission (io_uring on linux).
+namespace Platform {
+    struct ReadFileResult {
+        u8* data;
+        byte_t file_size;
+        Error error;
+    };
+
+    // padded like map_file so the same scanners work on both
+    u8* allocate_file_data(byte_t file_size);
+
+    // Defined per platform, reads one whole file on the calling thread into allocate_file_data memory
+    ReadFileResult read_file_blocking(const char* file_path);
+
+    // Reads on up to PLATFORM_READ_FILES_THREADS threads, the callback runs on the calling thread in completion order
+    void read_files_pool(const char** file_paths, u64 file_count, ReadFileCallback* callback, void* user_data);
+}
@@ -1,4 +1,5 @@
 #include "platform.hpp"
+#include "platform_read_files.hpp"
 
 #if defined(PLATFORM_WINDOWS)
     #define NOMINMAX
@@ -44,6 +45,7 @@
             return (GetFileAttributesA(path) != INVALID_FILE_ATTRIBUTES);
         }
 
+        // CopyFileA already copies inside the kernel (and offloads to the storage where it can)
         bool copy_file(const char* source_path, const char* dest_path, bool block_until_success) {
             if (block_until_success) {
                 while (!CopyFileA(source_path, dest_path, FALSE)) {
@@ -53,7 +55,109 @@
                 return true;
             } 
 
-            return CopyFileA(source_path, dest_path, FALSE) == 0;
+            return CopyFileA(source_path, dest_path, FALSE) != 0;
+        }
+
+        struct Win32FileCopy {
+            HANDLE source_handle;
+            HANDLE dest_handle;
+            u8* buffer;
+        };
+
+        internal void release_file_copy(FileCopy* copy) {
+            Win32FileCopy* state = (Win32FileCopy*)copy->state;
+            if (state == nullptr) {
+                return;
+            }
+
+            CloseHandle(state->source_handle);
+            CloseHandle(state->dest_handle);
+            Memory::global_general_allocator.free(state->buffer);
+            Memory::global_general_allocator.free(state);
+            copy->state = nullptr;
+        }
+
+        bool copy_file_begin(FileCopy* copy, const char* source_path, const char* dest_path, Error& error) {
+            RUNTIME_ASSERT(copy);
+            *copy = FileCopy();
+
+            HANDLE source_handle = CreateFileA(source_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (source_handle == INVALID_HANDLE_VALUE) {
+                error = ERROR_RESOURCE_NOT_FOUND;
+                return false;
+            }
+
+            LARGE_INTEGER large_int;
+            Memory::zero(&large_int, sizeof(LARGE_INTEGER));
+            if (!GetFileSizeEx(source_handle, &large_int)) {
+                error = ERROR_RESOURCE_NOT_FOUND;
+                CloseHandle(source_handle);
+
+                return false;
+            }
+
+            // same attributes as the source, like CopyFileA
+            DWORD attributes = GetFileAttributesA(source_path);
+            HANDLE dest_handle = CreateFileA(dest_path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, attributes != INVALID_FILE_ATTRIBUTES ? attributes : FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (dest_handle == INVALID_HANDLE_VALUE) {
+                error = ERROR_RESOURCE_NOT_FOUND;
+                CloseHandle(source_handle);
+
+                return false;
+            }
+
+            Win32FileCopy* state = (Win32FileCopy*)Memory::global_general_allocator.malloc(sizeof(Win32FileCopy));
+            state->source_handle = source_handle;
+            state->dest_handle = dest_handle;
+            state->buffer = (u8*)Memory::global_general_allocator.malloc(PLATFORM_COPY_BUFFER_SIZE);
+
+            copy->total_bytes = (byte_t)large_int.QuadPart;
+            copy->state = state;
+
+            return true;
+        }
+
+        bool copy_file_step(FileCopy* copy, byte_t max_bytes, Error& error) {
+            RUNTIME_ASSERT(copy && copy->state);
+            Win32FileCopy* state = (Win32FileCopy*)copy->state;
+
+            // the GetFileSizeEx size is only a hint, the copy ends when ReadFile hits the end of the source
+            byte_t budget = max_bytes == 0 ? (byte_t)-1 : max_bytes;
+            while (budget > 0) {
+                DWORD bytes_read = 0;
+                if (!ReadFile(state->source_handle, state->buffer, (DWORD)MIN(budget, PLATFORM_COPY_BUFFER_SIZE), &bytes_read, nullptr)) {
+                    error = ERROR_RESOURCE_NOT_FOUND;
+                    release_file_copy(copy);
+
+                    return false;
+                }
+
+                if (bytes_read == 0) {
+                    copy->total_bytes = copy->bytes_copied;
+                    release_file_copy(copy);
+
+                    return false;
+                }
+
+                DWORD bytes_written = 0;
+                if (!WriteFile(state->dest_handle, state->buffer, bytes_read, &bytes_written, nullptr) || bytes_written != bytes_read) {
+                    error = ERROR_RESOURCE_EXHAUSTED;
+                    release_file_copy(copy);
+
+                    return false;
+                }
+
+                copy->bytes_copied += bytes_read;
+                copy->total_bytes = MAX(copy->total_bytes, copy->bytes_copied);
+                budget -= MIN((byte_t)bytes_read, budget);
+            }
+
+            return true;
+        }
+
+        void copy_file_cancel(FileCopy* copy) {
+            RUNTIME_ASSERT(copy);
+            release_file_copy(copy);
         }
 
         void sleep(u32 ms) {
@@ -127,6 +231,126 @@
             return file_data;
         }
 
+        bool write_entire_file(const char* file_path, const void* data, byte_t data_size, Error& error) {
+            HANDLE file_handle = CreateFileA(file_path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_handle == INVALID_HANDLE_VALUE) {
+                LOG_ERROR("CreateFileA() returned an INVALID_HANDLE_VALUE: write_entire_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_NOT_FOUND;
+
+                return false;
+            }
+
+            DWORD bytes_written = 0;
+            BOOL success = data_size <= MAXDWORD && WriteFile(file_handle, data, (DWORD)data_size, &bytes_written, nullptr);
+            CloseHandle(file_handle);
+            if (!success || bytes_written != data_size) {
+                LOG_ERROR("WriteFile() failed or wrote less than data_size: write_entire_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_EXHAUSTED;
+
+                return false;
+            }
+
+            return true;
+        }
+
+        global const u8 g_empty_mapping[PLATFORM_MAP_PADDING] = {0};
+
+        // the view is zero filled to the end of its last page, a file ending closer than
+        // PLATFORM_MAP_PADDING to a page boundary is read into a padded copy instead
+        internal bool needs_padded_copy(byte_t file_size) {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            byte_t page_size = (byte_t)info.dwPageSize;
+            byte_t tail = file_size % page_size;
+
+            return tail == 0 || page_size - tail < PLATFORM_MAP_PADDING;
+        }
+
+        u8* map_file(const char* file_path, byte_t& out_file_size, Error& error) {
+            out_file_size = 0;
+
+            HANDLE file_handle = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file_handle == INVALID_HANDLE_VALUE) {
+                LOG_ERROR("CreateFileA() returned an INVALID_HANDLE_VALUE, the file_path is likely wrong: map_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_NOT_FOUND;
+
+                return nullptr;
+            }
+
+            LARGE_INTEGER large_int;
+            Memory::zero(&large_int, sizeof(LARGE_INTEGER));
+            if (!GetFileSizeEx(file_handle, &large_int)) {
+                LOG_ERROR("GetFileSizeEx() Failed to get size from file_handle: map_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_NOT_FOUND;
+                CloseHandle(file_handle);
+
+                return nullptr;
+            }
+
+            byte_t file_size = (byte_t)large_int.QuadPart;
+            if (file_size == 0) {
+                CloseHandle(file_handle);
+
+                return (u8*)g_empty_mapping;
+            }
+
+            if (needs_padded_copy(file_size)) {
+                // VirtualAlloc hands back zeroed pages, so the padding is already there
+                u8* copy = (u8*)VirtualAlloc(nullptr, file_size + PLATFORM_MAP_PADDING, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+                DWORD bytes_read = 0;
+                BOOL success = copy && file_size <= MAXDWORD && ReadFile(file_handle, copy, (DWORD)file_size, &bytes_read, nullptr);
+                CloseHandle(file_handle);
+                if (!success || bytes_read != file_size) {
+                    LOG_ERROR("ReadFile() Failed to read the padded copy: map_file(%s)\n", file_path);
+                    error = ERROR_RESOURCE_EXHAUSTED;
+                    if (copy) {
+                        VirtualFree(copy, 0, MEM_RELEASE);
+                    }
+
+                    return nullptr;
+                }
+
+                out_file_size = file_size;
+
+                return copy;
+            }
+
+            // the view keeps the mapping and the file alive, both handles can go right away
+            HANDLE mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file_handle);
+            if (!mapping_handle) {
+                LOG_ERROR("CreateFileMappingA() failed: map_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_EXHAUSTED;
+
+                return nullptr;
+            }
+
+            void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping_handle);
+            if (!view) {
+                LOG_ERROR("MapViewOfFile() failed: map_file(%s)\n", file_path);
+                error = ERROR_RESOURCE_EXHAUSTED;
+
+                return nullptr;
+            }
+
+            out_file_size = file_size;
+
+            return (u8*)view;
+        }
+
+        void unmap_file(u8* data, byte_t file_size) {
+            if (data == nullptr || file_size == 0) {
+                return;
+            }
+
+            if (needs_padded_copy(file_size)) {
+                VirtualFree(data, 0, MEM_RELEASE);
+            } else {
+                UnmapViewOfFile(data);
+            }
+        }
+
         DLL load_dll(const char* dll_path, Error& error)  {
             HMODULE library = LoadLibraryA(dll_path);
             if (!library) {
@@ -158,5 +382,126 @@
 
             return proc;
         }
+
+        struct Win32Thread {
+            HANDLE handle;
+            ThreadFunction* thread_func;
+            void* user_data;
+        };
+
+        internal DWORD WINAPI win32_thread_entry(LPVOID parameter) {
+            Win32Thread* thread = (Win32Thread*)parameter;
+            thread->thread_func(thread->user_data);
+
+            return 0;
+        }
+
+        Thread create_thread(ThreadFunction* thread_func, void* user_data, Error& error) {
+            RUNTIME_ASSERT(thread_func);
+
+            Win32Thread* thread = (Win32Thread*)Memory::global_general_allocator.malloc(sizeof(Win32Thread));
+            thread->thread_func = thread_func;
+            thread->user_data = user_data;
+
+            thread->handle = CreateThread(nullptr, 0, win32_thread_entry, thread, 0, nullptr);
+            if (!thread->handle) {
+                LOG_ERROR("CreateThread() failed: create_thread()\n");
+                error = ERROR_RESOURCE_EXHAUSTED;
+                Memory::global_general_allocator.free(thread);
+
+                return nullptr;
+            }
+
+            return thread;
+        }
+
+        void join_thread(Thread thread) {
+            RUNTIME_ASSERT(thread);
+
+            Win32Thread* win32_thread = (Win32Thread*)thread;
+            WaitForSingleObject(win32_thread->handle, INFINITE);
+            CloseHandle(win32_thread->handle);
+            Memory::global_general_allocator.free(win32_thread);
+        }
+
+        u32 get_processor_count() {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+
+            return info.dwNumberOfProcessors > 0 ? (u32)info.dwNumberOfProcessors : 1;
+        }
+
+        u32 get_process_id() {
+            return (u32)GetCurrentProcessId();
+        }
+
+        ReadFileResult read_file_blocking(const char* file_path) {
+            ReadFileResult ret = {nullptr, 0, ERROR_SUCCESS};
+
+            HANDLE file_handle = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file_handle == INVALID_HANDLE_VALUE) {
+                LOG_ERROR("CreateFileA() returned an INVALID_HANDLE_VALUE, the file_path is likely wrong: read_files_async(%s)\n", file_path);
+                ret.error = ERROR_RESOURCE_NOT_FOUND;
+
+                return ret;
+            }
+
+            LARGE_INTEGER large_int;
+            Memory::zero(&large_int, sizeof(LARGE_INTEGER));
+            if (!GetFileSizeEx(file_handle, &large_int)) {
+                LOG_ERROR("GetFileSizeEx() failed: read_files_async(%s)\n", file_path);
+                ret.error = ERROR_RESOURCE_NOT_FOUND;
+                CloseHandle(file_handle);
+
+                return ret;
+            }
+
+            // ReadFile can return less than asked for (network shares, files over 4 GB), so read until EOF
+            byte_t file_size = (byte_t)large_int.QuadPart;
+            u8* data = allocate_file_data(file_size);
+            byte_t bytes_read = 0;
+            while (bytes_read < file_size) {
+                DWORD bytes = 0;
+                DWORD bytes_wanted = (DWORD)MIN(file_size - bytes_read, (byte_t)MAXDWORD);
+                if (!ReadFile(file_handle, data + bytes_read, bytes_wanted, &bytes, nullptr)) {
+                    LOG_ERROR("ReadFile() failed: read_files_async(%s)\n", file_path);
+                    ret.error = ERROR_RESOURCE_NOT_FOUND;
+                    Memory::global_general_allocator.free(data);
+                    CloseHandle(file_handle);
+
+                    return ret;
+                }
+
+                if (bytes == 0) {
+                    break;
+                }
+
+                bytes_read += (byte_t)bytes;
+            }
+
+            CloseHandle(file_handle);
+            if (bytes_read != file_size) {
+                LOG_ERROR("ReadFile() stopped after %llu of %llu bytes: read_files_async(%s)\n", (unsigned long long)bytes_read, (unsigned long long)file_size, file_path);
+                ret.error = ERROR_RESOURCE_NOT_FOUND;
+                Memory::global_general_allocator.free(data);
+
+                return ret;
+            }
+
+            ret.data = data;
+            ret.file_size = file_size;
+
+            return ret;
+        }
+
+        // IOCP would be the io_uring counterpart, the pool already keeps PLATFORM_READ_FILES_THREADS reads in flight
+        void read_files_async(const char** file_paths, u64 file_count, ReadFileCallback* callback, void* user_data) {
+            RUNTIME_ASSERT(callback);
+            if (file_count == 0) {
+                return;
+            }
+
+            read_files_pool(file_paths, file_count, callback, user_data);
+        }
     }
 #endif
\ No newline at end of file
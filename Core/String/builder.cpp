@@ -0,0 +1,173 @@
+#include "builder.hpp"
+#include "string.hpp"
+
+#include <cstdio>
+
+namespace String {
+    Builder::Builder(Memory::BaseAllocator* allocator, u64 capacity) {
+        RUNTIME_ASSERT(allocator);
+
+        this->m_allocator = allocator;
+        this->reserve(capacity > 0 ? capacity : STRING_BUILDER_DEFAULT_CAPACITY);
+    }
+
+    Builder::~Builder() {
+        if (this->m_allocator && this->m_data) {
+            this->m_allocator->free(this->m_data);
+        }
+
+        this->m_data = nullptr;
+        this->m_length = 0;
+        this->m_capacity = 0;
+    }
+
+    void Builder::append(DS::View<char> str) {
+        this->append(str.data, str.length);
+    }
+
+    void Builder::append(const char* str, u64 str_length) {
+        if (str_length == 0) {
+            return;
+        }
+
+        RUNTIME_ASSERT(str);
+
+        // str can be a view of this builder, growing reallocates the bytes it points at
+        bool aliased = str >= this->m_data && str <= this->m_data + this->m_capacity;
+        u64 alias_offset = (u64)(str - this->m_data);
+        this->ensure_available(str_length);
+        if (aliased) {
+            str = this->m_data + alias_offset;
+        }
+
+        Memory::copy(this->m_data + this->m_length, this->m_capacity - this->m_length, str, str_length);
+        this->m_length += str_length;
+        this->m_data[this->m_length] = '\0';
+    }
+
+    void Builder::append(const char* c_string) {
+        this->append(c_string, String::length(c_string));
+    }
+
+    void Builder::append_char(char c) {
+        this->ensure_available(1);
+
+        this->m_data[this->m_length] = c;
+        this->m_length += 1;
+        this->m_data[this->m_length] = '\0';
+    }
+
+    void Builder::appendf(const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+            this->appendf(fmt, args);
+        va_end(args);
+    }
+
+    void Builder::appendf(const char* fmt, va_list args) {
+        // Format straight into the free space, only retry when it didn't fit
+        u64 available = this->m_capacity - this->m_length;
+
+        va_list args_copy;
+        va_copy(args_copy, args);
+        int required = vsnprintf(this->m_data + this->m_length, available + 1, fmt, args_copy); // +1 for null terminator
+        va_end(args_copy);
+
+        RUNTIME_ASSERT_MSG(required >= 0, "Builder::appendf invalid format: %s\n", fmt);
+        if ((u64)required > available) {
+            this->ensure_available((u64)required);
+
+            va_copy(args_copy, args);
+            vsnprintf(this->m_data + this->m_length, (u64)required + 1, fmt, args_copy);
+            va_end(args_copy);
+        }
+
+        this->m_length += (u64)required;
+    }
+
+    void Builder::append_int(s64 value) {
+        this->ensure_available(STRING_FORMAT_INT_BUFFER_SIZE);
+
+        this->m_length += String::format_int(value, this->m_data + this->m_length, this->m_capacity - this->m_length + 1);
+    }
+
+    void Builder::append_float(float value) {
+        this->ensure_available(STRING_FORMAT_FLOAT_BUFFER_SIZE);
+
+        this->m_length += String::format_float(value, this->m_data + this->m_length, this->m_capacity - this->m_length + 1);
+    }
+
+    void Builder::indent(u64 count) {
+        this->ensure_available(count);
+
+        for (u64 i = 0; i < count; i++) {
+            this->m_data[this->m_length + i] = ' ';
+        }
+
+        this->m_length += count;
+        this->m_data[this->m_length] = '\0';
+    }
+
+    void Builder::reserve(u64 capacity) {
+        if (capacity <= this->m_capacity && this->m_data) {
+            return;
+        }
+
+        byte_t old_allocation_size = this->m_data ? this->m_capacity + 1 : 0;
+        byte_t new_allocation_size = capacity + 1;
+        if (this->m_data) {
+            this->m_data = (char*)this->m_allocator->realloc(this->m_data, old_allocation_size, new_allocation_size);
+        } else {
+            this->m_data = (char*)this->m_allocator->malloc(new_allocation_size);
+        }
+
+        this->m_capacity = capacity;
+        this->m_data[this->m_length] = '\0';
+    }
+
+    void Builder::clear() {
+        this->m_length = 0;
+        this->m_data[0] = '\0';
+    }
+
+    u64 Builder::length() const {
+        return this->m_length;
+    }
+
+    u64 Builder::capacity() const {
+        return this->m_capacity;
+    }
+
+    const char* Builder::c_str() const {
+        return this->m_data;
+    }
+
+    DS::View<char> Builder::view() const {
+        return DS::View<char>(this->m_data, this->m_length);
+    }
+
+    char* Builder::release() {
+        char* ret = this->m_data;
+
+        this->m_data = nullptr;
+        this->m_length = 0;
+        this->m_capacity = 0;
+        this->reserve(STRING_BUILDER_DEFAULT_CAPACITY);
+
+        return ret;
+    }
+
+    void Builder::ensure_available(u64 count) {
+        u64 required = this->m_length + count;
+        if (required <= this->m_capacity) {
+            return;
+        }
+
+        u64 new_capacity = this->m_capacity * 2;
+        while (new_capacity < required) {
+            new_capacity *= 2;
+        }
+
+        this->reserve(new_capacity);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../Common/common.hpp"
+#include "../Memory/memory.hpp"
+#include "../DataStructure/ds.hpp"
+
+#include <cstdarg>
+
+#define STRING_BUILDER_DEFAULT_CAPACITY 64
+
+namespace String {
+    /**
+     * Growable string buffer, every append is amortized O(1) because the capacity doubles.
+     * The buffer is always null terminated so c_str() never copies.
+     */
+    struct Builder {
+        Builder(Memory::BaseAllocator* allocator, u64 capacity = STRING_BUILDER_DEFAULT_CAPACITY);
+        ~Builder();
+
+        // Prevent copy
+        Builder(const Builder& other) = delete;
+        Builder& operator=(const Builder& other) = delete;
+
+        void append(DS::View<char> str);
+        void append(const char* str, u64 str_length);
+        void append(const char* c_string);
+        void append_char(char c);
+        void appendf(const char* fmt, ...);
+        void appendf(const char* fmt, va_list args);
+
+        // Numbers are formatted in place, no varargs or temporary buffers
+        void append_int(s64 value);
+        void append_float(float value);
+
+        // Appends count spaces
+        void indent(u64 count);
+
+        void reserve(u64 capacity);
+        void clear();
+
+        u64 length() const;
+        u64 capacity() const;
+        const char* c_str() const;
+        DS::View<char> view() const;
+
+        // Hands the buffer to the caller (free it with the builder's allocator), the builder is left empty
+        char* release();
+
+    private:
+        Memory::BaseAllocator* m_allocator = nullptr;
+        char* m_data = nullptr;
+        u64 m_length = 0;
+        u64 m_capacity = 0; // excludes the null terminator
+
+        void ensure_available(u64 count);
+    };
+}
@@ -0,0 +1,376 @@
+#include "string.hpp"
+
+// Integer formatting writes two digits per step from a lookup table.
+// format_float is Ryu (Ulf Adams, "Ryu: Fast Float-to-String Conversion", PLDI 2018) for binary32,
+// it finds the shortest decimal that reads back as the exact same float.
+// https://github.com/ulfjack/ryu
+
+#define FLOAT_MANTISSA_BITS 23
+#define FLOAT_EXPONENT_BITS 8
+#define FLOAT_BIAS 127
+#define FLOAT_POW5_INV_BITCOUNT 59
+#define FLOAT_POW5_BITCOUNT 61
+
+namespace String {
+    internal const char DIGIT_PAIRS[201] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    internal inline u32 decimal_digit_count(u64 value) {
+        u32 count = 1;
+        while (value >= 10000) {
+            value /= 10000;
+            count += 4;
+        }
+
+        if (value >= 1000) {
+            return count + 3;
+        } else if (value >= 100) {
+            return count + 2;
+        } else if (value >= 10) {
+            return count + 1;
+        }
+
+        return count;
+    }
+
+    // Writes exactly digit_count digits ending at end (exclusive)
+    internal inline void write_digits_backwards(char* end, u64 value, u32 digit_count) {
+        char* cursor = end;
+        while (value >= 100) {
+            u64 pair = (value % 100) * 2;
+            value /= 100;
+            cursor -= 2;
+            cursor[0] = DIGIT_PAIRS[pair];
+            cursor[1] = DIGIT_PAIRS[pair + 1];
+        }
+
+        if (value >= 10) {
+            u64 pair = value * 2;
+            cursor -= 2;
+            cursor[0] = DIGIT_PAIRS[pair];
+            cursor[1] = DIGIT_PAIRS[pair + 1];
+        } else {
+            cursor -= 1;
+            cursor[0] = (char)('0' + value);
+        }
+
+        RUNTIME_ASSERT(cursor == end - digit_count);
+    }
+
+    u64 format_u64(u64 value, char* buffer, u64 buffer_capacity) {
+        RUNTIME_ASSERT(buffer);
+
+        u32 length = decimal_digit_count(value);
+        RUNTIME_ASSERT_MSG(length < buffer_capacity, "format_u64: buffer_capacity %llu is too small\n", (unsigned long long)buffer_capacity);
+
+        write_digits_backwards(buffer + length, value, length);
+        buffer[length] = '\0';
+
+        return length;
+    }
+
+    u64 format_int(s64 value, char* buffer, u64 buffer_capacity) {
+        RUNTIME_ASSERT(buffer);
+
+        if (value >= 0) {
+            return format_u64((u64)value, buffer, buffer_capacity);
+        }
+
+        RUNTIME_ASSERT_MSG(buffer_capacity > 1, "format_int: buffer_capacity %llu is too small\n", (unsigned long long)buffer_capacity);
+        buffer[0] = '-';
+
+        // 0 - value in unsigned math so S64_MIN doesn't overflow
+        return 1 + format_u64(0 - (u64)value, buffer + 1, buffer_capacity - 1);
+    }
+
+    u64 format_hex(u64 value, char* buffer, u64 buffer_capacity) {
+        RUNTIME_ASSERT(buffer);
+        local_persist const char HEX_DIGITS[] = "0123456789abcdef";
+
+        u32 length = 1;
+        for (u64 remaining = value >> 4; remaining != 0; remaining >>= 4) {
+            length += 1;
+        }
+        RUNTIME_ASSERT_MSG(length < buffer_capacity, "format_hex: buffer_capacity %llu is too small\n", (unsigned long long)buffer_capacity);
+
+        for (u32 i = 0; i < length; i++) {
+            buffer[length - 1 - i] = HEX_DIGITS[(value >> (i * 4)) & 0xF];
+        }
+        buffer[length] = '\0';
+
+        return length;
+    }
+
+    // ceil(2^(pow5_bits(i) - 1 + FLOAT_POW5_INV_BITCOUNT) / 5^i)
+    internal const u64 FLOAT_POW5_INV_SPLIT[31] = {
+        576460752303423489ULL, 461168601842738791ULL, 368934881474191033ULL, 295147905179352826ULL,
+        472236648286964522ULL, 377789318629571618ULL, 302231454903657294ULL, 483570327845851670ULL,
+        386856262276681336ULL, 309485009821345069ULL, 495176015714152110ULL, 396140812571321688ULL,
+        316912650057057351ULL, 507060240091291761ULL, 405648192073033409ULL, 324518553658426727ULL,
+        519229685853482763ULL, 415383748682786211ULL, 332306998946228969ULL, 531691198313966350ULL,
+        425352958651173080ULL, 340282366920938464ULL, 544451787073501542ULL, 435561429658801234ULL,
+        348449143727040987ULL, 557518629963265579ULL, 446014903970612463ULL, 356811923176489971ULL,
+        570899077082383953ULL, 456719261665907162ULL, 365375409332725730ULL,
+    };
+
+    // 5^i normalized to FLOAT_POW5_BITCOUNT bits
+    internal const u64 FLOAT_POW5_SPLIT[47] = {
+        1152921504606846976ULL, 1441151880758558720ULL, 1801439850948198400ULL, 2251799813685248000ULL,
+        1407374883553280000ULL, 1759218604441600000ULL, 2199023255552000000ULL, 1374389534720000000ULL,
+        1717986918400000000ULL, 2147483648000000000ULL, 1342177280000000000ULL, 1677721600000000000ULL,
+        2097152000000000000ULL, 1310720000000000000ULL, 1638400000000000000ULL, 2048000000000000000ULL,
+        1280000000000000000ULL, 1600000000000000000ULL, 2000000000000000000ULL, 1250000000000000000ULL,
+        1562500000000000000ULL, 1953125000000000000ULL, 1220703125000000000ULL, 1525878906250000000ULL,
+        1907348632812500000ULL, 1192092895507812500ULL, 1490116119384765625ULL, 1862645149230957031ULL,
+        1164153218269348144ULL, 1455191522836685180ULL, 1818989403545856475ULL, 2273736754432320594ULL,
+        1421085471520200371ULL, 1776356839400250464ULL, 2220446049250313080ULL, 1387778780781445675ULL,
+        1734723475976807094ULL, 2168404344971008868ULL, 1355252715606880542ULL, 1694065894508600678ULL,
+        2117582368135750847ULL, 1323488980084844279ULL, 1654361225106055349ULL, 2067951531382569187ULL,
+        1292469707114105741ULL, 1615587133892632177ULL, 2019483917365790221ULL,
+    };
+
+    internal inline s32 pow5_bits(s32 e) {
+        return (s32)((((u32)e) * 1217359) >> 19) + 1;
+    }
+
+    internal inline u32 log10_pow2(s32 e) {
+        return (((u32)e) * 78913) >> 18;
+    }
+
+    internal inline u32 log10_pow5(s32 e) {
+        return (((u32)e) * 732923) >> 20;
+    }
+
+    internal inline bool multiple_of_power_of_5(u32 value, u32 p) {
+        u32 count = 0;
+        while (value % 5 == 0) {
+            value /= 5;
+            count += 1;
+        }
+
+        return count >= p;
+    }
+
+    internal inline bool multiple_of_power_of_2(u32 value, u32 p) {
+        return (value & ((1u << p) - 1)) == 0;
+    }
+
+    internal inline u32 mul_shift32(u32 m, u64 factor, s32 shift) {
+        RUNTIME_ASSERT(shift > 32);
+
+        u64 bits0 = (u64)m * (u32)factor;
+        u64 bits1 = (u64)m * (u32)(factor >> 32);
+        u64 sum = (bits0 >> 32) + bits1;
+
+        return (u32)(sum >> (shift - 32));
+    }
+
+    // Shortest decimal as output * 10^exponent
+    internal void float_to_decimal(u32 ieee_mantissa, u32 ieee_exponent, u32* out_digits, s32* out_exponent) {
+        s32 e2;
+        u32 m2;
+        if (ieee_exponent == 0) {
+            e2 = 1 - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+            m2 = ieee_mantissa;
+        } else {
+            e2 = (s32)ieee_exponent - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+            m2 = (1u << FLOAT_MANTISSA_BITS) | ieee_mantissa;
+        }
+        const bool accept_bounds = (m2 & 1) == 0;
+
+        // The interval of valid decimal representations is (mm, mp) around mv, scaled by 4
+        const u32 mv = 4 * m2;
+        const u32 mp = 4 * m2 + 2;
+        const u32 mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+        const u32 mm = 4 * m2 - 1 - mm_shift;
+
+        u32 vr, vp, vm;
+        s32 e10;
+        bool vm_is_trailing_zeros = false;
+        bool vr_is_trailing_zeros = false;
+        u8 last_removed_digit = 0;
+        if (e2 >= 0) {
+            const u32 q = log10_pow2(e2);
+            e10 = (s32)q;
+            const s32 k = FLOAT_POW5_INV_BITCOUNT + pow5_bits((s32)q) - 1;
+            const s32 i = -e2 + (s32)q + k;
+            vr = mul_shift32(mv, FLOAT_POW5_INV_SPLIT[q], i);
+            vp = mul_shift32(mp, FLOAT_POW5_INV_SPLIT[q], i);
+            vm = mul_shift32(mm, FLOAT_POW5_INV_SPLIT[q], i);
+            if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+                // One removed digit is needed even when the loop below doesn't run
+                const s32 l = FLOAT_POW5_INV_BITCOUNT + pow5_bits((s32)(q - 1)) - 1;
+                last_removed_digit = (u8)(mul_shift32(mv, FLOAT_POW5_INV_SPLIT[q - 1], -e2 + (s32)q - 1 + l) % 10);
+            }
+
+            if (q <= 9) {
+                // Only one of mp, mv and mm can be a multiple of 5, if any
+                if (mv % 5 == 0) {
+                    vr_is_trailing_zeros = multiple_of_power_of_5(mv, q);
+                } else if (accept_bounds) {
+                    vm_is_trailing_zeros = multiple_of_power_of_5(mm, q);
+                } else {
+                    vp -= multiple_of_power_of_5(mp, q);
+                }
+            }
+        } else {
+            const u32 q = log10_pow5(-e2);
+            e10 = (s32)q + e2;
+            const s32 i = -e2 - (s32)q;
+            const s32 k = pow5_bits(i) - FLOAT_POW5_BITCOUNT;
+            s32 j = (s32)q - k;
+            vr = mul_shift32(mv, FLOAT_POW5_SPLIT[i], j);
+            vp = mul_shift32(mp, FLOAT_POW5_SPLIT[i], j);
+            vm = mul_shift32(mm, FLOAT_POW5_SPLIT[i], j);
+            if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+                j = (s32)q - 1 - (pow5_bits(i + 1) - FLOAT_POW5_BITCOUNT);
+                last_removed_digit = (u8)(mul_shift32(mv, FLOAT_POW5_SPLIT[i + 1], j) % 10);
+            }
+
+            if (q <= 1) {
+                // mv = 4 * m2 always has at least two trailing zero bits
+                vr_is_trailing_zeros = true;
+                if (accept_bounds) {
+                    vm_is_trailing_zeros = mm_shift == 1;
+                } else {
+                    vp -= 1;
+                }
+            } else if (q < 31) {
+                vr_is_trailing_zeros = multiple_of_power_of_2(mv, q - 1);
+            }
+        }
+
+        // Drop digits while the interval still holds a shorter number
+        s32 removed = 0;
+        u32 output;
+        if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+            while (vp / 10 > vm / 10) {
+                vm_is_trailing_zeros &= vm % 10 == 0;
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (u8)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed += 1;
+            }
+
+            if (vm_is_trailing_zeros) {
+                while (vm % 10 == 0) {
+                    vr_is_trailing_zeros &= last_removed_digit == 0;
+                    last_removed_digit = (u8)(vr % 10);
+                    vr /= 10;
+                    vp /= 10;
+                    vm /= 10;
+                    removed += 1;
+                }
+            }
+
+            if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+                // exactly halfway, round to even
+                last_removed_digit = 4;
+            }
+
+            output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+        } else {
+            // the common case (~96%)
+            while (vp / 10 > vm / 10) {
+                last_removed_digit = (u8)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed += 1;
+            }
+
+            output = vr + (vr == vm || last_removed_digit >= 5);
+        }
+
+        *out_digits = output;
+        *out_exponent = e10 + removed;
+    }
+
+    u64 format_float(float value, char* buffer, u64 buffer_capacity) {
+        RUNTIME_ASSERT(buffer);
+        RUNTIME_ASSERT_MSG(buffer_capacity >= STRING_FORMAT_FLOAT_BUFFER_SIZE, "format_float: buffer_capacity must be at least STRING_FORMAT_FLOAT_BUFFER_SIZE\n");
+
+        u32 bits;
+        Memory::copy(&bits, sizeof(bits), &value, sizeof(value));
+        const bool sign = (bits >> (FLOAT_MANTISSA_BITS + FLOAT_EXPONENT_BITS)) != 0;
+        const u32 ieee_mantissa = bits & ((1u << FLOAT_MANTISSA_BITS) - 1);
+        const u32 ieee_exponent = (bits >> FLOAT_MANTISSA_BITS) & ((1u << FLOAT_EXPONENT_BITS) - 1);
+
+        u64 length = 0;
+        if (sign) {
+            buffer[length++] = '-';
+        }
+
+        if (ieee_exponent == ((1u << FLOAT_EXPONENT_BITS) - 1)) {
+            const char* special = ieee_mantissa ? "nan" : "inf";
+            Memory::copy(buffer + length, buffer_capacity - length, special, 3);
+            length += 3;
+            buffer[length] = '\0';
+
+            return length;
+        }
+
+        if (ieee_exponent == 0 && ieee_mantissa == 0) {
+            Memory::copy(buffer + length, buffer_capacity - length, "0.0", 3);
+            length += 3;
+            buffer[length] = '\0';
+
+            return length;
+        }
+
+        u32 digits;
+        s32 exponent;
+        float_to_decimal(ieee_mantissa, ieee_exponent, &digits, &exponent);
+
+        // Always fixed notation (the lexer has no exponent syntax), with at least one digit after the point
+        // so the text reads back as a float. Worst case is a denormal: "-0." + 44 zeros + 9 digits.
+        const s32 digit_count = (s32)decimal_digit_count(digits);
+        const s32 point_position = digit_count + exponent; // digits before the decimal point
+        char* cursor = buffer + length;
+        if (point_position <= 0) {
+            *cursor++ = '0';
+            *cursor++ = '.';
+            for (s32 i = 0; i < -point_position; i++) {
+                *cursor++ = '0';
+            }
+
+            write_digits_backwards(cursor + digit_count, digits, digit_count);
+            cursor += digit_count;
+        } else if (point_position >= digit_count) {
+            write_digits_backwards(cursor + digit_count, digits, digit_count);
+            cursor += digit_count;
+            for (s32 i = 0; i < exponent; i++) {
+                *cursor++ = '0';
+            }
+
+            *cursor++ = '.';
+            *cursor++ = '0';
+        } else {
+            // write all digits one slot to the right, then pull the integer part back over the gap
+            write_digits_backwards(cursor + digit_count + 1, digits, digit_count);
+            for (s32 i = 0; i < point_position; i++) {
+                cursor[i] = cursor[i + 1];
+            }
+
+            cursor[point_position] = '.';
+            cursor += digit_count + 1;
+        }
+
+        length = (u64)(cursor - buffer);
+        RUNTIME_ASSERT(length < buffer_capacity);
+        buffer[length] = '\0';
+
+        return length;
+    }
+}
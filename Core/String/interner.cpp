@@ -0,0 +1,146 @@
+#include "interner.hpp"
+#include "string.hpp"
+#include "../Hashing/hashing.hpp"
+
+namespace String {
+    Interner::Interner(Memory::BaseAllocator* allocator) : m_entries(allocator, INTERNER_DEFAULT_TABLE_CAPACITY), m_blocks(allocator, 4) {
+        RUNTIME_ASSERT(allocator);
+
+        this->m_allocator = allocator;
+        this->m_table_capacity = INTERNER_DEFAULT_TABLE_CAPACITY;
+        this->m_table = (Symbol*)this->m_allocator->malloc(this->m_table_capacity * sizeof(Symbol));
+        Memory::zero(this->m_table, this->m_table_capacity * sizeof(Symbol));
+
+        // index 0 is SYMBOL_INVALID
+        this->m_entries.push(InternEntry{"", 0, 0});
+    }
+
+    Interner::~Interner() {
+        for (char* block : this->m_blocks) {
+            this->m_allocator->free(block);
+        }
+
+        if (this->m_table) {
+            this->m_allocator->free(this->m_table);
+        }
+
+        this->m_table = nullptr;
+        this->m_table_capacity = 0;
+    }
+
+    Symbol Interner::intern(DS::View<char> str) {
+        return this->intern(str.data, str.length);
+    }
+
+    Symbol Interner::intern(const char* str, u64 str_length) {
+        RUNTIME_ASSERT_MSG(str_length <= 0xFFFFFFFF, "Interned strings must fit in a u32 length\n");
+
+        u64 hash = Hashing::string_hash(str, str_length);
+        u64 index = this->probe(str, str_length, hash);
+        if (this->m_table[index] != SYMBOL_INVALID) {
+            return this->m_table[index];
+        }
+
+        // keep the load factor under 0.5, entries[0] is the reserved slot
+        if ((this->m_entries.count() * 2) >= this->m_table_capacity) {
+            this->grow_table();
+            index = this->probe(str, str_length, hash);
+        }
+
+        Symbol symbol = (Symbol)this->m_entries.count();
+        this->m_entries.push(InternEntry{this->store_bytes(str, str_length), (u32)str_length, hash});
+        this->m_table[index] = symbol;
+
+        return symbol;
+    }
+
+    Symbol Interner::find(DS::View<char> str) const {
+        u64 hash = Hashing::string_hash(str.data, str.length);
+
+        return this->m_table[this->probe(str.data, str.length, hash)];
+    }
+
+    DS::View<char> Interner::view(Symbol symbol) const {
+        RUNTIME_ASSERT_MSG(symbol != SYMBOL_INVALID && symbol < this->m_entries.count(), "Invalid symbol: %u\n", symbol);
+
+        InternEntry entry = this->m_entries[symbol];
+
+        return DS::View<char>(entry.data, entry.length);
+    }
+
+    u64 Interner::hash(Symbol symbol) const {
+        RUNTIME_ASSERT_MSG(symbol != SYMBOL_INVALID && symbol < this->m_entries.count(), "Invalid symbol: %u\n", symbol);
+
+        return this->m_entries[symbol].hash;
+    }
+
+    u64 Interner::count() const {
+        return this->m_entries.count() - 1;
+    }
+
+    // Returns the slot holding the string or the empty slot it belongs in
+    u64 Interner::probe(const char* str, u64 str_length, u64 hash) const {
+        u64 mask = this->m_table_capacity - 1;
+        u64 index = hash & mask;
+
+        while (true) {
+            Symbol symbol = this->m_table[index];
+            if (symbol == SYMBOL_INVALID) {
+                return index;
+            }
+
+            const InternEntry& entry = this->m_entries.data()[symbol];
+            if (entry.hash == hash && String::equal(entry.data, entry.length, str, str_length)) {
+                return index;
+            }
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    const char* Interner::store_bytes(const char* str, u64 str_length) {
+        byte_t allocation_size = str_length + 1;
+
+        if (this->m_block_used + allocation_size > this->m_block_capacity) {
+            // oversized strings get a block of their own so the current block keeps its free space
+            byte_t block_size = allocation_size > INTERNER_DEFAULT_BLOCK_SIZE ? allocation_size : INTERNER_DEFAULT_BLOCK_SIZE;
+            this->m_blocks.push((char*)this->m_allocator->malloc(block_size));
+            this->m_block_used = 0;
+            this->m_block_capacity = block_size;
+        }
+
+        char* ret = this->m_blocks[this->m_blocks.count() - 1] + this->m_block_used;
+        Memory::copy(ret, allocation_size, str, str_length);
+        ret[str_length] = '\0';
+        this->m_block_used += allocation_size;
+
+        return ret;
+    }
+
+    void Interner::grow_table() {
+        u64 new_capacity = this->m_table_capacity * 2;
+        Symbol* new_table = (Symbol*)this->m_allocator->malloc(new_capacity * sizeof(Symbol));
+        Memory::zero(new_table, new_capacity * sizeof(Symbol));
+
+        // the stored hashes make this a pure reinsert, no string is hashed twice
+        u64 mask = new_capacity - 1;
+        for (u64 symbol = 1; symbol < this->m_entries.count(); symbol++) {
+            u64 index = this->m_entries.data()[symbol].hash & mask;
+            while (new_table[index] != SYMBOL_INVALID) {
+                index = (index + 1) & mask;
+            }
+
+            new_table[index] = (Symbol)symbol;
+        }
+
+        this->m_allocator->free(this->m_table);
+        this->m_table = new_table;
+        this->m_table_capacity = new_capacity;
+    }
+
+    Interner* global_interner() {
+        local_persist Interner interner(&Memory::global_general_allocator);
+
+        return &interner;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../Common/common.hpp"
+#include "../Memory/memory.hpp"
+#include "../DataStructure/ds.hpp"
+
+#define INTERNER_DEFAULT_BLOCK_SIZE KB(16)
+#define INTERNER_DEFAULT_TABLE_CAPACITY 64
+#define SYMBOL_INVALID 0
+
+namespace String {
+    // Stable integer handle for an interned string, two equal strings always get the same Symbol.
+    // Symbol 0 (SYMBOL_INVALID) is never handed out so zeroed structs read as "no name".
+    typedef u32 Symbol;
+
+    /**
+     * Stores every distinct string exactly once and hands back a u32 Symbol for it.
+     * The bytes are copied into arena blocks that never move, so view(symbol) stays valid
+     * for the lifetime of the interner. Stored strings are null terminated.
+     *
+     * The hash of each string is computed once on intern(), the lookup table only
+     * compares stored hashes until it finds a candidate worth a byte compare.
+     */
+    struct Interner {
+        Interner(Memory::BaseAllocator* allocator);
+        ~Interner();
+
+        // Prevent copy
+        Interner(const Interner& other) = delete;
+        Interner& operator=(const Interner& other) = delete;
+
+        Symbol intern(DS::View<char> str);
+        Symbol intern(const char* str, u64 str_length);
+
+        // Returns SYMBOL_INVALID if the string was never interned
+        Symbol find(DS::View<char> str) const;
+
+        DS::View<char> view(Symbol symbol) const;
+        u64 hash(Symbol symbol) const;
+        u64 count() const;
+
+    private:
+        struct InternEntry {
+            const char* data;
+            u32 length;
+            u64 hash;
+        };
+
+        Memory::BaseAllocator* m_allocator = nullptr;
+        DS::Vector<InternEntry> m_entries;
+        DS::Vector<char*> m_blocks;
+        u64 m_block_used = 0;
+        u64 m_block_capacity = 0;
+
+        Symbol* m_table = nullptr;
+        u64 m_table_capacity = 0;
+
+        u64 probe(const char* str, u64 str_length, u64 hash) const;
+        const char* store_bytes(const char* str, u64 str_length);
+        void grow_table();
+    };
+
+    // Process wide interner the lexer uses for identifiers
+    Interner* global_interner();
+}
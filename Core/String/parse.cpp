@@ -0,0 +1,375 @@
+#include "string.hpp"
+
+#include <stdlib.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #pragma intrinsic(_umul128)
+#endif
+
+// Float literals go through Clinger's exact fast path, then Eisel-Lemire
+// (Lemire, "Number Parsing at a Gigabyte per Second", 2021) and only fall back to strtof
+// for the rare inputs neither can round correctly (more than 19 significant digits or an ambiguous product).
+
+#define FLOAT_MANTISSA_EXPLICIT_BITS 23
+#define FLOAT_MINIMUM_EXPONENT -127
+#define FLOAT_INFINITE_POWER 0xFF
+#define FLOAT_SMALLEST_POWER_OF_TEN -65
+#define FLOAT_LARGEST_POWER_OF_TEN 38
+#define FLOAT_MIN_EXPONENT_ROUND_TO_EVEN -17
+#define FLOAT_MAX_EXPONENT_ROUND_TO_EVEN 10
+#define FLOAT_MAX_EXPONENT_FAST_PATH 10
+#define FLOAT_MAX_MANTISSA_FAST_PATH (1ULL << 24)
+#define NUMBER_MAX_SIGNIFICANT_DIGITS 19
+
+namespace String {
+    // 128-bit truncated 5^q for q in [FLOAT_SMALLEST_POWER_OF_TEN, FLOAT_LARGEST_POWER_OF_TEN], most significant bit set, stored {high, low}
+    internal const u64 POWERS_OF_FIVE_128[208] = {
+        0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL,
+        0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL,
+        0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL,
+        0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL,
+        0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL,
+        0xcdb02555653131b6ULL, 0x3792f412cb06794dULL,
+        0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL,
+        0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL,
+        0xc8de047564d20a8bULL, 0xf245825a5a445275ULL,
+        0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL,
+        0x9ced737bb6c4183dULL, 0x55464dd69685606bULL,
+        0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL,
+        0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL,
+        0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL,
+        0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL,
+        0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL,
+        0x95a8637627989aadULL, 0xdde7001379a44aa8ULL,
+        0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL,
+        0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL,
+        0x9226712162ab070dULL, 0xcab3961304ca70e8ULL,
+        0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL,
+        0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL,
+        0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL,
+        0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL,
+        0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL,
+        0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL,
+        0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL,
+        0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL,
+        0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL,
+        0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL,
+        0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL,
+        0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL,
+        0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL,
+        0xcfb11ead453994baULL, 0x67de18eda5814af2ULL,
+        0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL,
+        0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL,
+        0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL,
+        0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL,
+        0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL,
+        0xc612062576589ddaULL, 0x95364afe032a819eULL,
+        0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL,
+        0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL,
+        0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL,
+        0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL,
+        0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL,
+        0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL,
+        0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL,
+        0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL,
+        0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL,
+        0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL,
+        0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL,
+        0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL,
+        0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL,
+        0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL,
+        0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL,
+        0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL,
+        0x89705f4136b4a597ULL, 0x31680a88f8953031ULL,
+        0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL,
+        0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL,
+        0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL,
+        0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL,
+        0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL,
+        0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL,
+        0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL,
+        0xccccccccccccccccULL, 0xcccccccccccccccdULL,
+        0x8000000000000000ULL, 0x0000000000000000ULL,
+        0xa000000000000000ULL, 0x0000000000000000ULL,
+        0xc800000000000000ULL, 0x0000000000000000ULL,
+        0xfa00000000000000ULL, 0x0000000000000000ULL,
+        0x9c40000000000000ULL, 0x0000000000000000ULL,
+        0xc350000000000000ULL, 0x0000000000000000ULL,
+        0xf424000000000000ULL, 0x0000000000000000ULL,
+        0x9896800000000000ULL, 0x0000000000000000ULL,
+        0xbebc200000000000ULL, 0x0000000000000000ULL,
+        0xee6b280000000000ULL, 0x0000000000000000ULL,
+        0x9502f90000000000ULL, 0x0000000000000000ULL,
+        0xba43b74000000000ULL, 0x0000000000000000ULL,
+        0xe8d4a51000000000ULL, 0x0000000000000000ULL,
+        0x9184e72a00000000ULL, 0x0000000000000000ULL,
+        0xb5e620f480000000ULL, 0x0000000000000000ULL,
+        0xe35fa931a0000000ULL, 0x0000000000000000ULL,
+        0x8e1bc9bf04000000ULL, 0x0000000000000000ULL,
+        0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL,
+        0xde0b6b3a76400000ULL, 0x0000000000000000ULL,
+        0x8ac7230489e80000ULL, 0x0000000000000000ULL,
+        0xad78ebc5ac620000ULL, 0x0000000000000000ULL,
+        0xd8d726b7177a8000ULL, 0x0000000000000000ULL,
+        0x878678326eac9000ULL, 0x0000000000000000ULL,
+        0xa968163f0a57b400ULL, 0x0000000000000000ULL,
+        0xd3c21bcecceda100ULL, 0x0000000000000000ULL,
+        0x84595161401484a0ULL, 0x0000000000000000ULL,
+        0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL,
+        0xcecb8f27f4200f3aULL, 0x0000000000000000ULL,
+        0x813f3978f8940984ULL, 0x4000000000000000ULL,
+        0xa18f07d736b90be5ULL, 0x5000000000000000ULL,
+        0xc9f2c9cd04674edeULL, 0xa400000000000000ULL,
+        0xfc6f7c4045812296ULL, 0x4d00000000000000ULL,
+        0x9dc5ada82b70b59dULL, 0xf020000000000000ULL,
+        0xc5371912364ce305ULL, 0x6c28000000000000ULL,
+        0xf684df56c3e01bc6ULL, 0xc732000000000000ULL,
+        0x9a130b963a6c115cULL, 0x3c7f400000000000ULL,
+        0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL,
+        0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL,
+        0x96769950b50d88f4ULL, 0x1314448000000000ULL,
+    };
+
+    internal const float FLOAT_EXACT_POWERS_OF_TEN[FLOAT_MAX_EXPONENT_FAST_PATH + 1] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    internal inline bool is_digit(char c) {
+        return (u8)(c - '0') < 10;
+    }
+
+    internal inline u64 full_multiply(u64 a, u64 b, u64* out_high) {
+        #if defined(_MSC_VER)
+            return _umul128(a, b, out_high);
+        #else
+            __uint128_t product = (__uint128_t)a * b;
+            *out_high = (u64)(product >> 64);
+            return (u64)product;
+        #endif
+    }
+
+    internal inline s32 leading_zero_count(u64 value) {
+        #if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse64(&index, value);
+            return 63 - (s32)index;
+        #else
+            return (s32)__builtin_clzll(value);
+        #endif
+    }
+
+    internal inline float float_from_bits(u32 bits) {
+        float ret;
+        Memory::copy(&ret, sizeof(ret), &bits, sizeof(bits));
+
+        return ret;
+    }
+
+    // Returns false when the product is too close to a rounding boundary to decide
+    internal bool eisel_lemire(s64 q, u64 w, u32* out_bits) {
+        if (w == 0 || q < FLOAT_SMALLEST_POWER_OF_TEN) {
+            *out_bits = 0;
+            return true;
+        } else if (q > FLOAT_LARGEST_POWER_OF_TEN) {
+            *out_bits = FLOAT_INFINITE_POWER << FLOAT_MANTISSA_EXPLICIT_BITS;
+            return true;
+        }
+
+        const s32 leading_zeros = leading_zero_count(w);
+        w <<= leading_zeros;
+
+        // w * 5^q, only the high bits matter. The second half of the power is needed
+        // when the bits below the mantissa are all ones and a carry could still reach them.
+        const u64 index = 2 * (u64)(q - FLOAT_SMALLEST_POWER_OF_TEN);
+        u64 high;
+        u64 low = full_multiply(w, POWERS_OF_FIVE_128[index], &high);
+        const u64 precision_mask = 0xFFFFFFFFFFFFFFFFULL >> (FLOAT_MANTISSA_EXPLICIT_BITS + 3);
+        if ((high & precision_mask) == precision_mask) {
+            u64 second_high;
+            full_multiply(w, POWERS_OF_FIVE_128[index + 1], &second_high);
+            low += second_high;
+            if (second_high > low) {
+                high += 1;
+            }
+
+            if (low == 0xFFFFFFFFFFFFFFFFULL && (q < -27 || q > 55)) {
+                return false;
+            }
+        }
+
+        const u32 upper_bit = (u32)(high >> 63);
+        const u32 shift = upper_bit + 64 - FLOAT_MANTISSA_EXPLICIT_BITS - 3;
+        u64 mantissa = high >> shift;
+        s32 power2 = (s32)((((152170 + 65536) * q) >> 16) + 63) + (s32)upper_bit - leading_zeros - FLOAT_MINIMUM_EXPONENT;
+
+        if (power2 <= 0) {
+            // subnormal
+            if (-power2 + 1 >= 64) {
+                *out_bits = 0;
+                return true;
+            }
+
+            mantissa >>= -power2 + 1;
+            mantissa += (mantissa & 1);
+            mantissa >>= 1;
+            power2 = (mantissa < (1ULL << FLOAT_MANTISSA_EXPLICIT_BITS)) ? 0 : 1;
+            *out_bits = ((u32)power2 << FLOAT_MANTISSA_EXPLICIT_BITS) | (u32)(mantissa & ((1ULL << FLOAT_MANTISSA_EXPLICIT_BITS) - 1));
+            return true;
+        }
+
+        // exactly halfway between two floats, round to even instead of up
+        if (low <= 1 && q >= FLOAT_MIN_EXPONENT_ROUND_TO_EVEN && q <= FLOAT_MAX_EXPONENT_ROUND_TO_EVEN && (mantissa & 3) == 1) {
+            if ((mantissa << shift) == high) {
+                mantissa &= ~1ULL;
+            }
+        }
+
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        if (mantissa >= (2ULL << FLOAT_MANTISSA_EXPLICIT_BITS)) {
+            mantissa = 1ULL << FLOAT_MANTISSA_EXPLICIT_BITS;
+            power2 += 1;
+        }
+
+        mantissa &= ~(1ULL << FLOAT_MANTISSA_EXPLICIT_BITS);
+        if (power2 >= FLOAT_INFINITE_POWER) {
+            power2 = FLOAT_INFINITE_POWER;
+            mantissa = 0;
+        }
+
+        *out_bits = ((u32)power2 << FLOAT_MANTISSA_EXPLICIT_BITS) | (u32)mantissa;
+        return true;
+    }
+
+    internal float slow_parse_float(DS::View<char> str) {
+        char buffer[512];
+        RUNTIME_ASSERT_MSG(str.length < sizeof(buffer), "Float literal is too long: %.*s\n", (int)str.length, str.data);
+
+        Memory::copy(buffer, sizeof(buffer), str.data, str.length);
+        buffer[str.length] = '\0';
+
+        return strtof(buffer, nullptr);
+    }
+
+    NumberKind parse_number(DS::View<char> str, s64* out_integer, float* out_floating) {
+        RUNTIME_ASSERT(out_integer);
+        RUNTIME_ASSERT(out_floating);
+
+        const char* cursor = str.data;
+        const char* end = str.data + str.length;
+
+        bool negative = false;
+        if (cursor != end && (*cursor == '-' || *cursor == '+')) {
+            negative = *cursor == '-';
+            cursor += 1;
+        }
+
+        // Significand, overflow is tracked separately for the integer and float interpretation
+        u64 w = 0;
+        u64 significant_digits = 0;
+        bool integer_overflow = false;
+        const char* integer_start = cursor;
+        while (cursor != end && is_digit(*cursor)) {
+            u64 digit = (u64)(*cursor - '0');
+            if (w > (0xFFFFFFFFFFFFFFFFULL - digit) / 10) {
+                integer_overflow = true;
+            }
+
+            w = (w * 10) + digit;
+            significant_digits += (significant_digits > 0 || digit != 0);
+            cursor += 1;
+        }
+        u64 integer_digit_count = (u64)(cursor - integer_start);
+
+        s64 exponent = 0;
+        bool is_float = false;
+        if (cursor != end && *cursor == '.') {
+            is_float = true;
+            cursor += 1;
+
+            const char* fraction_start = cursor;
+            while (cursor != end && is_digit(*cursor)) {
+                u64 digit = (u64)(*cursor - '0');
+                w = (w * 10) + digit;
+                significant_digits += (significant_digits > 0 || digit != 0);
+                cursor += 1;
+            }
+
+            exponent = -(s64)(cursor - fraction_start);
+            if (integer_digit_count == 0 && cursor == fraction_start) {
+                return NUMBER_INVALID; // just "."
+            }
+        } else if (integer_digit_count == 0) {
+            return NUMBER_INVALID;
+        }
+
+        if (cursor != end && (*cursor == 'e' || *cursor == 'E')) {
+            is_float = true;
+            cursor += 1;
+
+            bool negative_exponent = false;
+            if (cursor != end && (*cursor == '-' || *cursor == '+')) {
+                negative_exponent = *cursor == '-';
+                cursor += 1;
+            }
+
+            if (cursor == end || !is_digit(*cursor)) {
+                return NUMBER_INVALID;
+            }
+
+            s64 explicit_exponent = 0;
+            while (cursor != end && is_digit(*cursor)) {
+                if (explicit_exponent < 0x10000) {
+                    explicit_exponent = (explicit_exponent * 10) + (*cursor - '0');
+                }
+
+                cursor += 1;
+            }
+
+            exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+        }
+
+        if (cursor != end) {
+            return NUMBER_INVALID;
+        }
+
+        if (!is_float) {
+            u64 limit = negative ? (1ULL << 63) : (u64)0x7FFFFFFFFFFFFFFFULL;
+            if (integer_overflow || w > limit) {
+                return NUMBER_INTEGER_OVERFLOW;
+            }
+
+            *out_integer = negative ? (s64)(0 - w) : (s64)w;
+            return NUMBER_INTEGER;
+        }
+
+        if (significant_digits > NUMBER_MAX_SIGNIFICANT_DIGITS) {
+            // w wrapped, only strtof can round this correctly
+            *out_floating = slow_parse_float(str);
+            return NUMBER_FLOAT;
+        }
+
+        float value;
+        if (exponent >= -FLOAT_MAX_EXPONENT_FAST_PATH && exponent <= FLOAT_MAX_EXPONENT_FAST_PATH && w <= FLOAT_MAX_MANTISSA_FAST_PATH) {
+            // both w and 10^|exponent| are exact floats, so one IEEE operation rounds correctly
+            value = (float)w;
+            if (exponent < 0) {
+                value /= FLOAT_EXACT_POWERS_OF_TEN[-exponent];
+            } else {
+                value *= FLOAT_EXACT_POWERS_OF_TEN[exponent];
+            }
+        } else {
+            u32 bits = 0;
+            if (!eisel_lemire(exponent, w, &bits)) {
+                *out_floating = slow_parse_float(str);
+                return NUMBER_FLOAT;
+            }
+
+            value = float_from_bits(bits);
+        }
+
+        *out_floating = negative ? -value : value;
+        return NUMBER_FLOAT;
+    }
+}
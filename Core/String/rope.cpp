@@ -0,0 +1,396 @@
+#include "rope.hpp"
+
+namespace String {
+    internal u32 count_newlines(const char* text, u64 text_length) {
+        u32 ret = 0;
+        for (u64 i = 0; i < text_length; i++) {
+            ret += text[i] == '\n';
+        }
+
+        return ret;
+    }
+
+    Rope::Rope(Memory::BaseAllocator* allocator) {
+        RUNTIME_ASSERT(allocator);
+
+        this->m_allocator = allocator;
+    }
+
+    Rope::Rope(Memory::BaseAllocator* allocator, DS::View<char> text) : Rope(allocator) {
+        this->m_root = this->build(text.data, text.length);
+    }
+
+    Rope::~Rope() {
+        this->free_tree(this->m_root);
+        this->m_root = nullptr;
+    }
+
+    void Rope::insert(u64 offset, DS::View<char> text) {
+        this->insert(offset, text.data, text.length);
+    }
+
+    void Rope::insert(u64 offset, const char* text, u64 text_length) {
+        RUNTIME_ASSERT_MSG(offset <= this->length(), "Rope::insert offset %llu is past the end\n", (unsigned long long)offset);
+        if (text_length == 0) {
+            return;
+        }
+
+        if (this->insert_in_place(offset, text, text_length)) {
+            return;
+        }
+
+        RopeNode* left = nullptr;
+        RopeNode* right = nullptr;
+        this->split(this->m_root, offset, &left, &right);
+        this->m_root = this->merge(this->merge(left, this->build(text, text_length)), right);
+    }
+
+    void Rope::remove(u64 offset, u64 length) {
+        RUNTIME_ASSERT_MSG(offset + length <= this->length(), "Rope::remove range is past the end\n");
+        if (length == 0) {
+            return;
+        }
+
+        if (this->remove_in_place(offset, length)) {
+            return;
+        }
+
+        RopeNode* left = nullptr;
+        RopeNode* rest = nullptr;
+        RopeNode* middle = nullptr;
+        RopeNode* right = nullptr;
+        this->split(this->m_root, offset, &left, &rest);
+        this->split(rest, length, &middle, &right);
+        this->free_tree(middle);
+        this->m_root = this->merge(left, right);
+    }
+
+    void Rope::clear() {
+        this->free_tree(this->m_root);
+        this->m_root = nullptr;
+    }
+
+    void Rope::slice(u64 offset, u64 length, char* out_buffer, u64 out_buffer_capacity) const {
+        RUNTIME_ASSERT_MSG(offset + length <= this->length(), "Rope::slice range is past the end\n");
+        RUNTIME_ASSERT(length <= out_buffer_capacity);
+
+        this->slice_node(this->m_root, offset, length, out_buffer);
+    }
+
+    char Rope::byte_at(u64 offset) const {
+        RUNTIME_ASSERT_MSG(offset < this->length(), "Rope::byte_at offset %llu is past the end\n", (unsigned long long)offset);
+
+        const RopeNode* node = this->m_root;
+        while (true) {
+            u64 left_bytes = node->left ? node->left->bytes : 0;
+            if (offset < left_bytes) {
+                node = node->left;
+            } else if (offset < left_bytes + node->chunk_length) {
+                return node->chunk[offset - left_bytes];
+            } else {
+                offset -= left_bytes + node->chunk_length;
+                node = node->right;
+            }
+        }
+    }
+
+    u64 Rope::offset_to_line(u64 offset) const {
+        RUNTIME_ASSERT_MSG(offset <= this->length(), "Rope::offset_to_line offset %llu is past the end\n", (unsigned long long)offset);
+
+        u64 line = 1;
+        const RopeNode* node = this->m_root;
+        while (node) {
+            u64 left_bytes = node->left ? node->left->bytes : 0;
+            if (offset < left_bytes) {
+                node = node->left;
+                continue;
+            }
+
+            line += node->left ? node->left->newlines : 0;
+            offset -= left_bytes;
+            if (offset <= node->chunk_length) {
+                return line + count_newlines(node->chunk, offset);
+            }
+
+            line += node->chunk_newlines;
+            offset -= node->chunk_length;
+            node = node->right;
+        }
+
+        return line;
+    }
+
+    u64 Rope::line_to_offset(u64 line) const {
+        RUNTIME_ASSERT_MSG(line >= 1 && line <= this->line_count(), "Rope::line_to_offset line %llu doesn't exist\n", (unsigned long long)line);
+
+        // the line starts right after newline number (line - 1)
+        u64 newlines_to_skip = line - 1;
+        if (newlines_to_skip == 0) {
+            return 0;
+        }
+
+        u64 offset = 0;
+        const RopeNode* node = this->m_root;
+        while (node) {
+            u64 left_newlines = node->left ? node->left->newlines : 0;
+            if (newlines_to_skip <= left_newlines) {
+                node = node->left;
+                continue;
+            }
+
+            newlines_to_skip -= left_newlines;
+            offset += node->left ? node->left->bytes : 0;
+            if (newlines_to_skip <= node->chunk_newlines) {
+                for (u32 i = 0; i < node->chunk_length; i++) {
+                    if (node->chunk[i] == '\n' && --newlines_to_skip == 0) {
+                        return offset + i + 1;
+                    }
+                }
+            }
+
+            newlines_to_skip -= node->chunk_newlines;
+            offset += node->chunk_length;
+            node = node->right;
+        }
+
+        RUNTIME_ASSERT(false);
+
+        return 0;
+    }
+
+    u64 Rope::line_count() const {
+        return (this->m_root ? this->m_root->newlines : 0) + 1;
+    }
+
+    u64 Rope::length() const {
+        return this->m_root ? this->m_root->bytes : 0;
+    }
+
+    void Rope::for_each_chunk(ChunkFunction* chunk_func, void* user_data) const {
+        RUNTIME_ASSERT(chunk_func);
+
+        this->for_each_chunk_node(this->m_root, chunk_func, user_data);
+    }
+
+    Rope::RopeNode* Rope::create_node(const char* text, u64 text_length) {
+        RUNTIME_ASSERT(text_length <= ROPE_CHUNK_SIZE);
+
+        RopeNode* ret = (RopeNode*)this->m_allocator->malloc(sizeof(RopeNode));
+        ret->left = nullptr;
+        ret->right = nullptr;
+        ret->priority = this->next_priority();
+        ret->chunk_length = (u32)text_length;
+        ret->chunk_newlines = count_newlines(text, text_length);
+        ret->bytes = text_length;
+        ret->newlines = ret->chunk_newlines;
+        if (text_length) {
+            Memory::copy(ret->chunk, ROPE_CHUNK_SIZE, text, text_length);
+        }
+
+        return ret;
+    }
+
+    void Rope::free_tree(RopeNode* node) {
+        if (!node) {
+            return;
+        }
+
+        this->free_tree(node->left);
+        this->free_tree(node->right);
+        this->m_allocator->free(node);
+    }
+
+    u32 Rope::next_priority() {
+        // xorshift64, the treap only needs the priorities to look random
+        this->m_seed ^= this->m_seed << 13;
+        this->m_seed ^= this->m_seed >> 7;
+        this->m_seed ^= this->m_seed << 17;
+
+        return (u32)(this->m_seed >> 32);
+    }
+
+    void Rope::update_counts(RopeNode* node) {
+        node->bytes = node->chunk_length + (node->left ? node->left->bytes : 0) + (node->right ? node->right->bytes : 0);
+        node->newlines = node->chunk_newlines + (node->left ? node->left->newlines : 0) + (node->right ? node->right->newlines : 0);
+    }
+
+    Rope::RopeNode* Rope::merge(RopeNode* left, RopeNode* right) {
+        if (!left) {
+            return right;
+        }
+
+        if (!right) {
+            return left;
+        }
+
+        RopeNode* ret = nullptr;
+        if (left->priority > right->priority) {
+            left->right = this->merge(left->right, right);
+            ret = left;
+        } else {
+            right->left = this->merge(left, right->left);
+            ret = right;
+        }
+
+        this->update_counts(ret);
+
+        return ret;
+    }
+
+    // Everything before offset goes left, the rest right. A chunk that straddles the offset is cut in two.
+    void Rope::split(RopeNode* node, u64 offset, RopeNode** out_left, RopeNode** out_right) {
+        if (!node) {
+            *out_left = nullptr;
+            *out_right = nullptr;
+
+            return;
+        }
+
+        u64 left_bytes = node->left ? node->left->bytes : 0;
+        if (offset <= left_bytes) {
+            RopeNode* left_of_left = nullptr;
+            this->split(node->left, offset, &left_of_left, &node->left);
+            *out_left = left_of_left;
+            *out_right = node;
+        } else if (offset >= left_bytes + node->chunk_length) {
+            RopeNode* right_of_right = nullptr;
+            this->split(node->right, offset - left_bytes - node->chunk_length, &node->right, &right_of_right);
+            *out_left = node;
+            *out_right = right_of_right;
+        } else {
+            u64 cut = offset - left_bytes;
+            RopeNode* tail = this->create_node(node->chunk + cut, node->chunk_length - cut);
+            node->chunk_length = (u32)cut;
+            node->chunk_newlines -= tail->chunk_newlines;
+
+            *out_right = this->merge(tail, node->right);
+            node->right = nullptr;
+            *out_left = node;
+        }
+
+        this->update_counts(node);
+    }
+
+    Rope::RopeNode* Rope::build(const char* text, u64 text_length) {
+        RopeNode* ret = nullptr;
+        for (u64 i = 0; i < text_length; i += ROPE_CHUNK_SIZE) {
+            u64 count = (text_length - i) < ROPE_CHUNK_SIZE ? (text_length - i) : ROPE_CHUNK_SIZE;
+            ret = this->merge(ret, this->create_node(text + i, count));
+        }
+
+        return ret;
+    }
+
+    Rope::RopeNode* Rope::find_chunk(u64 offset, u64* out_local_offset) const {
+        RopeNode* node = this->m_root;
+        while (node) {
+            u64 left_bytes = node->left ? node->left->bytes : 0;
+            if (offset < left_bytes) {
+                node = node->left;
+            } else if (offset < left_bytes + node->chunk_length || (offset == left_bytes + node->chunk_length && !node->right)) {
+                *out_local_offset = offset - left_bytes;
+
+                return node;
+            } else {
+                offset -= left_bytes + node->chunk_length;
+                node = node->right;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Walks the same path as find_chunk, the decisions only read left subtrees that aren't touched yet
+    void Rope::add_counts_along_path(u64 offset, s64 bytes_delta, s64 newlines_delta) {
+        RopeNode* node = this->m_root;
+        while (node) {
+            u64 left_bytes = node->left ? node->left->bytes : 0;
+            node->bytes += bytes_delta;
+            node->newlines += newlines_delta;
+
+            if (offset < left_bytes) {
+                node = node->left;
+            } else if (offset < left_bytes + node->chunk_length || (offset == left_bytes + node->chunk_length && !node->right)) {
+                return;
+            } else {
+                offset -= left_bytes + node->chunk_length;
+                node = node->right;
+            }
+        }
+    }
+
+    // Fast path for typing: the text goes into the chunk that holds offset if it has room
+    bool Rope::insert_in_place(u64 offset, const char* text, u64 text_length) {
+        u64 local = 0;
+        RopeNode* node = this->find_chunk(offset, &local);
+        if (!node || node->chunk_length + text_length > ROPE_CHUNK_SIZE) {
+            return false;
+        }
+
+        u32 newlines = count_newlines(text, text_length);
+        this->add_counts_along_path(offset, (s64)text_length, (s64)newlines);
+
+        char* at = node->chunk + local;
+        Memory::copy(at + text_length, ROPE_CHUNK_SIZE - local - text_length, at, node->chunk_length - local);
+        Memory::copy(at, ROPE_CHUNK_SIZE - local, text, text_length);
+        node->chunk_length += (u32)text_length;
+        node->chunk_newlines += newlines;
+
+        return true;
+    }
+
+    // Fast path for deleting inside a single chunk, the chunk is never left empty
+    bool Rope::remove_in_place(u64 offset, u64 length) {
+        u64 local = 0;
+        RopeNode* node = this->find_chunk(offset, &local);
+        if (!node || local + length > node->chunk_length || length == node->chunk_length) {
+            return false;
+        }
+
+        char* at = node->chunk + local;
+        u32 newlines = count_newlines(at, length);
+        this->add_counts_along_path(offset, -(s64)length, -(s64)newlines);
+
+        Memory::copy(at, ROPE_CHUNK_SIZE - local, at + length, node->chunk_length - local - length);
+        node->chunk_length -= (u32)length;
+        node->chunk_newlines -= newlines;
+
+        return true;
+    }
+
+    void Rope::slice_node(const RopeNode* node, u64 offset, u64 length, char* out_buffer) const {
+        if (!node || length == 0) {
+            return;
+        }
+
+        u64 left_bytes = node->left ? node->left->bytes : 0;
+        if (offset < left_bytes) {
+            u64 count = (left_bytes - offset) < length ? (left_bytes - offset) : length;
+            this->slice_node(node->left, offset, count, out_buffer);
+            out_buffer += count;
+            length -= count;
+            offset = left_bytes;
+        }
+
+        u64 local = offset - left_bytes;
+        if (length && local < node->chunk_length) {
+            u64 count = (node->chunk_length - local) < length ? (node->chunk_length - local) : length;
+            Memory::copy(out_buffer, count, node->chunk + local, count);
+            out_buffer += count;
+            length -= count;
+            local += count;
+        }
+
+        this->slice_node(node->right, local - node->chunk_length, length, out_buffer);
+    }
+
+    void Rope::for_each_chunk_node(const RopeNode* node, ChunkFunction* chunk_func, void* user_data) const {
+        if (!node) {
+            return;
+        }
+
+        this->for_each_chunk_node(node->left, chunk_func, user_data);
+        chunk_func(DS::View<char>(node->chunk, node->chunk_length), user_data);
+        this->for_each_chunk_node(node->right, chunk_func, user_data);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../Common/common.hpp"
+#include "../Memory/memory.hpp"
+#include "../DataStructure/ds.hpp"
+
+#define ROPE_CHUNK_SIZE 512
+
+namespace String {
+    /**
+     * Text buffer for sources that stay resident and get small edits.
+     * The text is cut into chunks of at most ROPE_CHUNK_SIZE bytes, the chunks are the nodes of
+     * a treap ordered by position, so the expected depth is O(log n) without any rebalancing code.
+     * Every node caches the byte and newline count of its subtree, which makes
+     * insert, remove, slice, offset_to_line and line_to_offset O(log n + edit size).
+     *
+     * Edits that fit inside one chunk are applied in place, so typing doesn't fragment the tree.
+     * Lines are 1 based like the lexer.
+     */
+    struct Rope {
+        Rope(Memory::BaseAllocator* allocator);
+        Rope(Memory::BaseAllocator* allocator, DS::View<char> text);
+        ~Rope();
+
+        // Prevent copy
+        Rope(const Rope& other) = delete;
+        Rope& operator=(const Rope& other) = delete;
+
+        void insert(u64 offset, DS::View<char> text);
+        void insert(u64 offset, const char* text, u64 text_length);
+        void remove(u64 offset, u64 length);
+        void clear();
+
+        // Copies [offset, offset + length) into out_buffer, does not null terminate
+        void slice(u64 offset, u64 length, char* out_buffer, u64 out_buffer_capacity) const;
+        char byte_at(u64 offset) const;
+
+        u64 offset_to_line(u64 offset) const;
+        u64 line_to_offset(u64 line) const; // offset of the first byte of the line
+        u64 line_count() const;
+
+        u64 length() const;
+
+        // Calls the callback with every chunk in order, handy for hashing or writing out without flattening
+        typedef void(ChunkFunction)(DS::View<char> chunk, void* user_data);
+        void for_each_chunk(ChunkFunction* chunk_func, void* user_data = nullptr) const;
+
+    private:
+        struct RopeNode {
+            RopeNode* left;
+            RopeNode* right;
+            u32 priority;
+            u32 chunk_length;
+            u32 chunk_newlines;
+            u64 bytes;    // whole subtree
+            u64 newlines; // whole subtree
+            char chunk[ROPE_CHUNK_SIZE];
+        };
+
+        Memory::BaseAllocator* m_allocator = nullptr;
+        RopeNode* m_root = nullptr;
+        u64 m_seed = 0x9E3779B97F4A7C15ULL;
+
+        RopeNode* create_node(const char* text, u64 text_length);
+        void free_tree(RopeNode* node);
+        u32 next_priority();
+        void update_counts(RopeNode* node);
+
+        RopeNode* merge(RopeNode* left, RopeNode* right);
+        void split(RopeNode* node, u64 offset, RopeNode** out_left, RopeNode** out_right);
+        RopeNode* build(const char* text, u64 text_length);
+
+        // The node whose chunk holds offset, the end of the text belongs to the last chunk
+        RopeNode* find_chunk(u64 offset, u64* out_local_offset) const;
+        void add_counts_along_path(u64 offset, s64 bytes_delta, s64 newlines_delta);
+        bool insert_in_place(u64 offset, const char* text, u64 text_length);
+        bool remove_in_place(u64 offset, u64 length);
+
+        void slice_node(const RopeNode* node, u64 offset, u64 length, char* out_buffer) const;
+        void for_each_chunk_node(const RopeNode* node, ChunkFunction* chunk_func, void* user_data) const;
+    };
+}
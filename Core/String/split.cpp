@@ -0,0 +1,214 @@
+#include "split.hpp"
+#include "string.hpp"
+
+#include <string.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define SPLIT_SIMD_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define SPLIT_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace String {
+    internal inline bool set_contains(const u8* bitmap, u8 c) {
+        return (bitmap[c >> 3] >> (c & 7)) & 1;
+    }
+
+    #if defined(SPLIT_SIMD_SSE2) || defined(SPLIT_SIMD_NEON)
+        internal inline u32 split_count_trailing_zeros(u64 value) {
+            #if defined(_MSC_VER)
+                unsigned long index;
+                _BitScanForward64(&index, value);
+                return (u32)index;
+            #else
+                return (u32)__builtin_ctzll(value);
+            #endif
+        }
+    #endif
+
+    // Offset of the first byte in data that is in the set, or length
+    internal u64 find_any(const char* data, u64 length, const u8* bitmap, const char* set_bytes, u64 set_count) {
+        u64 i = 0;
+
+        #if defined(SPLIT_SIMD_SSE2)
+            if (set_count <= SPLIT_SIMD_MAX_SET) {
+                __m128i needles[SPLIT_SIMD_MAX_SET];
+                for (u64 k = 0; k < set_count; k++) {
+                    needles[k] = _mm_set1_epi8(set_bytes[k]);
+                }
+
+                for (; i + 16 <= length; i += 16) {
+                    __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+                    __m128i matches = _mm_setzero_si128();
+                    for (u64 k = 0; k < set_count; k++) {
+                        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, needles[k]));
+                    }
+
+                    u32 mask = (u32)_mm_movemask_epi8(matches);
+                    if (mask) {
+                        return i + split_count_trailing_zeros(mask);
+                    }
+                }
+            }
+        #elif defined(SPLIT_SIMD_NEON)
+            if (set_count <= SPLIT_SIMD_MAX_SET) {
+                uint8x16_t needles[SPLIT_SIMD_MAX_SET];
+                for (u64 k = 0; k < set_count; k++) {
+                    needles[k] = vdupq_n_u8((u8)set_bytes[k]);
+                }
+
+                for (; i + 16 <= length; i += 16) {
+                    uint8x16_t block = vld1q_u8((const u8*)(data + i));
+                    uint8x16_t matches = vdupq_n_u8(0);
+                    for (u64 k = 0; k < set_count; k++) {
+                        matches = vorrq_u8(matches, vceqq_u8(block, needles[k]));
+                    }
+
+                    // 4 bits per byte
+                    u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+                    if (mask) {
+                        return i + (split_count_trailing_zeros(mask) / 4);
+                    }
+                }
+            }
+        #endif
+
+        for (; i < length; i++) {
+            if (set_contains(bitmap, (u8)data[i])) {
+                return i;
+            }
+        }
+
+        return length;
+    }
+
+    DS::View<char> Split::Iterator::operator*() const {
+        return this->current;
+    }
+
+    Split::Iterator& Split::Iterator::operator++() {
+        this->done = !this->split->next(&this->current);
+
+        return *this;
+    }
+
+    bool Split::Iterator::operator!=(const Iterator& other) const {
+        return this->done != other.done;
+    }
+
+    Split::Split(SplitMode mode, DS::View<char> source, DS::View<char> delimiter) {
+        RUNTIME_ASSERT_MSG(mode == SPLIT_LINES || delimiter.length > 0, "Split delimiter can't be empty\n");
+
+        this->m_mode = mode;
+        this->m_source = source;
+        this->m_delimiter = delimiter;
+
+        if (mode == SPLIT_LINES) {
+            this->m_delimiter_byte = '\n';
+        } else if (mode == SPLIT_DELIMITER && delimiter.length == 1) {
+            this->m_delimiter_byte = delimiter.data[0];
+        } else if (mode == SPLIT_ANY) {
+            for (u64 i = 0; i < delimiter.length; i++) {
+                u8 c = (u8)delimiter.data[i];
+                if (set_contains(this->m_set_bitmap, c)) {
+                    continue;
+                }
+
+                this->m_set_bitmap[c >> 3] |= (u8)(1 << (c & 7));
+                if (this->m_set_count < SPLIT_SIMD_MAX_SET) {
+                    this->m_set_bytes[this->m_set_count] = (char)c;
+                }
+
+                this->m_set_count += 1;
+            }
+        }
+
+        // no lines at all in an empty source, but split("") is one empty field
+        this->m_finished = mode == SPLIT_LINES && source.length == 0;
+    }
+
+    u64 Split::find_next(u64* out_delimiter_length) const {
+        const char* start = this->m_source.data + this->m_position;
+        u64 remaining = this->m_source.length - this->m_position;
+
+        if (this->m_mode == SPLIT_ANY) {
+            *out_delimiter_length = 1;
+
+            return this->m_position + find_any(start, remaining, this->m_set_bitmap, this->m_set_bytes, this->m_set_count);
+        }
+
+        if (this->m_mode == SPLIT_LINES || this->m_delimiter.length == 1) {
+            *out_delimiter_length = 1;
+            const char* found = remaining ? (const char*)memchr(start, this->m_delimiter_byte, remaining) : nullptr;
+
+            return found ? (u64)(found - this->m_source.data) : this->m_source.length;
+        }
+
+        *out_delimiter_length = this->m_delimiter.length;
+        s64 found = String::index_of(start, remaining, this->m_delimiter.data, this->m_delimiter.length);
+
+        return found >= 0 ? this->m_position + (u64)found : this->m_source.length;
+    }
+
+    bool Split::next(DS::View<char>* out_slice) {
+        if (this->m_finished) {
+            return false;
+        }
+
+        u64 start = this->m_position;
+        u64 delimiter_length = 0;
+        u64 end = this->find_next(&delimiter_length);
+
+        if (end == this->m_source.length) {
+            this->m_finished = true;
+        } else {
+            this->m_position = end + delimiter_length;
+
+            // a trailing '\n' ends the last line instead of starting an empty one
+            if (this->m_mode == SPLIT_LINES && this->m_position == this->m_source.length) {
+                this->m_finished = true;
+            }
+        }
+
+        if (this->m_mode == SPLIT_LINES && end > start && this->m_source.data[end - 1] == '\r') {
+            end -= 1;
+        }
+
+        *out_slice = DS::View<char>(this->m_source.data + start, end - start);
+
+        return true;
+    }
+
+    Split::Iterator Split::begin() {
+        Iterator ret = Iterator{this, DS::View<char>(), false};
+        ret.done = !this->next(&ret.current);
+
+        return ret;
+    }
+
+    Split::Iterator Split::end() {
+        return Iterator{this, DS::View<char>(), true};
+    }
+
+    Split split(DS::View<char> source, DS::View<char> delimiter) {
+        return Split(SPLIT_DELIMITER, source, delimiter);
+    }
+
+    Split split(DS::View<char> source, char delimiter) {
+        return Split(SPLIT_DELIMITER, source, DS::View<char>(&delimiter, 1));
+    }
+
+    Split lines(DS::View<char> source) {
+        return Split(SPLIT_LINES, source, DS::View<char>("\n", 1));
+    }
+
+    Split split_any(DS::View<char> source, DS::View<char> set) {
+        return Split(SPLIT_ANY, source, set);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../Common/common.hpp"
+#include "../DataStructure/ds.hpp"
+
+#define SPLIT_SIMD_MAX_SET 8 // bigger sets fall back to the bitmap
+
+namespace String {
+    enum SplitMode {
+        SPLIT_DELIMITER,
+        SPLIT_LINES,
+        SPLIT_ANY
+    };
+
+    /**
+     * Lazily walks a view and yields the slices between delimiters, nothing is copied or allocated.
+     * The slices point into the source so they live as long as it does.
+     *
+     *     for (DS::View<char> line : String::lines(source)) { ... }
+     *
+     * split() and split_any() keep empty fields ("a,,b" -> "a", "", "b"), lines() drops the
+     * empty line after a trailing '\n' and strips the '\r' of "\r\n".
+     */
+    struct Split {
+        struct Iterator {
+            Split* split;
+            DS::View<char> current;
+            bool done;
+
+            DS::View<char> operator*() const;
+            Iterator& operator++();
+            bool operator!=(const Iterator& other) const;
+        };
+
+        Split(SplitMode mode, DS::View<char> source, DS::View<char> delimiter);
+
+        // Pull style, returns false once every slice has been handed out
+        bool next(DS::View<char>* out_slice);
+
+        Iterator begin();
+        Iterator end();
+
+    private:
+        SplitMode m_mode;
+        DS::View<char> m_source;
+        DS::View<char> m_delimiter;
+        char m_delimiter_byte = '\0'; // single byte delimiters are copied so split(view, ',') never dangles
+        u64 m_position = 0;
+        bool m_finished = false;
+
+        // SPLIT_ANY: one bit per byte value, small sets are also kept as bytes for the SIMD compare
+        u8 m_set_bitmap[32] = {0};
+        char m_set_bytes[SPLIT_SIMD_MAX_SET] = {0};
+        u64 m_set_count = 0;
+
+        // Returns the offset of the next delimiter at or after m_position and its length, or m_source.length
+        u64 find_next(u64* out_delimiter_length) const;
+    };
+
+    Split split(DS::View<char> source, DS::View<char> delimiter);
+    Split split(DS::View<char> source, char delimiter);
+    Split lines(DS::View<char> source);
+    Split split_any(DS::View<char> source, DS::View<char> set);
+}
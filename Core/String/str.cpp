@@ -0,0 +1,183 @@
+#include "str.hpp"
+#include "string.hpp"
+
+#define STR_FLAG_BYTE (STR_INLINE_CAPACITY + 1)
+#define STR_HEAP_FLAG (1ULL << 63)
+
+namespace String {
+    Str::Str() {
+        Memory::zero(this->m_inline, sizeof(this->m_inline));
+    }
+
+    Str::Str(Memory::BaseAllocator* allocator) : Str() {
+        this->m_allocator = allocator;
+    }
+
+    Str::Str(Memory::BaseAllocator* allocator, DS::View<char> str) : Str(allocator) {
+        this->append(str.data, str.length);
+    }
+
+    Str::Str(Memory::BaseAllocator* allocator, const char* str, u64 str_length) : Str(allocator) {
+        this->append(str, str_length);
+    }
+
+    Str::Str(Memory::BaseAllocator* allocator, const char* c_string) : Str(allocator) {
+        this->append(c_string, String::length(c_string));
+    }
+
+    Str::~Str() {
+        this->release();
+    }
+
+    Str::Str(Str&& other) {
+        // no self pointers, so stealing is a byte copy and resetting the source to empty inline
+        this->m_allocator = other.m_allocator;
+        Memory::copy(this->m_inline, sizeof(this->m_inline), other.m_inline, sizeof(other.m_inline));
+        Memory::zero(other.m_inline, sizeof(other.m_inline));
+    }
+
+    Str& Str::operator=(Str&& other) {
+        if (this != &other) {
+            this->release();
+
+            this->m_allocator = other.m_allocator;
+            Memory::copy(this->m_inline, sizeof(this->m_inline), other.m_inline, sizeof(other.m_inline));
+            Memory::zero(other.m_inline, sizeof(other.m_inline));
+        }
+
+        return *this;
+    }
+
+    Str Str::clone() const {
+        return this->clone(this->m_allocator);
+    }
+
+    Str Str::clone(Memory::BaseAllocator* allocator) const {
+        return Str(allocator, this->c_str(), this->length());
+    }
+
+    void Str::append(DS::View<char> str) {
+        this->append(str.data, str.length);
+    }
+
+    void Str::append(const char* str, u64 str_length) {
+        if (str_length == 0) {
+            return;
+        }
+
+        RUNTIME_ASSERT(str);
+
+        u64 old_length = this->length();
+        u64 required = old_length + str_length;
+        if (required > this->capacity()) {
+            u64 new_capacity = this->capacity() * 2;
+            while (new_capacity < required) {
+                new_capacity *= 2;
+            }
+
+            // str can be a view of this string, growing moves (or overwrites, when inline) the bytes it points at
+            const char* old_data = this->data();
+            bool aliased = str >= old_data && str <= old_data + this->capacity();
+            u64 alias_offset = (u64)(str - old_data);
+
+            this->reserve(new_capacity);
+            if (aliased) {
+                str = this->data() + alias_offset;
+            }
+        }
+
+        char* data = this->data();
+        Memory::copy(data + old_length, this->capacity() - old_length, str, str_length);
+        this->set_length(required);
+    }
+
+    void Str::append(const char* c_string) {
+        this->append(c_string, String::length(c_string));
+    }
+
+    void Str::append_char(char c) {
+        this->append(&c, 1);
+    }
+
+    void Str::reserve(u64 capacity) {
+        if (capacity <= this->capacity()) {
+            return;
+        }
+
+        RUNTIME_ASSERT_MSG(this->m_allocator, "String::Str needs an allocator for strings longer than %d bytes\n", STR_INLINE_CAPACITY);
+        RUNTIME_ASSERT((capacity & STR_HEAP_FLAG) == 0);
+
+        u64 length = this->length();
+        char* new_data = nullptr;
+        if (this->is_inline()) {
+            new_data = (char*)this->m_allocator->malloc(capacity + 1);
+            Memory::copy(new_data, capacity + 1, this->m_inline, length + 1);
+        } else {
+            byte_t old_allocation_size = (this->m_heap.capacity & ~STR_HEAP_FLAG) + 1;
+            new_data = (char*)this->m_allocator->realloc(this->m_heap.data, old_allocation_size, capacity + 1);
+        }
+
+        this->m_heap.data = new_data;
+        this->m_heap.length = length;
+        this->m_heap.capacity = capacity | STR_HEAP_FLAG;
+    }
+
+    // Keeps the heap buffer, it will likely be refilled
+    void Str::clear() {
+        this->set_length(0);
+    }
+
+    bool Str::is_inline() const {
+        return ((u8)this->m_inline[STR_FLAG_BYTE] & 0x80) == 0;
+    }
+
+    u64 Str::length() const {
+        return this->is_inline() ? (u64)(u8)this->m_inline[STR_FLAG_BYTE] : this->m_heap.length;
+    }
+
+    u64 Str::capacity() const {
+        return this->is_inline() ? STR_INLINE_CAPACITY : (this->m_heap.capacity & ~STR_HEAP_FLAG);
+    }
+
+    char* Str::data() {
+        return this->is_inline() ? this->m_inline : this->m_heap.data;
+    }
+
+    const char* Str::c_str() const {
+        return this->is_inline() ? this->m_inline : this->m_heap.data;
+    }
+
+    DS::View<char> Str::view() const {
+        return DS::View<char>((char*)this->c_str(), this->length());
+    }
+
+    Memory::BaseAllocator* Str::allocator() const {
+        return this->m_allocator;
+    }
+
+    bool Str::operator==(const Str& other) const {
+        return String::equal(this->c_str(), this->length(), other.c_str(), other.length());
+    }
+
+    bool Str::operator==(DS::View<char> other) const {
+        return String::equal(this->c_str(), this->length(), other.data, other.length);
+    }
+
+    void Str::set_length(u64 length) {
+        if (this->is_inline()) {
+            this->m_inline[length] = '\0';
+            this->m_inline[STR_FLAG_BYTE] = (char)length;
+        } else {
+            this->m_heap.data[length] = '\0';
+            this->m_heap.length = length;
+        }
+    }
+
+    void Str::release() {
+        if (!this->is_inline()) {
+            this->m_allocator->free(this->m_heap.data);
+        }
+
+        Memory::zero(this->m_inline, sizeof(this->m_inline));
+    }
+}
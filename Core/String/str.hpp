@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../Common/common.hpp"
+#include "../Memory/memory.hpp"
+#include "../DataStructure/ds.hpp"
+
+#define STR_INLINE_CAPACITY 22
+
+namespace String {
+    /**
+     * Owning string with small string optimization, strings up to STR_INLINE_CAPACITY bytes
+     * live inside the struct and never touch the allocator. Longer strings are allocated
+     * through the allocator handed to the constructor, a Str without an allocator can only
+     * ever hold inline strings.
+     *
+     * The inline buffer has no pointer into itself, so a Str can be moved with a plain
+     * byte copy. Copies are explicit through clone(). Always null terminated.
+     */
+    struct Str {
+        Str();
+        Str(Memory::BaseAllocator* allocator);
+        Str(Memory::BaseAllocator* allocator, DS::View<char> str);
+        Str(Memory::BaseAllocator* allocator, const char* str, u64 str_length);
+        Str(Memory::BaseAllocator* allocator, const char* c_string);
+        ~Str();
+
+        // Prevent implicit copy, use clone()
+        Str(const Str& other) = delete;
+        Str& operator=(const Str& other) = delete;
+
+        Str(Str&& other);
+        Str& operator=(Str&& other);
+
+        Str clone() const;
+        Str clone(Memory::BaseAllocator* allocator) const;
+
+        void append(DS::View<char> str);
+        void append(const char* str, u64 str_length);
+        void append(const char* c_string);
+        void append_char(char c);
+
+        void reserve(u64 capacity);
+        void clear();
+
+        bool is_inline() const;
+        u64 length() const;
+        u64 capacity() const;
+        char* data();
+        const char* c_str() const;
+        DS::View<char> view() const;
+        Memory::BaseAllocator* allocator() const;
+
+        bool operator==(const Str& other) const;
+        bool operator==(DS::View<char> other) const;
+
+    private:
+        // Little endian: the last inline byte aliases the top byte of m_heap.capacity.
+        // Inline it holds the length, on the heap the top bit of capacity is set
+        // which no inline length can reach. Zeroed storage reads as an empty inline string.
+        struct HeapStorage {
+            char* data;
+            u64 length;
+            u64 capacity; // excludes the null terminator, top bit is the heap flag
+        };
+
+        Memory::BaseAllocator* m_allocator = nullptr;
+        union {
+            HeapStorage m_heap;
+            char m_inline[STR_INLINE_CAPACITY + 2];
+        };
+
+        void set_length(u64 length);
+        void release();
+    };
+
+    static_assert(sizeof(Str) == 32, "String::Str should be one pointer plus 24 bytes of storage");
+}
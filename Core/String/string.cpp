@@ -1,7 +1,350 @@
 #include "string.hpp"
 #include "../DataStructure/view.hpp"
 
+#include <string.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define STRING_SIMD_SSE2
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define STRING_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+// Needles longer than this switch to Two-Way once failed verifications cost more than
+// the bytes scanned so far, the worst case stays linear without slowing down normal text.
+#define STRING_SEARCH_TWO_WAY_THRESHOLD 64
+#define STRING_SEARCH_VERIFY_SLACK 1024
+#define STRING_SEARCH_BLOCK_SIZE 16
+
+#if defined(STRING_SIMD_NEON)
+    // vshrn packs each byte compare into a nibble
+    #define STRING_SEARCH_MASK_STRIDE 4
+    #define STRING_SEARCH_LANE_MASK 0xFULL
+#else
+    #define STRING_SEARCH_MASK_STRIDE 1
+    #define STRING_SEARCH_LANE_MASK 0x1ULL
+#endif
+
 namespace String {
+    internal inline u32 count_trailing_zeros(u64 value) {
+        #if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return (u32)index;
+        #else
+            return (u32)__builtin_ctzll(value);
+        #endif
+    }
+
+    internal inline u32 highest_set_bit(u64 value) {
+        #if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse64(&index, value);
+            return (u32)index;
+        #else
+            return 63 - (u32)__builtin_clzll(value);
+        #endif
+    }
+
+    // Marks every position p in a 16 byte block where p[0] == first and p[last_offset] == last,
+    // the (rare) positions that pass both are verified with memcmp.
+    struct FirstLastFilter {
+        #if defined(STRING_SIMD_SSE2)
+            __m128i first;
+            __m128i last;
+
+            FirstLastFilter(char first_char, char last_char) {
+                this->first = _mm_set1_epi8(first_char);
+                this->last = _mm_set1_epi8(last_char);
+            }
+
+            u64 match_mask(const char* block, u64 last_offset) const {
+                __m128i block_first = _mm_loadu_si128((const __m128i*)block);
+                __m128i block_last = _mm_loadu_si128((const __m128i*)(block + last_offset));
+                __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(block_first, this->first), _mm_cmpeq_epi8(block_last, this->last));
+
+                return (u64)(u32)_mm_movemask_epi8(eq);
+            }
+        #elif defined(STRING_SIMD_NEON)
+            uint8x16_t first;
+            uint8x16_t last;
+
+            FirstLastFilter(char first_char, char last_char) {
+                this->first = vdupq_n_u8((u8)first_char);
+                this->last = vdupq_n_u8((u8)last_char);
+            }
+
+            u64 match_mask(const char* block, u64 last_offset) const {
+                uint8x16_t block_first = vld1q_u8((const u8*)block);
+                uint8x16_t block_last = vld1q_u8((const u8*)(block + last_offset));
+                uint8x16_t eq = vandq_u8(vceqq_u8(block_first, this->first), vceqq_u8(block_last, this->last));
+                uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+
+                return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+            }
+        #else
+            char first;
+            char last;
+
+            FirstLastFilter(char first_char, char last_char) {
+                this->first = first_char;
+                this->last = last_char;
+            }
+
+            u64 match_mask(const char* block, u64 last_offset) const {
+                u64 mask = 0;
+                for (u64 i = 0; i < STRING_SEARCH_BLOCK_SIZE; i++) {
+                    mask |= (u64)((block[i] == this->first) & (block[i + last_offset] == this->last)) << i;
+                }
+
+                return mask;
+            }
+        #endif
+    };
+
+    // Two-Way (Crochemore-Perrin) is written against these accessors so last_index_of can
+    // run the exact same algorithm over the reversed haystack and needle without copying them.
+    struct ForwardBytes {
+        const char* data;
+        u64 length;
+
+        u8 operator[](u64 i) const {
+            return (u8)this->data[i];
+        }
+    };
+
+    struct ReverseBytes {
+        const char* data;
+        u64 length;
+
+        u8 operator[](u64 i) const {
+            return (u8)this->data[this->length - 1 - i];
+        }
+    };
+
+    // Returns the critical position of the needle, out_period is the period of the right half
+    template <typename Bytes>
+    internal u64 critical_factorization(Bytes needle, u64* out_period) {
+        const u64 NONE = (u64)-1;
+
+        // maximal suffix under <
+        u64 max_suffix = NONE;
+        u64 j = 0;
+        u64 k = 1;
+        u64 period = 1;
+        while (j + k < needle.length) {
+            u8 a = needle[j + k];
+            u8 b = needle[max_suffix + k];
+            if (a < b) {
+                j += k;
+                k = 1;
+                period = j - max_suffix;
+            } else if (a == b) {
+                if (k != period) {
+                    k += 1;
+                } else {
+                    j += period;
+                    k = 1;
+                }
+            } else {
+                max_suffix = j++;
+                k = period = 1;
+            }
+        }
+        *out_period = period;
+
+        // maximal suffix under >
+        u64 max_suffix_reverse = NONE;
+        j = 0;
+        k = 1;
+        period = 1;
+        while (j + k < needle.length) {
+            u8 a = needle[j + k];
+            u8 b = needle[max_suffix_reverse + k];
+            if (b < a) {
+                j += k;
+                k = 1;
+                period = j - max_suffix_reverse;
+            } else if (a == b) {
+                if (k != period) {
+                    k += 1;
+                } else {
+                    j += period;
+                    k = 1;
+                }
+            } else {
+                max_suffix_reverse = j++;
+                k = period = 1;
+            }
+        }
+
+        // NONE + 1 wraps to 0 which is what makes these comparisons work
+        if (max_suffix_reverse + 1 < max_suffix + 1) {
+            return max_suffix + 1;
+        }
+
+        *out_period = period;
+        return max_suffix_reverse + 1;
+    }
+
+    template <typename Bytes>
+    internal s64 two_way_search(Bytes haystack, Bytes needle) {
+        const u64 NONE = (u64)-1;
+        const u64 n = haystack.length;
+        const u64 m = needle.length;
+
+        u64 period = 0;
+        u64 suffix = critical_factorization(needle, &period);
+
+        bool periodic = true;
+        for (u64 i = 0; i < suffix; i++) {
+            if (needle[i] != needle[i + period]) {
+                periodic = false;
+                break;
+            }
+        }
+
+        u64 j = 0;
+        if (periodic) {
+            // memory remembers how much of the left half is known to match after a period shift
+            u64 memory = 0;
+            while (j <= n - m) {
+                u64 i = MAX(suffix, memory);
+                while (i < m && needle[i] == haystack[i + j]) {
+                    i += 1;
+                }
+
+                if (i >= m) {
+                    i = suffix - 1;
+                    while (memory < i + 1 && needle[i] == haystack[i + j]) {
+                        i -= 1;
+                    }
+
+                    if (i + 1 < memory + 1) {
+                        return (s64)j;
+                    }
+
+                    j += period;
+                    memory = m - period;
+                } else {
+                    j += i - suffix + 1;
+                    memory = 0;
+                }
+            }
+        } else {
+            period = MAX(suffix, m - suffix) + 1;
+            while (j <= n - m) {
+                u64 i = suffix;
+                while (i < m && needle[i] == haystack[i + j]) {
+                    i += 1;
+                }
+
+                if (i >= m) {
+                    i = suffix - 1;
+                    while (i != NONE && needle[i] == haystack[i + j]) {
+                        i -= 1;
+                    }
+
+                    if (i == NONE) {
+                        return (s64)j;
+                    }
+
+                    j += period;
+                } else {
+                    j += i - suffix + 1;
+                }
+            }
+        }
+
+        return -1;
+    }
+
+    internal inline bool verify_candidate(const char* candidate, const char* substring, u64 substring_length) {
+        // first and last byte already matched
+        return substring_length <= 2 || memcmp(candidate + 1, substring + 1, substring_length - 2) == 0;
+    }
+
+    internal s64 first_last_search_forward(const char* str, u64 str_length, const char* substring, u64 substring_length) {
+        const u64 last_offset = substring_length - 1;
+        FirstLastFilter filter = FirstLastFilter(substring[0], substring[last_offset]);
+
+        const bool bounded = substring_length > STRING_SEARCH_TWO_WAY_THRESHOLD;
+        u64 verify_work = 0;
+
+        u64 i = 0;
+        for (; i + last_offset + STRING_SEARCH_BLOCK_SIZE <= str_length; i += STRING_SEARCH_BLOCK_SIZE) {
+            u64 mask = filter.match_mask(str + i, last_offset);
+            while (mask) {
+                u32 bit = count_trailing_zeros(mask);
+                u64 candidate = i + (bit / STRING_SEARCH_MASK_STRIDE);
+                if (verify_candidate(str + candidate, substring, substring_length)) {
+                    return (s64)candidate;
+                }
+
+                verify_work += substring_length;
+                if (bounded && verify_work > i + STRING_SEARCH_VERIFY_SLACK) {
+                    s64 index = two_way_search(ForwardBytes{str + i, str_length - i}, ForwardBytes{substring, substring_length});
+                    return index == -1 ? -1 : (s64)i + index;
+                }
+
+                mask &= ~(STRING_SEARCH_LANE_MASK << bit);
+            }
+        }
+
+        for (; i + substring_length <= str_length; i++) {
+            if (str[i] == substring[0] && str[i + last_offset] == substring[last_offset] && verify_candidate(str + i, substring, substring_length)) {
+                return (s64)i;
+            }
+        }
+
+        return -1;
+    }
+
+    // Same filter walking blocks from the end, so the first verified hit is the last match
+    internal s64 first_last_search_reverse(const char* str, u64 str_length, const char* substring, u64 substring_length) {
+        const u64 last_offset = substring_length - 1;
+        FirstLastFilter filter = FirstLastFilter(substring[0], substring[last_offset]);
+
+        const bool bounded = substring_length > STRING_SEARCH_TWO_WAY_THRESHOLD;
+        u64 verify_work = 0;
+
+        s64 end = (s64)(str_length - substring_length); // highest candidate still unchecked
+        for (; end >= STRING_SEARCH_BLOCK_SIZE - 1; end -= STRING_SEARCH_BLOCK_SIZE) {
+            u64 block = (u64)end - (STRING_SEARCH_BLOCK_SIZE - 1);
+            u64 mask = filter.match_mask(str + block, last_offset);
+            while (mask) {
+                u32 lane = highest_set_bit(mask) / STRING_SEARCH_MASK_STRIDE;
+                u64 candidate = block + lane;
+                if (verify_candidate(str + candidate, substring, substring_length)) {
+                    return (s64)candidate;
+                }
+
+                verify_work += substring_length;
+                if (bounded && verify_work > (str_length - block) + STRING_SEARCH_VERIFY_SLACK) {
+                    // the first match of the reversed needle in the reversed prefix is the last match
+                    u64 prefix_length = (u64)end + substring_length;
+                    s64 index = two_way_search(ReverseBytes{str, prefix_length}, ReverseBytes{substring, substring_length});
+                    return index == -1 ? -1 : end - index;
+                }
+
+                mask &= ~(STRING_SEARCH_LANE_MASK << (lane * STRING_SEARCH_MASK_STRIDE));
+            }
+        }
+
+        for (; end >= 0; end--) {
+            if (str[end] == substring[0] && str[end + last_offset] == substring[last_offset] && verify_candidate(str + end, substring, substring_length)) {
+                return end;
+            }
+        }
+
+        return -1;
+    }
+
     char* allocate(Memory::BaseAllocator* allocator, const char* s1, u64 length) {
         char* ret = (char*)allocator->malloc(length + 1);
         Memory::copy(ret, length, s1, length);
@@ -10,37 +353,31 @@ namespace String {
     }
 
     char* sprintf(Memory::BaseAllocator* allocator, u64* out_buffer_length, const char* fmt ...) {
-        va_list args, copy_args;
+        va_list args;
         va_start(args, fmt);
-            va_copy(copy_args, args);
-            u64 allocation_ret = (u64)vsnprintf(nullptr, 0, fmt, copy_args) + 1; // +1 for null terminator
-            va_end(copy_args);
-
-            char* buffer = (char*)allocator->malloc(allocation_ret);
-
-            va_copy(copy_args, args);
-            vsnprintf(buffer, allocation_ret, fmt, copy_args);
-            va_end(copy_args);
+            char* buffer = String::sprintf(allocator, out_buffer_length, fmt, args);
         va_end(args);
 
-        if (out_buffer_length) {
-            *out_buffer_length = allocation_ret - 1;
-        }
-
         return buffer;
     }
     
     char* sprintf(Memory::BaseAllocator* allocator, u64* out_buffer_length, const char* fmt, va_list args) {
+        // Most results fit on the stack, so the format string is only parsed a second time for long output
+        char stack_buffer[256];
+
         va_list args_copy;
         va_copy(args_copy, args);
-        u64 allocation_ret = (u64)vsnprintf(nullptr, 0, fmt, args_copy) + 1; // +1 for null terminator
+        u64 allocation_ret = (u64)vsnprintf(stack_buffer, sizeof(stack_buffer), fmt, args_copy) + 1; // +1 for null terminator
         va_end(args_copy);
 
         char* buffer = (char*)allocator->malloc(allocation_ret);
-
-        va_copy(args_copy, args);
-        vsnprintf(buffer, allocation_ret, fmt, args_copy);
-        va_end(args_copy);
+        if (allocation_ret <= sizeof(stack_buffer)) {
+            Memory::copy(buffer, allocation_ret, stack_buffer, allocation_ret);
+        } else {
+            va_copy(args_copy, args);
+            vsnprintf(buffer, allocation_ret, fmt, args_copy);
+            va_end(args_copy);
+        }
 
         if (out_buffer_length) {
             *out_buffer_length = allocation_ret - 1;
@@ -49,13 +386,88 @@ namespace String {
         return buffer;
     }
 
-    u64 length(const char* c_string) {
-        u64 ret = 0;
-        while (*c_string++ != '\0') {
-            ret += 1;
-        } 
+    // Aligned loads never cross a page boundary, so reading past the terminator inside the block is safe.
+    // The bytes before the string in the first block are masked off.
+    // Memory protection is per page, so those bytes can't fault, but AddressSanitizer and ThreadSanitizer track
+    // every byte and would report them as an overflow or a use after free of the neighbouring allocation.
+    // The word at a time fallback reads aligned words the same way.
+    NO_SANITIZE_ADDRESS NO_SANITIZE_THREAD u64 length(const char* c_string) {
+        RUNTIME_ASSERT(c_string);
+
+        #if defined(STRING_SIMD_SSE2)
+            const __m128i zero = _mm_setzero_si128();
+            const u64 misalignment = (u64)((uintptr_t)c_string & 15);
+            const char* block = c_string - misalignment;
+
+            u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)block), zero)) >> misalignment;
+            if (mask) {
+                return count_trailing_zeros(mask);
+            }
+            block += 16;
+
+            // one more single block so the pairs below are 32 byte aligned and stay inside one page
+            if ((uintptr_t)block & 31) {
+                mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)block), zero));
+                if (mask) {
+                    return (u64)(block - c_string) + count_trailing_zeros(mask);
+                }
+                block += 16;
+            }
 
-        return ret;
+            while (true) {
+                __m128i first = _mm_load_si128((const __m128i*)block);
+                __m128i second = _mm_load_si128((const __m128i*)(block + 16));
+                // min is zero in every lane where either block has a zero
+                __m128i either = _mm_cmpeq_epi8(_mm_min_epu8(first, second), zero);
+                if (_mm_movemask_epi8(either)) {
+                    u64 combined = (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(first, zero)) | ((u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(second, zero)) << 16);
+                    return (u64)(block - c_string) + count_trailing_zeros(combined);
+                }
+
+                block += 32;
+            }
+        #elif defined(STRING_SIMD_NEON)
+            const u64 misalignment = (u64)((uintptr_t)c_string & 15);
+            const char* block = c_string - misalignment;
+
+            uint8x16_t is_zero = vceqzq_u8(vld1q_u8((const u8*)block));
+            u64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(is_zero), 4)), 0) >> (misalignment * STRING_SEARCH_MASK_STRIDE);
+            while (!mask) {
+                block += 16;
+                is_zero = vceqzq_u8(vld1q_u8((const u8*)block));
+                mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(is_zero), 4)), 0);
+                if (mask) {
+                    return (u64)(block - c_string) + (count_trailing_zeros(mask) / STRING_SEARCH_MASK_STRIDE);
+                }
+            }
+
+            return count_trailing_zeros(mask) / STRING_SEARCH_MASK_STRIDE;
+        #else
+            // word at a time: (word - 0x01..) & ~word & 0x80.. is non zero iff a byte is zero
+            const u64 LOW_BITS = 0x0101010101010101ULL;
+            const u64 HIGH_BITS = 0x8080808080808080ULL;
+
+            const char* cursor = c_string;
+            while ((uintptr_t)cursor & 7) {
+                if (*cursor == '\0') {
+                    return (u64)(cursor - c_string);
+                }
+
+                cursor += 1;
+            }
+
+            const u64* word = (const u64*)cursor;
+            while (((*word - LOW_BITS) & ~*word & HIGH_BITS) == 0) {
+                word += 1;
+            }
+
+            cursor = (const char*)word;
+            while (*cursor != '\0') {
+                cursor += 1;
+            }
+
+            return (u64)(cursor - c_string);
+        #endif
     }
 
     bool equal(const char* s1, u64 s1_length, const char* s2, u64 s2_length) {
@@ -81,25 +493,13 @@ namespace String {
         if (substring_length > str_length) {
             return -1;
         }
-        
-        s64 ret_index = -1;
-        for (u64 i = 0; i <= str_length - substring_length; i++) {
-            if (ret_index != -1) {
-                break;
-            }
-            
-            if (str[i] != substring[0]) {
-                continue;
-            }
 
-            DS::View<char> current_view = DS::View(str + i, substring_length);
-            if (String::equal(substring, substring_length, current_view.data, current_view.length)) {
-                ret_index = (s64)i;
-                break;
-            }
+        if (substring_length == 1) {
+            const char* found = (const char*)memchr(str, substring[0], str_length);
+            return found ? (s64)(found - str) : -1;
         }
 
-        return ret_index; // returns -1 if not found
+        return first_last_search_forward(str, str_length, substring, substring_length);
     }
 
     bool contains(const char* str, u64 str_length, const char* contains, u64 contains_length) {
@@ -124,20 +524,8 @@ namespace String {
         if (substring_length > str_length) {
             return -1;
         }
-        
-        s64 ret_index = -1;
-        for (u64 i = 0; i <= (str_length - substring_length); i++) {
-            if (str[i] != substring[0]) {
-                continue;
-            }
-
-            DS::View<char> current_view = DS::View(str + i, substring_length);
-            if (String::equal(current_view.data, current_view.length, substring, substring_length)) {
-                ret_index = (s64)i;
-            }
-        }
 
-        return ret_index; // returns -1 if not found
+        return first_last_search_reverse(str, str_length, substring, substring_length);
     }
 
     bool starts_with(const char* str, u64 str_length, const char* starts_with, u64 starts_with_length) {
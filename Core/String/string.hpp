@@ -7,12 +7,40 @@
 #include <cstdarg>
 #include <cstdio>
 
+// Big enough for any format_int/format_u64/format_hex result plus the null terminator
+#define STRING_FORMAT_INT_BUFFER_SIZE 24
+// Fixed notation of the longest float: "-0." + 44 zeros + 9 digits + null terminator
+#define STRING_FORMAT_FLOAT_BUFFER_SIZE 64
+
 namespace String {
+    enum NumberKind {
+        NUMBER_INVALID,
+        NUMBER_INTEGER,
+        NUMBER_FLOAT,
+        NUMBER_INTEGER_OVERFLOW, // looked like an integer but doesn't fit in s64
+    };
+
     char* allocate(Memory::BaseAllocator* allocator, const char* s1, u64 length);
     char* sprintf(Memory::BaseAllocator* allocator, u64* out_buffer_length, const char* fmt ...);
     char* sprintf(Memory::BaseAllocator* allocator, u64* out_buffer_length, const char* fmt, va_list args);
 
+    // Allocation free number formatting, writes a null terminated string into buffer and returns its length
+    u64 format_int(s64 value, char* buffer, u64 buffer_capacity);
+    u64 format_u64(u64 value, char* buffer, u64 buffer_capacity);
+    u64 format_hex(u64 value, char* buffer, u64 buffer_capacity); // lowercase, no 0x prefix
+    u64 format_float(float value, char* buffer, u64 buffer_capacity); // shortest text that reads back as the same float
+
+    // One pass over the view, the whole view has to match or it is NUMBER_INVALID:
+    //     integer: [+-]digits
+    //     float:   [+-]digits.[digits][e[+-]digits], [+-].digits[e[+-]digits] or [+-]digits e[+-]digits
+    // so "1." and ".5" are floats, "." and "1e" are not
+    NumberKind parse_number(DS::View<char> str, s64* out_integer, float* out_floating);
+
     u64 length(const char* c_string);
+
+    // Validates the whole buffer, on failure out_error_offset is the first byte of the first invalid sequence.
+    // Overlong encodings, surrogates, code points above U+10FFFF and truncated sequences are all invalid.
+    bool utf8_validate(const char* data, u64 length, u64* out_error_offset = nullptr);
     bool equal(const char* s1, u64 s1_length, const char* s2, u64 s2_length);
     bool equal(DS::View<char> s1, DS::View<char> s2);
     bool contains(const char* s1, u64 s1_length, const char* contains, u64 contains_length);
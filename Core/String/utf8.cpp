@@ -0,0 +1,372 @@
+#include "string.hpp"
+
+#include <atomic>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define UTF8_SIMD_SSSE3
+    #include <tmmintrin.h>
+    #if defined(_MSC_VER)
+        #define TARGET_SSSE3
+    #else
+        #define TARGET_SSSE3 __attribute__((target("ssse3")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define UTF8_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+#define UTF8_BLOCK_SIZE 16
+
+// Error bits of the lookup tables, a byte pair is invalid when all three lookups agree on a bit.
+// https://arxiv.org/abs/2010.03090 (Keiser, Lemire: Validating UTF-8 In Less Than One Instruction Per Byte)
+#define UTF8_TOO_SHORT      (1 << 0) // lead byte not followed by a continuation
+#define UTF8_TOO_LONG       (1 << 1) // ascii followed by a continuation
+#define UTF8_OVERLONG_3     (1 << 2)
+#define UTF8_TOO_LARGE      (1 << 3) // above U+10FFFF
+#define UTF8_SURROGATE      (1 << 4)
+#define UTF8_OVERLONG_2     (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4     (1 << 6)
+#define UTF8_TWO_CONTS      (1 << 7) // continuation after continuation, only valid inside 3 and 4 byte sequences
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+namespace String {
+    // Returns the offset of the first byte of the first invalid sequence, or length if the buffer is valid
+    internal u64 utf8_first_error_scalar(const u8* data, u64 start, u64 length) {
+        u64 i = start;
+        while (i < length) {
+            // ascii runs a word at a time
+            while (i + 8 <= length) {
+                u64 word;
+                Memory::copy(&word, sizeof(word), data + i, sizeof(word));
+                if (word & 0x8080808080808080ULL) {
+                    break;
+                }
+
+                i += 8;
+            }
+
+            if (i >= length) {
+                break;
+            }
+
+            u8 lead = data[i];
+            if (lead < 0x80) {
+                i += 1;
+                continue;
+            }
+
+            u64 sequence_length = 0;
+            u8 min_second = 0x80;
+            u8 max_second = 0xBF;
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                sequence_length = 2;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                sequence_length = 3;
+                if (lead == 0xE0) {
+                    min_second = 0xA0; // overlong
+                } else if (lead == 0xED) {
+                    max_second = 0x9F; // surrogates
+                }
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                sequence_length = 4;
+                if (lead == 0xF0) {
+                    min_second = 0x90; // overlong
+                } else if (lead == 0xF4) {
+                    max_second = 0x8F; // above U+10FFFF
+                }
+            } else {
+                return i; // stray continuation, C0/C1 overlong or F5..FF
+            }
+
+            if (i + sequence_length > length) {
+                return i;
+            }
+
+            u8 second = data[i + 1];
+            if (second < min_second || second > max_second) {
+                return i;
+            }
+
+            for (u64 k = 2; k < sequence_length; k++) {
+                if ((data[i + k] & 0xC0) != 0x80) {
+                    return i;
+                }
+            }
+
+            i += sequence_length;
+        }
+
+        return length;
+    }
+
+    // SIMD only reports the block, the bad sequence may have started up to 3 bytes before it
+    internal u64 utf8_locate_error(const u8* data, u64 length, u64 block_start) {
+        u64 start = block_start > 3 ? block_start - 3 : 0;
+        for (int i = 0; i < 3 && start > 0 && (data[start] & 0xC0) == 0x80; i++) {
+            start -= 1;
+        }
+
+        return utf8_first_error_scalar(data, start, length);
+    }
+
+    #if defined(UTF8_SIMD_SSSE3)
+        internal bool has_ssse3() {
+            #if defined(_MSC_VER)
+                int info[4] = {0};
+                __cpuid(info, 1);
+                return (info[2] >> 9) & 1;
+            #else
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("ssse3");
+            #endif
+        }
+
+        TARGET_SSSE3 internal inline __m128i utf8_block_errors(__m128i input, __m128i previous) {
+            const __m128i byte_1_high_table = _mm_setr_epi8(
+                // 0_______ ascii
+                UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+                UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+                // 10______ continuation
+                UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+                // 1100____
+                UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+                // 1101____
+                UTF8_TOO_SHORT,
+                // 1110____
+                UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+                // 1111____
+                UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+            );
+
+            const __m128i byte_1_low_table = _mm_setr_epi8(
+                UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, // ____0000
+                UTF8_CARRY | UTF8_OVERLONG_2,                                     // ____0001
+                UTF8_CARRY,
+                UTF8_CARRY,
+                UTF8_CARRY | UTF8_TOO_LARGE,                                      // ____0100
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE, // ____1101
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+            );
+
+            const __m128i byte_2_high_table = _mm_setr_epi8(
+                // 0_______ ascii
+                UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+                UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+                // 1000____
+                (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4),
+                // 1001____
+                (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE),
+                // 101_____
+                (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+                (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+                // 11______
+                UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+            );
+
+            const __m128i low_nibble = _mm_set1_epi8(0x0F);
+
+            __m128i previous_1 = _mm_alignr_epi8(input, previous, 16 - 1);
+            __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(previous_1, 4), low_nibble));
+            __m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(previous_1, low_nibble));
+            __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+            __m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+            // the 3rd and 4th byte of a sequence must be continuations, that is the only case TWO_CONTS is allowed
+            __m128i previous_2 = _mm_alignr_epi8(input, previous, 16 - 2);
+            __m128i previous_3 = _mm_alignr_epi8(input, previous, 16 - 3);
+            __m128i is_third_byte = _mm_subs_epu8(previous_2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+            __m128i is_fourth_byte = _mm_subs_epu8(previous_3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+            __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8((char)0x80));
+
+            return _mm_xor_si128(must_be_continuation, special_cases);
+        }
+
+        // Non-zero when the block ends inside a multi byte sequence
+        TARGET_SSSE3 internal inline __m128i utf8_incomplete(__m128i input) {
+            const __m128i max_complete = _mm_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1)
+            );
+
+            return _mm_subs_epu8(input, max_complete);
+        }
+
+        TARGET_SSSE3 internal u64 utf8_first_error_ssse3(const u8* data, u64 length) {
+            __m128i previous = _mm_setzero_si128();
+            __m128i previous_incomplete = _mm_setzero_si128();
+
+            const __m128i zero = _mm_setzero_si128();
+
+            u64 i = 0;
+            while (i + UTF8_BLOCK_SIZE <= length) {
+                __m128i input = _mm_loadu_si128((const __m128i*)(data + i));
+                bool is_ascii = _mm_movemask_epi8(input) == 0;
+
+                // ascii is only wrong if the last block left a sequence open
+                __m128i errors = is_ascii ? previous_incomplete : utf8_block_errors(input, previous);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(errors, zero)) != 0xFFFF) {
+                    return utf8_locate_error(data, length, i);
+                }
+
+                previous_incomplete = is_ascii ? zero : utf8_incomplete(input);
+                previous = input;
+                i += UTF8_BLOCK_SIZE;
+            }
+
+            // the zero padding reads as ascii, so a sequence cut off by the end of the buffer fails like any other
+            u8 tail[UTF8_BLOCK_SIZE] = {0};
+            Memory::copy(tail, sizeof(tail), data + i, length - i);
+
+            __m128i errors = _mm_or_si128(utf8_block_errors(_mm_loadu_si128((const __m128i*)tail), previous), previous_incomplete);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(errors, zero)) != 0xFFFF) {
+                return utf8_locate_error(data, length, i);
+            }
+
+            return length;
+        }
+    #elif defined(UTF8_SIMD_NEON)
+        internal inline uint8x16_t utf8_block_errors(uint8x16_t input, uint8x16_t previous) {
+            const u8 byte_1_high_bytes[16] = {
+                UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+                UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+                UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+                UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+                UTF8_TOO_SHORT,
+                UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+                UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+            };
+
+            const u8 byte_1_low_bytes[16] = {
+                UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+                UTF8_CARRY | UTF8_OVERLONG_2,
+                UTF8_CARRY,
+                UTF8_CARRY,
+                UTF8_CARRY | UTF8_TOO_LARGE,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+                UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+            };
+
+            const u8 byte_2_high_bytes[16] = {
+                UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+                UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+                UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+                UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+                UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+                UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+                UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+            };
+
+            uint8x16_t previous_1 = vextq_u8(previous, input, 16 - 1);
+            uint8x16_t byte_1_high = vqtbl1q_u8(vld1q_u8(byte_1_high_bytes), vshrq_n_u8(previous_1, 4));
+            uint8x16_t byte_1_low = vqtbl1q_u8(vld1q_u8(byte_1_low_bytes), vandq_u8(previous_1, vdupq_n_u8(0x0F)));
+            uint8x16_t byte_2_high = vqtbl1q_u8(vld1q_u8(byte_2_high_bytes), vshrq_n_u8(input, 4));
+            uint8x16_t special_cases = vandq_u8(vandq_u8(byte_1_high, byte_1_low), byte_2_high);
+
+            uint8x16_t previous_2 = vextq_u8(previous, input, 16 - 2);
+            uint8x16_t previous_3 = vextq_u8(previous, input, 16 - 3);
+            uint8x16_t is_third_byte = vqsubq_u8(previous_2, vdupq_n_u8(0xE0 - 0x80));
+            uint8x16_t is_fourth_byte = vqsubq_u8(previous_3, vdupq_n_u8(0xF0 - 0x80));
+            uint8x16_t must_be_continuation = vandq_u8(vorrq_u8(is_third_byte, is_fourth_byte), vdupq_n_u8(0x80));
+
+            return veorq_u8(must_be_continuation, special_cases);
+        }
+
+        internal inline uint8x16_t utf8_incomplete(uint8x16_t input) {
+            const u8 max_complete_bytes[16] = {
+                0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+            };
+
+            return vqsubq_u8(input, vld1q_u8(max_complete_bytes));
+        }
+
+        internal u64 utf8_first_error_neon(const u8* data, u64 length) {
+            uint8x16_t previous = vdupq_n_u8(0);
+            uint8x16_t previous_incomplete = vdupq_n_u8(0);
+
+            u64 i = 0;
+            while (i + UTF8_BLOCK_SIZE <= length) {
+                uint8x16_t input = vld1q_u8(data + i);
+                bool is_ascii = vmaxvq_u8(input) < 0x80;
+
+                uint8x16_t errors = is_ascii ? previous_incomplete : utf8_block_errors(input, previous);
+                if (vmaxvq_u8(errors) != 0) {
+                    return utf8_locate_error(data, length, i);
+                }
+
+                previous_incomplete = is_ascii ? vdupq_n_u8(0) : utf8_incomplete(input);
+                previous = input;
+                i += UTF8_BLOCK_SIZE;
+            }
+
+            u8 tail[UTF8_BLOCK_SIZE] = {0};
+            Memory::copy(tail, sizeof(tail), data + i, length - i);
+
+            uint8x16_t errors = vorrq_u8(utf8_block_errors(vld1q_u8(tail), previous), previous_incomplete);
+            if (vmaxvq_u8(errors) != 0) {
+                return utf8_locate_error(data, length, i);
+            }
+
+            return length;
+        }
+    #endif
+
+    typedef u64(Utf8FirstErrorFunction)(const u8* data, u64 length);
+    internal u64 resolve_utf8_first_error(const u8* data, u64 length);
+
+    internal u64 utf8_first_error_fallback(const u8* data, u64 length) {
+        return utf8_first_error_scalar(data, 0, length);
+    }
+
+    // Starts at the resolver, the first call swaps in the implementation the cpu supports.
+    // Parallel lex workers can all hit the first call, atomic so they may race to store the same pointer.
+    global std::atomic<Utf8FirstErrorFunction*> g_utf8_first_error = resolve_utf8_first_error;
+
+    internal u64 resolve_utf8_first_error(const u8* data, u64 length) {
+        #if defined(UTF8_SIMD_SSSE3)
+            Utf8FirstErrorFunction* first_error = has_ssse3() ? utf8_first_error_ssse3 : utf8_first_error_fallback;
+        #elif defined(UTF8_SIMD_NEON)
+            Utf8FirstErrorFunction* first_error = utf8_first_error_neon;
+        #else
+            Utf8FirstErrorFunction* first_error = utf8_first_error_fallback;
+        #endif
+
+        g_utf8_first_error.store(first_error, std::memory_order_relaxed);
+
+        return first_error(data, length);
+    }
+
+    bool utf8_validate(const char* data, u64 length, u64* out_error_offset) {
+        RUNTIME_ASSERT(data || length == 0);
+
+        u64 error_offset = length ? g_utf8_first_error.load(std::memory_order_relaxed)((const u8*)data, length) : 0;
+        if (out_error_offset) {
+            *out_error_offset = error_offset;
+        }
+
+        return error_offset == length;
+    }
+}
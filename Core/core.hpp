@@ -4,8 +4,16 @@
 #include "DataStructure/ds.hpp"
 #include "Memory/memory.hpp"
 #include "String/string.hpp"
+#include "String/interner.hpp"
+#include "String/builder.hpp"
+#include "String/str.hpp"
+#include "String/split.hpp"
+#include "String/rope.hpp"
 #include "Platform/platform.hpp"
 
 #include "Lexer/lexer.hpp"
+#include "Lexer/token_stream.hpp"
+#include "Lexer/source_map.hpp"
+#include "Lexer/token_cache.hpp"
 #include "Parser/parser.hpp"
 #include "JSON/json.hpp"
@@ -1,4 +1,5 @@
 #include <Core/core.hpp>
+#include <cstdlib>
 
 struct Point {
     int x;
@@ -242,7 +243,1959 @@ void test_clear() {
     LOG_INFO("test_clear passed\n");
 }
 
+void test_string_hash() {
+    char a[80] = {0};
+    char b[80] = {0};
+    for (int i = 0; i < 64; i++) {
+        a[i] = (char)('a' + (i % 26));
+        b[i] = a[i];
+    }
+
+    for (u64 length = 0; length <= 64; length++) {
+        RUNTIME_ASSERT(Hashing::string_hash(a, length) == Hashing::string_hash(b, length));
+        if (length > 0) {
+            RUNTIME_ASSERT(Hashing::string_hash(a, length) != Hashing::string_hash(a, length - 1));
+        }
+
+        b[length / 2] ^= 1;
+        if (length > 0) {
+            RUNTIME_ASSERT(Hashing::string_hash(a, length) != Hashing::string_hash(b, length));
+        }
+        b[length / 2] ^= 1;
+    }
+
+    // keys ending right before a page boundary take the padded tail path
+    alignas(4096) static char paged[8192];
+    for (u64 length = 0; length < 16; length++) {
+        char* at_boundary = paged + 4096 - length;
+        for (u64 i = 0; i < length; i++) {
+            at_boundary[i] = a[i];
+        }
+
+        RUNTIME_ASSERT(Hashing::string_hash(at_boundary, length) == Hashing::string_hash(a, length));
+    }
+
+    RUNTIME_ASSERT(Hashing::cstring_equality("apple", 5, "apple", 0));
+    RUNTIME_ASSERT(!Hashing::cstring_equality("apple", 5, "apple+pen", 0));
+    RUNTIME_ASSERT(!Hashing::cstring_equality("apple+pen", 9, "apple", 0));
+    LOG_INFO("test_string_hash passed\n");
+}
+
+void test_streaming_hasher() {
+    u8 data[1000];
+    for (int i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (u8)((i * 131) ^ (i >> 3));
+    }
+
+    Hashing::Hash128 expected = Hashing::fingerprint128(data, sizeof(data));
+    const u64 chunk_sizes[] = {1, 3, 16, 63, 64, 65, 200, 999};
+    for (u64 chunk_size : chunk_sizes) {
+        Hashing::Hasher hasher = Hashing::Hasher();
+        for (u64 offset = 0; offset < sizeof(data); offset += chunk_size) {
+            hasher.update(data + offset, MIN(chunk_size, sizeof(data) - offset));
+        }
+
+        RUNTIME_ASSERT(hasher.finish128() == expected);
+        RUNTIME_ASSERT(hasher.finish() == expected.low);
+    }
+
+    // Trailing zero bytes must change the fingerprint even though the last stripe is zero padded
+    u8 zeros[65] = {0};
+    RUNTIME_ASSERT(Hashing::fingerprint128(zeros, 1) != Hashing::fingerprint128(zeros, 2));
+    RUNTIME_ASSERT(Hashing::fingerprint128(zeros, 64) != Hashing::fingerprint128(zeros, 65));
+
+    Hashing::Hasher seeded = Hashing::Hasher(1234);
+    seeded.update(data, sizeof(data));
+    RUNTIME_ASSERT(seeded.finish128() != expected);
+
+    data[500] ^= 1;
+    RUNTIME_ASSERT(Hashing::fingerprint128(data, sizeof(data)) != expected);
+    LOG_INFO("test_streaming_hasher passed\n");
+}
+
+void test_hash_many() {
+    const char* source = "identifier_alpha beta gamma_delta_epsilon_zeta_eta_theta iota kappa lambda_mu_nu_xi_omicron_pi_rho";
+    u64 source_length = String::length(source);
+
+    DS::View<char> views[37];
+    u64 hashes[37];
+    for (u64 i = 0; i < ArrayCount(views); i++) {
+        u64 offset = (i * 7) % 40;
+        views[i] = DS::View<char>(source + offset, (i * 13) % (source_length - offset));
+    }
+
+    Hashing::hash_many(views, ArrayCount(views), hashes);
+    for (u64 i = 0; i < ArrayCount(views); i++) {
+        RUNTIME_ASSERT(hashes[i] == Hashing::string_view_hash(&views[i], 0));
+    }
+
+    Point points[37];
+    for (int i = 0; i < (int)ArrayCount(points); i++) {
+        points[i] = {i, i * -3};
+    }
+
+    Hashing::hash_many(points, sizeof(Point), sizeof(Point), ArrayCount(points), hashes);
+    for (u64 i = 0; i < ArrayCount(points); i++) {
+        RUNTIME_ASSERT(hashes[i] == Hashing::fast_hash(&points[i], sizeof(Point)));
+    }
+
+    // strided keys, hashing the x member in place
+    Hashing::hash_many(&points[0].x, sizeof(int), sizeof(Point), ArrayCount(points), hashes);
+    for (u64 i = 0; i < ArrayCount(points); i++) {
+        RUNTIME_ASSERT(hashes[i] == Hashing::fast_hash(&points[i].x, sizeof(int)));
+    }
+
+    LOG_INFO("test_hash_many passed\n");
+}
+
+void test_put_many() {
+    int keys[500];
+    int values[500];
+    for (int i = 0; i < 500; i++) {
+        keys[i] = i * 17;
+        values[i] = i;
+    }
+
+    DS::Hashmap<int, int> map = DS::Hashmap<int, int>(&Memory::global_general_allocator);
+    map.put_many(keys, values, 500);
+    RUNTIME_ASSERT(map.count() == 500);
+    for (int i = 0; i < 500; i++) {
+        RUNTIME_ASSERT(map.get(i * 17) == i);
+    }
+
+    const char* names[] = {"alpha", "beta", "gamma", "delta", "epsilon"};
+    int name_values[] = {1, 2, 3, 4, 5};
+    DS::Hashmap<const char*, int> name_map = DS::Hashmap<const char*, int>(&Memory::global_general_allocator);
+    name_map.put_many(names, name_values, ArrayCount(names));
+    for (int i = 0; i < 100; i++) {
+        name_map.put(String::sprintf(&Memory::global_general_allocator, nullptr, "name_%d", i), i); // forces batched rehashes
+    }
+    RUNTIME_ASSERT(name_map.get("gamma") == 3);
+    RUNTIME_ASSERT(name_map.get("name_42") == 42);
+
+    LOG_INFO("test_put_many passed\n");
+}
+
+struct EvictRecord {
+    int count;
+    int last_key;
+};
+
+void record_eviction(int key, int value, void* user_data) {
+    (void)value;
+
+    EvictRecord* record = (EvictRecord*)user_data;
+    record->count += 1;
+    record->last_key = key;
+}
+
+void test_hashmap_tombstone_churn() {
+    // the access pattern of a full LruCache, every put evicts the oldest key and leaves a tombstone behind
+    const int WINDOW = 8;
+    DS::Hashmap<int, int> map = DS::Hashmap<int, int>(&Memory::global_general_allocator, WINDOW * 2);
+    for (int i = 0; i < WINDOW; i++) {
+        map.put(i, i);
+    }
+
+    // may double once while the window fills, then tombstones are only ever purged in place
+    u64 capacity = 0;
+    for (int i = WINDOW; i < 1000000; i++) {
+        map.remove(i - WINDOW);
+        map.put(i, i);
+
+        if (i == WINDOW * 8) {
+            capacity = map.capacity();
+        }
+        RUNTIME_ASSERT(capacity == 0 || map.capacity() == capacity);
+    }
+    RUNTIME_ASSERT(capacity <= WINDOW * 4);
+
+    RUNTIME_ASSERT(map.count() == WINDOW);
+    for (int i = 1000000 - WINDOW; i < 1000000; i++) {
+        RUNTIME_ASSERT(map.get(i) == i);
+    }
+    RUNTIME_ASSERT(!map.has(1000000 - WINDOW - 1));
+
+    DS::LruCache<int, int> cache = DS::LruCache<int, int>(&Memory::global_general_allocator, WINDOW);
+    for (int i = 0; i < 1000000; i++) {
+        cache.put(i, i);
+    }
+    RUNTIME_ASSERT(cache.count() == WINDOW && cache.get(999999) == 999999 && !cache.has(1000000 - WINDOW - 1));
+
+    LOG_INFO("test_hashmap_tombstone_churn passed\n");
+}
+
+void test_lru_cache_eviction_order() {
+    EvictRecord record = {0, -1};
+    DS::LruCache<int, int> cache = DS::LruCache<int, int>(&Memory::global_general_allocator, 3);
+    cache.set_evict_callback(record_eviction, &record);
+
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    RUNTIME_ASSERT(cache.get(1) == 10); // 1 is now the most recently used
+
+    cache.put(4, 40); // evicts 2
+    RUNTIME_ASSERT(record.count == 1 && record.last_key == 2);
+    RUNTIME_ASSERT(!cache.has(2));
+    RUNTIME_ASSERT(cache.has(1) && cache.has(3) && cache.has(4));
+
+    RUNTIME_ASSERT(cache.peek(3) == 30); // peek doesn't promote
+    cache.put(5, 50); // evicts 3
+    RUNTIME_ASSERT(record.last_key == 3);
+    RUNTIME_ASSERT(cache.count() == 3);
+
+    RUNTIME_ASSERT(cache.remove(4) == 40);
+    cache.put(6, 60);
+    RUNTIME_ASSERT(record.count == 2);
+
+    for (int i = 0; i < 1000; i++) {
+        cache.put(i, i);
+    }
+    RUNTIME_ASSERT(cache.count() == 3);
+    RUNTIME_ASSERT(cache.get(999) == 999 && cache.get(998) == 998 && cache.get(997) == 997);
+    LOG_INFO("test_lru_cache_eviction_order passed\n");
+}
+
+void test_lru_cache_cost_budget() {
+    DS::LruCache<int, int> cache = DS::LruCache<int, int>(&Memory::global_general_allocator, 16, 100);
+    cache.put(1, 1, 40);
+    cache.put(2, 2, 40);
+    RUNTIME_ASSERT(cache.cost() == 80);
+
+    cache.put(3, 3, 30); // evicts 1
+    RUNTIME_ASSERT(!cache.has(1));
+    RUNTIME_ASSERT(cache.cost() == 70);
+
+    cache.put(2, 22, 90); // growing 2 evicts 3
+    RUNTIME_ASSERT(!cache.has(3));
+    RUNTIME_ASSERT(cache.get(2) == 22);
+    RUNTIME_ASSERT(cache.cost() == 90 && cache.count() == 1);
+
+    cache.clear();
+    RUNTIME_ASSERT(cache.count() == 0 && cache.cost() == 0 && !cache.has(2));
+    LOG_INFO("test_lru_cache_cost_budget passed\n");
+}
+
+void test_interner() {
+    String::Interner interner = String::Interner(&Memory::global_general_allocator);
+    RUNTIME_ASSERT(interner.find(DS::View<char>("foo", 3)) == SYMBOL_INVALID);
+
+    char foo_copy[] = "foo";
+    String::Symbol foo = interner.intern(DS::View<char>("foo", 3));
+    String::Symbol bar = interner.intern(DS::View<char>("bar", 3));
+    RUNTIME_ASSERT(foo != SYMBOL_INVALID && bar != SYMBOL_INVALID && foo != bar);
+    RUNTIME_ASSERT(interner.intern(DS::View<char>(foo_copy, 3)) == foo);
+    RUNTIME_ASSERT(interner.find(DS::View<char>("bar", 3)) == bar);
+    RUNTIME_ASSERT(interner.hash(foo) == Hashing::string_hash("foo", 3));
+
+    // views must survive table growth and new arena blocks
+    DS::View<char> foo_view = interner.view(foo);
+    char name[32];
+    for (int i = 0; i < 5000; i++) {
+        int length = snprintf(name, sizeof(name), "identifier_%d", i);
+        String::Symbol symbol = interner.intern(name, length);
+        RUNTIME_ASSERT(symbol == (String::Symbol)(i + 3));
+    }
+
+    RUNTIME_ASSERT(interner.count() == 5002);
+    RUNTIME_ASSERT(interner.view(foo).data == foo_view.data);
+    RUNTIME_ASSERT(String::equal(interner.view(foo), DS::View<char>("foo", 3)));
+    RUNTIME_ASSERT(interner.intern("identifier_4999", sizeof("identifier_4999") - 1) == 5002);
+    RUNTIME_ASSERT(interner.view(5002).data[15] == '\0');
+    LOG_INFO("test_interner passed\n");
+}
+
+// Reference implementations the optimized searches are checked and benchmarked against
+s64 naive_index_of(const char* str, u64 str_length, const char* substring, u64 substring_length) {
+    for (u64 i = 0; i + substring_length <= str_length; i++) {
+        if (String::equal(str + i, substring_length, substring, substring_length)) {
+            return (s64)i;
+        }
+    }
+
+    return -1;
+}
+
+s64 naive_last_index_of(const char* str, u64 str_length, const char* substring, u64 substring_length) {
+    s64 ret = -1;
+    for (u64 i = 0; i + substring_length <= str_length; i++) {
+        if (String::equal(str + i, substring_length, substring, substring_length)) {
+            ret = (s64)i;
+        }
+    }
+
+    return ret;
+}
+
+void test_index_of() {
+    RUNTIME_ASSERT(String::index_of("hello world", 11, "world", 5) == 6);
+    RUNTIME_ASSERT(String::index_of("hello world", 11, "o", 1) == 4);
+    RUNTIME_ASSERT(String::last_index_of("hello world", 11, "o", 1) == 7);
+    RUNTIME_ASSERT(String::index_of("hello", 5, "hello!", 6) == -1);
+    RUNTIME_ASSERT(String::contains("hello world", 11, "lo w", 4));
+
+    // small alphabets produce lots of partial matches and periodic needles for Two-Way
+    char haystack[600];
+    char needle[130];
+    u64 seed = 12345;
+    for (int round = 0; round < 3000; round++) {
+        u64 alphabet = 2 + (round % 3);
+        u64 haystack_length = 1 + (round * 7) % sizeof(haystack);
+        u64 needle_length = 1 + (round * 13) % sizeof(needle);
+        for (u64 i = 0; i < haystack_length; i++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            haystack[i] = (char)('a' + (seed >> 33) % alphabet);
+        }
+
+        if (round % 2 == 0 && needle_length <= haystack_length) {
+            u64 offset = (round * 31) % (haystack_length - needle_length + 1);
+            Memory::copy(needle, sizeof(needle), haystack + offset, needle_length);
+        } else {
+            for (u64 i = 0; i < needle_length; i++) {
+                needle[i] = (round % 5 == 0) ? 'a' : haystack[(i * 3) % haystack_length];
+            }
+        }
+
+        RUNTIME_ASSERT(String::index_of(haystack, haystack_length, needle, needle_length) == naive_index_of(haystack, haystack_length, needle, needle_length));
+        RUNTIME_ASSERT(String::last_index_of(haystack, haystack_length, needle, needle_length) == naive_last_index_of(haystack, haystack_length, needle, needle_length));
+    }
+
+    // every position passes the first/last filter, forces the switch to Two-Way in both directions
+    const u64 ADVERSARIAL_LENGTH = 20000;
+    char* adversarial = (char*)Memory::global_general_allocator.malloc(ADVERSARIAL_LENGTH);
+    char periodic_needle[101];
+    for (u64 i = 0; i < ADVERSARIAL_LENGTH; i++) {
+        adversarial[i] = 'a';
+    }
+    for (u64 i = 0; i < sizeof(periodic_needle); i++) {
+        periodic_needle[i] = (i == 50) ? 'b' : 'a';
+    }
+
+    RUNTIME_ASSERT(String::index_of(adversarial, ADVERSARIAL_LENGTH, periodic_needle, sizeof(periodic_needle)) == -1);
+    RUNTIME_ASSERT(String::last_index_of(adversarial, ADVERSARIAL_LENGTH, periodic_needle, sizeof(periodic_needle)) == -1);
+    adversarial[7000 + 50] = 'b';
+    adversarial[13000 + 50] = 'b';
+    RUNTIME_ASSERT(String::index_of(adversarial, ADVERSARIAL_LENGTH, periodic_needle, sizeof(periodic_needle)) == 7000);
+    RUNTIME_ASSERT(String::last_index_of(adversarial, ADVERSARIAL_LENGTH, periodic_needle, sizeof(periodic_needle)) == 13000);
+    Memory::global_general_allocator.free(adversarial);
+
+    LOG_INFO("test_index_of passed\n");
+}
+
+void test_string_builder() {
+    String::Builder builder = String::Builder(&Memory::global_general_allocator, 4);
+    builder.append(DS::View<char>("let", 3));
+    builder.append_char(' ');
+    builder.appendf("%s = %d;", "answer", 42);
+    RUNTIME_ASSERT(String::equal(builder.view(), DS::View<char>("let answer = 42;", 16)));
+    RUNTIME_ASSERT(builder.c_str()[builder.length()] == '\0');
+
+    builder.clear();
+    builder.indent(3);
+    builder.appendf("%0100d", 7); // bigger than the remaining capacity, forces the retry path
+    RUNTIME_ASSERT(builder.length() == 103 && builder.capacity() >= 103);
+    RUNTIME_ASSERT(builder.c_str()[0] == ' ' && builder.c_str()[3] == '0' && builder.c_str()[102] == '7');
+
+    char* released = builder.release();
+    RUNTIME_ASSERT(released[102] == '7' && builder.length() == 0);
+    Memory::global_general_allocator.free(released);
+
+    // appending a view of itself, each doubling reallocates the bytes the view points at
+    builder.append("abc");
+    for (int i = 0; i < 10; i++) {
+        builder.append(builder.view());
+    }
+    RUNTIME_ASSERT(builder.length() == 3 * 1024 && builder.c_str()[builder.length()] == '\0');
+    for (u64 i = 0; i < builder.length(); i++) {
+        RUNTIME_ASSERT(builder.c_str()[i] == "abc"[i % 3]);
+    }
+    builder.clear();
+
+    JSON* root = JSON::Object(&Memory::global_general_allocator);
+    JSON* list = JSON::Array(&Memory::global_general_allocator);
+    list->array_push(1);
+    list->array_push(false);
+    root->push("list", list);
+    root->push("name", "ion");
+    const char* expected = "{\n  \"list\": [\n    1,\n    false\n  ],\n  \"name\": \"ion\"\n}";
+    const char* actual = JSON::to_string(root, "  ");
+    RUNTIME_ASSERT_MSG(String::equal(actual, String::length(actual), expected, String::length(expected)), "%s\n", actual);
+
+    LOG_INFO("test_string_builder passed\n");
+}
+
+void test_format_numbers() {
+    char buffer[STRING_FORMAT_FLOAT_BUFFER_SIZE];
+
+    struct IntCase { s64 value; const char* expected; };
+    IntCase int_cases[] = {
+        {0, "0"}, {7, "7"}, {-7, "-7"}, {10, "10"}, {99, "99"}, {100, "100"}, {-12345, "-12345"},
+        {9223372036854775807LL, "9223372036854775807"}, {(-9223372036854775807LL - 1), "-9223372036854775808"},
+    };
+    for (IntCase test_case : int_cases) {
+        u64 length = String::format_int(test_case.value, buffer, sizeof(buffer));
+        RUNTIME_ASSERT_MSG(String::equal(buffer, length, test_case.expected, String::length(test_case.expected)), "%s\n", buffer);
+    }
+
+    RUNTIME_ASSERT(String::format_u64(18446744073709551615ULL, buffer, sizeof(buffer)) == 20);
+    RUNTIME_ASSERT(String::equal(buffer, 20, "18446744073709551615", 20));
+    RUNTIME_ASSERT(String::format_hex(0, buffer, sizeof(buffer)) == 1 && buffer[0] == '0');
+    RUNTIME_ASSERT(String::format_hex(0xdeadBEEF, buffer, sizeof(buffer)) == 8 && String::equal(buffer, 8, "deadbeef", 8));
+
+    struct FloatCase { float value; const char* expected; };
+    FloatCase float_cases[] = {
+        {0.0f, "0.0"}, {-0.0f, "-0.0"}, {1.0f, "1.0"}, {-2.5f, "-2.5"}, {0.1f, "0.1"}, {200.003f, "200.003"},
+        {23.51f, "23.51"}, {100.0f, "100.0"}, {0.001f, "0.001"}, {16777216.0f, "16777216.0"}, {1e10f, "10000000000.0"},
+        {3.4028235e38f, "340282350000000000000000000000000000000.0"},
+        {1.4e-45f, "0.000000000000000000000000000000000000000000001"},
+    };
+    for (FloatCase test_case : float_cases) {
+        u64 length = String::format_float(test_case.value, buffer, sizeof(buffer));
+        RUNTIME_ASSERT_MSG(String::equal(buffer, length, test_case.expected, String::length(test_case.expected)), "%s\n", buffer);
+    }
+
+    // the shortest text must read back as the exact same float
+    u64 seed = 42;
+    for (int i = 0; i < 100000; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        u32 bits = (u32)(seed >> 32);
+        float value;
+        Memory::copy(&value, sizeof(value), &bits, sizeof(bits));
+        if (value != value) {
+            continue;
+        }
+
+        String::format_float(value, buffer, sizeof(buffer));
+        float round_trip = strtof(buffer, nullptr);
+        RUNTIME_ASSERT_MSG(Memory::equal(&round_trip, sizeof(float), &value, sizeof(float)), "%s\n", buffer);
+    }
+
+    LOG_INFO("test_format_numbers passed\n");
+}
+
+void test_parse_number() {
+    s64 integer = 0;
+    float floating = 0.0f;
+
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("123", 3), &integer, &floating) == String::NUMBER_INTEGER && integer == 123);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("-42", 3), &integer, &floating) == String::NUMBER_INTEGER && integer == -42);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("9223372036854775807", 19), &integer, &floating) == String::NUMBER_INTEGER && integer == 9223372036854775807LL);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("-9223372036854775808", 20), &integer, &floating) == String::NUMBER_INTEGER && integer == (-9223372036854775807LL - 1));
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("9223372036854775808", 19), &integer, &floating) == String::NUMBER_INTEGER_OVERFLOW);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("99999999999999999999", 20), &integer, &floating) == String::NUMBER_INTEGER_OVERFLOW);
+
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("23.51", 5), &integer, &floating) == String::NUMBER_FLOAT && floating == 23.51f);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("-0.5", 4), &integer, &floating) == String::NUMBER_FLOAT && floating == -0.5f);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("1.5e3", 5), &integer, &floating) == String::NUMBER_FLOAT && floating == 1500.0f);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("3.4028235e38", 12), &integer, &floating) == String::NUMBER_FLOAT && floating == 3.4028235e38f);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("1e39", 4), &integer, &floating) == String::NUMBER_FLOAT && floating == strtof("1e39", nullptr));
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("0.1234567890123456789012", 24), &integer, &floating) == String::NUMBER_FLOAT && floating == 0.1234567890123456789012f);
+
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("1.", 2), &integer, &floating) == String::NUMBER_FLOAT && floating == 1.0f);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>(".5", 2), &integer, &floating) == String::NUMBER_FLOAT && floating == 0.5f);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("-.5", 3), &integer, &floating) == String::NUMBER_FLOAT && floating == -0.5f);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("1.e2", 4), &integer, &floating) == String::NUMBER_FLOAT && floating == 100.0f);
+
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("1.2.3", 5), &integer, &floating) == String::NUMBER_INVALID);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>(".", 1), &integer, &floating) == String::NUMBER_INVALID);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>(".e5", 3), &integer, &floating) == String::NUMBER_INVALID);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("-", 1), &integer, &floating) == String::NUMBER_INVALID);
+    RUNTIME_ASSERT(String::parse_number(DS::View<char>("1e", 2), &integer, &floating) == String::NUMBER_INVALID);
+
+    // every float must come back bit exact from its shortest text
+    char buffer[STRING_FORMAT_FLOAT_BUFFER_SIZE];
+    u64 seed = 7;
+    for (int i = 0; i < 100000; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        u32 bits = (u32)(seed >> 32);
+        float value;
+        Memory::copy(&value, sizeof(value), &bits, sizeof(bits));
+        if (value != value || value - value != 0.0f) {
+            continue; // nan and inf have no literal form
+        }
+
+        u64 length = String::format_float(value, buffer, sizeof(buffer));
+        RUNTIME_ASSERT(String::parse_number(DS::View<char>(buffer, length), &integer, &floating) == String::NUMBER_FLOAT);
+        RUNTIME_ASSERT_MSG(Memory::equal(&floating, sizeof(float), &value, sizeof(float)), "%s\n", buffer);
+    }
+
+    LOG_INFO("test_parse_number passed\n");
+}
+
+// decodes code point by code point, slow but obviously right
+u64 naive_utf8_first_error(const u8* data, u64 length) {
+    u64 i = 0;
+    while (i < length) {
+        u8 lead = data[i];
+        u64 sequence_length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (sequence_length == 0 || i + sequence_length > length) {
+            return i;
+        }
+
+        u32 code_point = sequence_length == 1 ? lead : (lead & (0x7F >> sequence_length));
+        for (u64 k = 1; k < sequence_length; k++) {
+            if ((data[i + k] & 0xC0) != 0x80) {
+                return i;
+            }
+
+            code_point = (code_point << 6) | (data[i + k] & 0x3F);
+        }
+
+        const u32 min_code_point[5] = {0, 0, 0x80, 0x800, 0x10000};
+        if (code_point < min_code_point[sequence_length] || code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+            return i;
+        }
+
+        i += sequence_length;
+    }
+
+    return length;
+}
+
+struct Utf8ThreadCheck {
+    const char* text;
+    u64 length;
+    u64 error_offset;
+    bool valid;
+};
+
+void validate_utf8_on_thread(void* user_data) {
+    Utf8ThreadCheck* check = (Utf8ThreadCheck*)user_data;
+    check->valid = String::utf8_validate(check->text, check->length, &check->error_offset);
+}
+
+// Has to be the first utf8_validate in the process, so the threads race on resolving the implementation
+// like parallel lex workers do. Run under ThreadSanitizer to see a race.
+void test_utf8_validate_threads() {
+    const char* text = "h\xC3\xA9llo \xE2\x82\xAC \xF0\x9F\x98\x80 and enough ascii to fill more than one block \xC3\xA9";
+    const u64 THREAD_COUNT = 8;
+    Utf8ThreadCheck checks[THREAD_COUNT];
+    Platform::Thread threads[THREAD_COUNT] = {0};
+
+    Error error = ERROR_SUCCESS;
+    for (u64 i = 0; i < THREAD_COUNT; i++) {
+        // odd threads get the text cut inside the last code point
+        checks[i] = {text, String::length(text) - (i & 1), 0, false};
+        threads[i] = Platform::create_thread(validate_utf8_on_thread, &checks[i], error);
+        RUNTIME_ASSERT(threads[i]);
+    }
+
+    for (u64 i = 0; i < THREAD_COUNT; i++) {
+        Platform::join_thread(threads[i]);
+
+        bool truncated = i & 1;
+        RUNTIME_ASSERT(checks[i].valid == !truncated);
+        RUNTIME_ASSERT(checks[i].error_offset == (truncated ? checks[i].length - 1 : checks[i].length));
+    }
+
+    LOG_INFO("test_utf8_validate_threads passed\n");
+}
+
+void test_utf8_and_length() {
+    // length at every alignment and every terminator position around a block
+    char text[128];
+    for (int offset = 0; offset < 32; offset++) {
+        for (int str_length = 0; str_length < 80; str_length++) {
+            for (u64 i = 0; i < sizeof(text); i++) {
+                text[i] = 'a';
+            }
+            text[offset + str_length] = '\0';
+            RUNTIME_ASSERT_MSG(String::length(text + offset) == (u64)str_length, "offset: %d, length: %d\n", offset, str_length);
+        }
+    }
+
+    u64 error_offset = 0;
+    RUNTIME_ASSERT(String::utf8_validate("", 0));
+    RUNTIME_ASSERT(String::utf8_validate("hello", 5));
+    RUNTIME_ASSERT(String::utf8_validate("h\xC3\xA9llo \xE2\x82\xAC \xF0\x9F\x98\x80", 15));
+    RUNTIME_ASSERT(String::utf8_validate("\xF4\x8F\xBF\xBF", 4)); // U+10FFFF
+
+    struct InvalidCase {
+        const char* data;
+        u64 length;
+        u64 error_offset;
+    };
+
+    InvalidCase invalid_cases[] = {
+        {"ab\x80", 3, 2},                 // stray continuation
+        {"\xC0\xAF", 2, 0},              // overlong '/'
+        {"a\xE0\x80\xAF", 4, 1},        // overlong 3 byte
+        {"\xF0\x80\x80\xAF", 4, 0},    // overlong 4 byte
+        {"xx\xED\xA0\x80", 5, 2},       // surrogate
+        {"\xF4\x90\x80\x80", 4, 0},    // above U+10FFFF
+        {"\xF5\x80\x80\x80", 4, 0},
+        {"abc\xE2\x82", 5, 3},           // truncated by the end of the buffer
+        {"\xE2\x82" "abc", 5, 0},         // truncated by ascii
+        {"\xC3\xA9\xFF", 3, 2},
+    };
+    for (InvalidCase test_case : invalid_cases) {
+        RUNTIME_ASSERT(!String::utf8_validate(test_case.data, test_case.length, &error_offset));
+        RUNTIME_ASSERT_MSG(error_offset == test_case.error_offset, "expected %llu got %llu\n", (unsigned long long)test_case.error_offset, (unsigned long long)error_offset);
+    }
+
+    // valid text with a single corrupted byte at every position across block boundaries
+    const char* pieces[] = {"a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xED\x9F\xBF", "\xEE\x80\x80"};
+    const u8 corruptions[] = {0x80, 0xBF, 0xC0, 0xC2, 0xE0, 0xED, 0xF0, 0xF4, 0xF8, 0xFF, 0x00, 'z'};
+    u8 buffer[256];
+    u64 seed = 3;
+    for (int round = 0; round < 2000; round++) {
+        u64 length = 0;
+        while (true) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            const char* piece = pieces[(seed >> 33) % ArrayCount(pieces)];
+            u64 piece_length = String::length(piece);
+            if (length + piece_length > 200) {
+                break;
+            }
+
+            Memory::copy(buffer + length, sizeof(buffer) - length, piece, piece_length);
+            length += piece_length;
+        }
+
+        RUNTIME_ASSERT(String::utf8_validate((char*)buffer, length));
+
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        u64 position = (seed >> 33) % length;
+        buffer[position] = corruptions[(seed >> 20) % ArrayCount(corruptions)];
+
+        u64 expected = naive_utf8_first_error(buffer, length);
+        bool valid = String::utf8_validate((char*)buffer, length, &error_offset);
+        RUNTIME_ASSERT_MSG(valid == (expected == length) && error_offset == expected, "round %d: expected %llu got %llu\n", round, (unsigned long long)expected, (unsigned long long)error_offset);
+    }
+
+    LOG_INFO("test_utf8_and_length passed\n");
+}
+
+void test_str() {
+    // no allocator at all, so anything up to the inline capacity must not allocate
+    String::Str small = String::Str(nullptr, "short key");
+    RUNTIME_ASSERT(small.is_inline() && small.length() == 9 && small == DS::View<char>("short key", 9));
+    small.append("-exactly-22!");
+    small.append_char('!');
+    RUNTIME_ASSERT(small.is_inline() && small.length() == STR_INLINE_CAPACITY && small.c_str()[STR_INLINE_CAPACITY] == '\0');
+
+    String::Str str = String::Str(&Memory::global_general_allocator, small.view());
+    str.append_char('x');
+    RUNTIME_ASSERT(!str.is_inline() && str.length() == STR_INLINE_CAPACITY + 1 && str.capacity() >= STR_INLINE_CAPACITY + 1);
+    for (int i = 0; i < 100; i++) {
+        str.append("0123456789", 10);
+    }
+    RUNTIME_ASSERT(str.length() == 1023 && str.c_str()[1022] == '9' && str.c_str()[1023] == '\0');
+    RUNTIME_ASSERT(String::starts_with(str.c_str(), str.length(), small.c_str(), small.length()));
+
+    // moves steal the buffer and leave the source empty
+    const char* heap_data = str.c_str();
+    String::Str moved = static_cast<String::Str&&>(str);
+    RUNTIME_ASSERT(moved.c_str() == heap_data && moved.length() == 1023);
+    RUNTIME_ASSERT(str.is_inline() && str.length() == 0 && str.c_str()[0] == '\0');
+
+    String::Str copy = moved.clone();
+    RUNTIME_ASSERT(copy == moved && copy.c_str() != moved.c_str());
+
+    copy = String::Str(&Memory::global_general_allocator, "tiny");
+    RUNTIME_ASSERT(copy.is_inline() && copy == DS::View<char>("tiny", 4));
+
+    moved.clear();
+    RUNTIME_ASSERT(moved.length() == 0 && !moved.is_inline() && moved.c_str()[0] == '\0');
+
+    // appending a view of itself, growing moves the bytes the view points at
+    String::Str twice = String::Str(&Memory::global_general_allocator, "abcdefghijkl");
+    twice.append(twice.view());
+    RUNTIME_ASSERT(!twice.is_inline() && twice == DS::View<char>("abcdefghijklabcdefghijkl", 24));
+
+    twice.append(twice.view());
+    twice.append(twice.c_str() + 12, 12);
+    RUNTIME_ASSERT(twice.length() == 60 && String::equal(twice.c_str() + 48, 12, "abcdefghijkl", 12));
+
+    LOG_INFO("test_str passed\n");
+}
+
+// collects every slice so the cases read as expected lists
+u64 collect_slices(String::Split splitter, DS::View<char>* out_slices, u64 capacity) {
+    u64 count = 0;
+    for (DS::View<char> slice : splitter) {
+        RUNTIME_ASSERT(count < capacity);
+        out_slices[count++] = slice;
+    }
+
+    return count;
+}
+
+void expect_slices(String::Split splitter, const char** expected, u64 expected_count) {
+    DS::View<char> slices[64];
+    u64 count = collect_slices(splitter, slices, ArrayCount(slices));
+    RUNTIME_ASSERT_MSG(count == expected_count, "expected %llu slices got %llu\n", (unsigned long long)expected_count, (unsigned long long)count);
+
+    for (u64 i = 0; i < count; i++) {
+        RUNTIME_ASSERT_MSG(String::equal(slices[i], DS::View<char>(expected[i], String::length(expected[i]))), "slice %llu: %.*s\n", (unsigned long long)i, (int)slices[i].length, slices[i].data);
+    }
+}
+
+void test_split() {
+    const char* fields[] = {"a", "", "b", "c"};
+    expect_slices(String::split(DS::View<char>("a,,b,c", 6), ','), fields, 4);
+
+    const char* empty_fields[] = {"", ""};
+    expect_slices(String::split(DS::View<char>(",", 1), ','), empty_fields, 2);
+    expect_slices(String::split(DS::View<char>("", 0), ','), empty_fields, 1);
+
+    const char* words[] = {"let", "x", "=", "5;"};
+    expect_slices(String::split(DS::View<char>("let :: x :: = :: 5;", 19), DS::View<char>(" :: ", 4)), words, 4);
+
+    const char* lines[] = {"first", "", "third\twith tab", "last"};
+    expect_slices(String::lines(DS::View<char>("first\r\n\nthird\twith tab\nlast\n", 28)), lines, 4);
+    expect_slices(String::lines(DS::View<char>("first\n\nthird\twith tab\nlast", 26)), lines, 4);
+    expect_slices(String::lines(DS::View<char>("", 0)), lines, 0);
+
+    const char* tokens[] = {"a", "b", "", "c", "d"};
+    expect_slices(String::split_any(DS::View<char>("a b\t\tc\nd", 8), DS::View<char>(" \t\n", 3)), tokens, 5);
+
+    // long inputs go through the SIMD paths, small and big (bitmap only) sets must agree
+    char text[1000];
+    for (int i = 0; i < 1000; i++) {
+        text[i] = (i % 37 == 0) ? ';' : (i % 53 == 0) ? '|' : (char)('a' + (i % 26));
+    }
+    DS::View<char> source = DS::View<char>(text, sizeof(text));
+
+    DS::View<char> small_set[64];
+    DS::View<char> big_set[64];
+    u64 small_count = collect_slices(String::split_any(source, DS::View<char>(";|", 2)), small_set, 64);
+    u64 big_count = collect_slices(String::split_any(source, DS::View<char>(";|0123456789", 12)), big_set, 64);
+    RUNTIME_ASSERT(small_count == big_count);
+
+    u64 total = 0;
+    for (u64 i = 0; i < small_count; i++) {
+        RUNTIME_ASSERT(small_set[i].data == big_set[i].data && small_set[i].length == big_set[i].length);
+        total += small_set[i].length + 1;
+    }
+    RUNTIME_ASSERT(total == sizeof(text) + 1);
+
+    // pull style
+    String::Split splitter = String::split(DS::View<char>("x=1", 3), '=');
+    DS::View<char> slice;
+    RUNTIME_ASSERT(splitter.next(&slice) && slice.length == 1 && slice.data[0] == 'x');
+    RUNTIME_ASSERT(splitter.next(&slice) && slice.length == 1 && slice.data[0] == '1');
+    RUNTIME_ASSERT(!splitter.next(&slice));
+
+    LOG_INFO("test_split passed\n");
+}
+
+void rope_count_chunk(DS::View<char> chunk, void* user_data) {
+    *(u64*)user_data += chunk.length;
+}
+
+void test_rope() {
+    String::Rope rope = String::Rope(&Memory::global_general_allocator, DS::View<char>("fn main() {\n}\n", 14));
+    rope.insert(12, DS::View<char>("    print(1);\n", 14));
+    RUNTIME_ASSERT(rope.length() == 28 && rope.line_count() == 4);
+    RUNTIME_ASSERT(rope.offset_to_line(0) == 1 && rope.offset_to_line(12) == 2 && rope.offset_to_line(26) == 3);
+    RUNTIME_ASSERT(rope.line_to_offset(2) == 12 && rope.line_to_offset(3) == 26 && rope.byte_at(26) == '}');
+
+    char buffer[64];
+    rope.slice(16, 5, buffer, sizeof(buffer));
+    RUNTIME_ASSERT(String::equal(buffer, 5, "print", 5));
+
+    // random edits against a flat buffer, big enough to span many chunks
+    const u64 CAPACITY = 1 << 16;
+    char* expected = (char*)Memory::global_general_allocator.malloc(CAPACITY);
+    char* actual = (char*)Memory::global_general_allocator.malloc(CAPACITY);
+    char insert_text[1500];
+    for (u64 i = 0; i < sizeof(insert_text); i++) {
+        insert_text[i] = (i % 17 == 16) ? '\n' : (char)('a' + (i % 26));
+    }
+
+    rope.clear();
+    u64 expected_length = 0;
+    u64 seed = 11;
+    for (int round = 0; round < 3000; round++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        u64 offset = expected_length ? (seed >> 33) % (expected_length + 1) : 0;
+        // mostly small edits like typing, sometimes a paste bigger than a chunk
+        u64 length = ((seed >> 20) % 8 == 0) ? (seed >> 40) % sizeof(insert_text) : (seed >> 40) % 4;
+
+        if ((seed >> 60) < 9 || expected_length == 0) {
+            length = (expected_length + length > CAPACITY) ? 0 : length;
+            Memory::copy(expected + offset + length, CAPACITY - offset - length, expected + offset, expected_length - offset);
+            Memory::copy(expected + offset, CAPACITY - offset, insert_text, length);
+            expected_length += length;
+            rope.insert(offset, insert_text, length);
+        } else {
+            length = (offset + length > expected_length) ? expected_length - offset : length;
+            Memory::copy(expected + offset, CAPACITY - offset, expected + offset + length, expected_length - offset - length);
+            expected_length -= length;
+            rope.remove(offset, length);
+        }
+
+        RUNTIME_ASSERT(rope.length() == expected_length);
+        if (round % 100 == 0) {
+            rope.slice(0, expected_length, actual, CAPACITY);
+            RUNTIME_ASSERT(Memory::equal(actual, expected_length, expected, expected_length));
+
+            u64 line = 1;
+            for (u64 i = 0; i <= expected_length; i++) {
+                RUNTIME_ASSERT(rope.offset_to_line(i) == line);
+                if (i < expected_length && expected[i] == '\n') {
+                    line += 1;
+                    RUNTIME_ASSERT(rope.line_to_offset(line) == i + 1);
+                }
+            }
+            RUNTIME_ASSERT(rope.line_count() == line);
+
+            u64 chunk_bytes = 0;
+            rope.for_each_chunk(rope_count_chunk, &chunk_bytes);
+            RUNTIME_ASSERT(chunk_bytes == expected_length);
+        }
+    }
+
+    Memory::global_general_allocator.free(expected);
+    Memory::global_general_allocator.free(actual);
+
+    LOG_INFO("test_rope passed\n");
+}
+
+void expect_token_types(const char* source, const TokenType* expected, u64 expected_count) {
+    DS::Vector<Token> tokens = DS::Vector<Token>(&Memory::global_general_allocator, 8);
+    Lexer::generate_tokens((u8*)source, String::length(source), tokens);
+
+    RUNTIME_ASSERT_MSG(tokens.count() == expected_count, "%s: expected %llu tokens got %llu\n", source, (unsigned long long)expected_count, (unsigned long long)tokens.count());
+    for (u64 i = 0; i < expected_count; i++) {
+        RUNTIME_ASSERT_MSG(tokens[(int)i].type == expected[i], "%s: token %llu is %s\n", source, (unsigned long long)i, tokens[(int)i].type_to_string());
+    }
+}
+
+void test_lexer() {
+    // maximal munch: the longest operator in X_SYNTAX_TOKENS wins
+    TokenType operators[] = {TS_RIGHT_ARROW, TSA_MINUS_EQUALS, TS_MINUS, TS_MINUS, TSA_DIVISION_EQUALS, TS_DIVISION, TSC_EQUALS_EQUALS, TSA_EQUALS, TSA_INFER_EQUALS, TSC_GT_OR_EQUAL, TSC_GT};
+    expect_token_types("->-=--/=/ ===:=>=>", operators, ArrayCount(operators));
+
+    TokenType statement[] = {TKW_VAR, TOKEN_IDENTIFIER, TS_COLON, TPT_INT, TSA_EQUALS, TL_INTEGER, TS_PLUS, TL_FLOAT, TS_SEMI_COLON};
+    expect_token_types("var x_1: int = -12 + 2.5; // trailing comment", statement, ArrayCount(statement));
+
+    TokenType literals[] = {TL_STRING, TL_CHARACTER, TKW_TRUE, TOKEN_IDENTIFIER};
+    expect_token_types("\"multi\nline\" /* block\n comment */ 'c' true\n\tname", literals, ArrayCount(literals));
+
+    TokenType words[] = {
+        #define X(name, str) name,
+            X_KEYWORD_TOKENS
+            X_PRIMITIVE_TYPES_TOKENS
+        #undef X
+    };
+    const char* word_source =
+        #define X(name, str) str " "
+            X_KEYWORD_TOKENS
+            X_PRIMITIVE_TYPES_TOKENS
+        #undef X
+    ;
+    expect_token_types(word_source, words, ArrayCount(words));
+
+    // same length, first and last byte as keywords, but not keywords
+    TokenType near_misses[] = {TOKEN_IDENTIFIER, TOKEN_IDENTIFIER, TOKEN_IDENTIFIER, TOKEN_IDENTIFIER, TOKEN_IDENTIFIER, TOKEN_IDENTIFIER};
+    expect_token_types("iff in floats vr tRue strong", near_misses, ArrayCount(near_misses));
+
+    DS::Vector<Token> booleans = DS::Vector<Token>(&Memory::global_general_allocator, 2);
+    Lexer::generate_tokens((u8*)"true false", 10, booleans);
+    RUNTIME_ASSERT(booleans.count() == 2 && booleans[0].b && !booleans[1].b);
+
+    DS::Vector<Token> tokens = DS::Vector<Token>(&Memory::global_general_allocator, 8);
+    const char* source = "a\n/* two\nlines */ b \"x\ny\" c";
+    Lexer::generate_tokens((u8*)source, String::length(source), tokens);
+    RUNTIME_ASSERT(tokens.count() == 4 && tokens[0].line == 1 && tokens[1].line == 3 && tokens[2].line == 4 && tokens[3].line == 4);
+
+    // runs longer than a SIMD block, with the terminators at every offset inside a block
+    for (u64 pad = 0; pad < 40; pad++) {
+        char long_source[512] = {0};
+        u64 length = 0;
+        for (u64 i = 0; i < pad; i++) {
+            long_source[length++] = (i % 7 == 3) ? '\n' : ' ';
+        }
+        u64 padding_lines = pad / 7 + (pad % 7 > 3 ? 1 : 0);
+
+        const char* body = "/* ** * /\n*\n*/ an_identifier_well_past_sixteen_bytes_";
+        Memory::copy(long_source + length, sizeof(long_source) - length, body, String::length(body));
+        length += String::length(body);
+        for (u64 i = 0; i < pad; i++) {
+            long_source[length++] = 'x';
+        }
+
+        const char* tail = " \"a string\nwith a newline that keeps going\" end";
+        Memory::copy(long_source + length, sizeof(long_source) - length, tail, String::length(tail));
+        length += String::length(tail);
+
+        DS::Vector<Token> long_tokens = DS::Vector<Token>(&Memory::global_general_allocator, 4);
+        Lexer::generate_tokens((u8*)long_source, length, long_tokens);
+        RUNTIME_ASSERT(long_tokens.count() == 3);
+        RUNTIME_ASSERT(long_tokens[0].type == TOKEN_IDENTIFIER && long_tokens[0].sv.length == 38 + pad && long_tokens[0].line == 3 + padding_lines);
+        RUNTIME_ASSERT(long_tokens[1].type == TL_STRING && long_tokens[1].line == 4 + padding_lines);
+        RUNTIME_ASSERT(long_tokens[2].type == TOKEN_IDENTIFIER && long_tokens[2].line == 4 + padding_lines);
+    }
+
+    LOG_INFO("test_lexer passed\n");
+}
+
+void test_token_stream() {
+    const char* source = "func main() -> int { var x := 12; // comment\n return x + 'c'; }";
+    u64 source_length = String::length(source);
+
+    DS::Vector<Token> expected = DS::Vector<Token>(&Memory::global_general_allocator, 8);
+    Lexer::generate_tokens((u8*)source, source_length, expected);
+
+    TokenStream stream = TokenStream((u8*)source, source_length);
+    RUNTIME_ASSERT(stream.previous_token().type == TOKEN_ILLEGAL_TOKEN);
+
+    for (u64 i = 0; i < expected.count(); i++) {
+        for (u32 n = 0; n < TOKEN_STREAM_LOOKAHEAD; n++) {
+            TokenType peeked = stream.peek_nth_token(n).type;
+            RUNTIME_ASSERT(peeked == (i + n < expected.count() ? expected[i + n].type : TOKEN_ILLEGAL_TOKEN));
+        }
+
+        Token token = stream.consume_next_token();
+        RUNTIME_ASSERT(token.type == expected[i].type && token.line == expected[i].line);
+        RUNTIME_ASSERT(token.sv.data == expected[i].sv.data && token.sv.length == expected[i].sv.length);
+        RUNTIME_ASSERT(stream.previous_token().sv.data == expected[i].sv.data);
+    }
+
+    // past the end everything is the TOKEN_ILLEGAL_TOKEN sentinel the parsers stop on
+    RUNTIME_ASSERT(stream.is_eof());
+    RUNTIME_ASSERT(stream.peek_nth_token().type == TOKEN_ILLEGAL_TOKEN);
+    RUNTIME_ASSERT(stream.consume_next_token().type == TOKEN_ILLEGAL_TOKEN);
+
+    TokenStream empty = TokenStream((u8*)"  // nothing\n", 13);
+    RUNTIME_ASSERT(empty.is_eof() && empty.peek_nth_token(1).type == TOKEN_ILLEGAL_TOKEN);
+
+    LOG_INFO("test_token_stream passed\n");
+}
+
+void test_parallel_lexer() {
+    // strings and comments that span lines, so plenty of chunk boundaries land inside them
+    const char* parts[] = {
+        "x", "foo_bar", "12", "3.5", "+", "-", "==", "->", "(", ")", "{", "}", ";", "\n", "\n    ", "'c'", "\"str\"", "var", "return",
+        "\"multi\nline\n string with // and /* inside\"", "/* block\n comment with \"quotes\" and 'c' and // \n more */",
+        "// line comment with \" and /* \n", "\"a 'b' c\"", "/**/", "\"\n\n\n\""
+    };
+
+    const u64 TEXT_LENGTH = MB(2);
+    char* text = (char*)Memory::global_general_allocator.malloc(TEXT_LENGTH);
+    u64 length = 0;
+    u64 seed = 17;
+    while (true) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const char* part = parts[(seed >> 33) % ArrayCount(parts)];
+        u64 part_length = String::length(part);
+        if (length + part_length + 1 > TEXT_LENGTH) {
+            break;
+        }
+
+        Memory::copy(text + length, TEXT_LENGTH - length, part, part_length);
+        length += part_length;
+        text[length++] = ' ';
+    }
+
+    DS::Vector<Token> expected = DS::Vector<Token>(&Memory::global_general_allocator, 1024);
+    Lexer::generate_tokens((u8*)text, length, expected);
+
+    u32 thread_counts[] = {2, 5, 32};
+    for (u32 thread_count : thread_counts) {
+        DS::Vector<Token> tokens = DS::Vector<Token>(&Memory::global_general_allocator, 1024);
+        Lexer::generate_tokens_parallel((u8*)text, length, tokens, thread_count);
+
+        RUNTIME_ASSERT(tokens.count() == expected.count());
+        for (u64 i = 0; i < expected.count(); i++) {
+            const Token& a = tokens[i];
+            const Token& b = expected[i];
+            RUNTIME_ASSERT(a.type == b.type && a.line == b.line && a.sv.data == b.sv.data && a.sv.length == b.sv.length);
+            RUNTIME_ASSERT(a.type != TOKEN_IDENTIFIER || a.symbol == b.symbol);
+        }
+    }
+
+    Memory::global_general_allocator.free(text);
+
+    LOG_INFO("test_parallel_lexer passed\n");
+}
+
+void test_compact_tokens() {
+    RUNTIME_ASSERT(sizeof(CompactToken) * 2 <= sizeof(Token));
+
+    const char* source = "func f(a: int) -> float {\n\tvar s := \"two\nlines\"; /* c\n */ 'x'\n\treturn 2.5 + -12 * a; true false\n}";
+    u64 source_length = String::length(source);
+    DS::View<char> view = DS::View<char>(source, source_length);
+
+    DS::Vector<Token> expected = DS::Vector<Token>(&Memory::global_general_allocator, 8);
+    Lexer::generate_tokens((u8*)source, source_length, expected);
+
+    DS::Vector<CompactToken> compact = DS::Vector<CompactToken>(&Memory::global_general_allocator, 8);
+    DS::Vector<TokenValue> literals = DS::Vector<TokenValue>(&Memory::global_general_allocator, 8);
+    Lexer::generate_compact_tokens((u8*)source, source_length, compact, literals);
+    RUNTIME_ASSERT(compact.count() == expected.count() && literals.count() == 2);
+
+    SourceMap source_map = SourceMap(&Memory::global_general_allocator, view);
+    DS::View<TokenValue> literal_view = DS::View<TokenValue>(literals.data(), literals.count());
+    for (u64 i = 0; i < expected.count(); i++) {
+        Token a = Token::FromCompactToken(compact[i], view, literal_view, source_map);
+        const Token& b = expected[i];
+        RUNTIME_ASSERT(a.type == b.type && a.line == b.line && a.sv.data == b.sv.data && a.sv.length == b.sv.length);
+
+        switch (a.type) {
+            case TOKEN_IDENTIFIER: RUNTIME_ASSERT(a.symbol == b.symbol); break;
+            case TL_INTEGER: RUNTIME_ASSERT(a.i == b.i); break;
+            case TL_FLOAT: RUNTIME_ASSERT(a.f == b.f); break;
+            case TL_CHARACTER: RUNTIME_ASSERT(a.c == b.c); break;
+            case TKW_TRUE: case TKW_FALSE: RUNTIME_ASSERT(a.b == b.b); break;
+            default: break;
+        }
+    }
+
+    // lines and columns against a byte by byte walk
+    u32 line = 1;
+    u32 column = 1;
+    for (u32 offset = 0; offset < source_length; offset++) {
+        SourceLocation location = source_map.location_of(offset);
+        RUNTIME_ASSERT(location.line == line && location.column == column);
+        RUNTIME_ASSERT(source_map.line_start(line) == offset - (column - 1));
+
+        column += 1;
+        if (source[offset] == '\n') {
+            line += 1;
+            column = 1;
+        }
+    }
+    RUNTIME_ASSERT(source_map.line_count() == line);
+
+    LOG_INFO("test_compact_tokens passed\n");
+}
+
+bool relex_sticky(char c) {
+    return c == '/' || c == '*' || c == '.' || (c >= '0' && c <= '9');
+}
+
+void expect_relex_matches(DS::View<char> source, DS::Vector<CompactToken>& tokens, DS::Vector<TokenValue>& literals) {
+    DS::Vector<CompactToken> expected = DS::Vector<CompactToken>(&Memory::global_general_allocator, 64);
+    DS::Vector<TokenValue> expected_literals = DS::Vector<TokenValue>(&Memory::global_general_allocator, 8);
+    Lexer::generate_compact_tokens((u8*)source.data, source.length, expected, expected_literals);
+
+    RUNTIME_ASSERT(tokens.count() == expected.count());
+    for (u64 i = 0; i < expected.count(); i++) {
+        const CompactToken& a = tokens[i];
+        const CompactToken& b = expected[i];
+        RUNTIME_ASSERT(a.type == b.type && a.offset == b.offset && a.length == b.length);
+
+        if (a.type == TOKEN_IDENTIFIER) {
+            RUNTIME_ASSERT(a.literal == b.literal);
+        } else if (a.type == TL_INTEGER || a.type == TL_FLOAT) {
+            RUNTIME_ASSERT(literals[(int)a.literal].i == expected_literals[(int)b.literal].i);
+        }
+    }
+}
+
+void test_relex() {
+    // snippets stay lexable wherever they land, edits are whole token ranges or single letters away from comment markers
+    const char* snippets[] = {
+        "foo", "x", " ", "\n", "\"str\"", "\"multi\nline\"", "/* c\n */", "// line\n", "2.5", "7", "+", "=", "==", "->",
+        "(", ")", "{", "}", ";", "'c'", "var", "return", "\t"
+    };
+
+    const u64 CAPACITY = KB(64);
+    char* text = (char*)Memory::global_general_allocator.malloc(CAPACITY);
+    const char* initial = "func main() -> int {\n    var count := 7; // counter\n    /* block\n comment */ return count + 2.5;\n}\n";
+    u64 length = String::length(initial);
+    Memory::copy(text, CAPACITY, initial, length);
+
+    DS::Vector<CompactToken> tokens = DS::Vector<CompactToken>(&Memory::global_general_allocator, 64);
+    DS::Vector<TokenValue> literals = DS::Vector<TokenValue>(&Memory::global_general_allocator, 8);
+    Lexer::generate_compact_tokens((u8*)text, length, tokens, literals);
+
+    u64 seed = 5;
+    for (int round = 0; round < 2000; round++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        u64 random = seed >> 33;
+
+        LexerEdit edit = {};
+        char inserted[64] = {0};
+
+        if ((random & 3) == 0 && tokens.count() > 0) {
+            // a letter typed or deleted somewhere, never next to comment markers or number literals
+            u32 offset = (u32)((random >> 2) % (length + 1));
+            bool deleting = (random >> 40) & 1;
+            char before = offset > 0 ? text[offset - 1] : ' ';
+            char at = offset < length ? text[offset] : ' ';
+            char after = offset + 1 < length ? text[offset + 1] : ' ';
+            if (relex_sticky(before) || relex_sticky(at) || (deleting && relex_sticky(after))) {
+                continue;
+            }
+
+            edit.offset = offset;
+            if (deleting) {
+                if (offset >= length || at < 'a' || at > 'z') {
+                    continue;
+                }
+
+                edit.removed_length = 1;
+            } else {
+                inserted[0] = (char)('a' + (random % 26));
+                edit.inserted_length = 1;
+            }
+        } else {
+            // replace whole tokens with a few snippets
+            u64 first = tokens.count() ? (random >> 2) % (tokens.count() + 1) : 0;
+            u64 last = first + (tokens.count() > first ? (random >> 12) % MIN((u64)3, tokens.count() - first + 1) : 0);
+
+            u32 start = (u32)length;
+            if (first < tokens.count()) {
+                start = tokens[(int)first].offset - (tokens[(int)first].type == TL_STRING ? 1 : 0);
+            }
+
+            u32 end = start;
+            if (last > first) {
+                const CompactToken& final_token = tokens[(int)(last - 1)];
+                end = final_token.offset + final_token.length + (final_token.type == TL_STRING ? 1 : 0);
+            }
+
+            // padded with spaces so snippets never glue into something like "x2.5"
+            inserted[0] = ' ';
+            u64 inserted_length = 1;
+            u64 snippet_count = (random >> 20) % 3;
+            for (u64 k = 0; k < snippet_count; k++) {
+                const char* snippet = snippets[(random >> (24 + k * 5)) % ArrayCount(snippets)];
+                u64 snippet_length = String::length(snippet);
+                Memory::copy(inserted + inserted_length, sizeof(inserted) - inserted_length, snippet, snippet_length);
+                inserted_length += snippet_length;
+                inserted[inserted_length++] = ' ';
+            }
+
+            edit.offset = start;
+            edit.removed_length = end - start;
+            edit.inserted_length = (u32)inserted_length;
+        }
+
+        if (length - edit.removed_length + edit.inserted_length > CAPACITY) {
+            continue;
+        }
+
+        u64 tail = length - (edit.offset + edit.removed_length);
+        Memory::copy(text + edit.offset + edit.inserted_length, CAPACITY - edit.offset - edit.inserted_length, text + edit.offset + edit.removed_length, tail);
+        Memory::copy(text + edit.offset, CAPACITY - edit.offset, inserted, edit.inserted_length);
+        length = length - edit.removed_length + edit.inserted_length;
+
+        DS::View<char> source = DS::View<char>(text, length);
+        Lexer::relex(tokens, literals, edit, source);
+        expect_relex_matches(source, tokens, literals);
+    }
+
+    // one keystroke in a big file only touches the tokens around it
+    u64 big_length = 0;
+    while (big_length + 16 < CAPACITY) {
+        Memory::copy(text + big_length, CAPACITY - big_length, "var a := b + 7;\n", 16);
+        big_length += 16;
+    }
+
+    DS::Vector<CompactToken> big_tokens = DS::Vector<CompactToken>(&Memory::global_general_allocator, 64);
+    Lexer::generate_compact_tokens((u8*)text, big_length, big_tokens, literals);
+
+    u32 middle = (u32)(big_length / 2) + 4; // the 'a' of some line
+    Memory::copy(text + middle + 1, CAPACITY - middle - 1, text + middle, big_length - middle);
+    text[middle] = 'z';
+    big_length += 1;
+
+    LexerEdit keystroke = {middle, 0, 1};
+    LexerSplice splice = Lexer::relex(big_tokens, literals, keystroke, DS::View<char>(text, big_length));
+    RUNTIME_ASSERT(splice.removed_count <= 2 && splice.inserted_count <= 2);
+    expect_relex_matches(DS::View<char>(text, big_length), big_tokens, literals);
+
+    Memory::global_general_allocator.free(text);
+
+    LOG_INFO("test_relex passed\n");
+}
+
+void test_token_cache() {
+    const char* source = "func f(a: int) -> float {\n\tvar s := \"two\nlines\"; /* c\n */ 'x'\n\treturn 2.5 + -12 * a + f(a); true\n}";
+    u64 source_length = String::length(source);
+    DS::View<char> view = DS::View<char>(source, source_length);
+    const char* cache_path = "test_token_cache" TOKEN_CACHE_EXTENSION;
+
+    DS::Vector<Token> expected = DS::Vector<Token>(&Memory::global_general_allocator, 8);
+    Lexer::generate_tokens((u8*)source, source_length, expected);
+
+    Error error = ERROR_SUCCESS;
+    TokenCache cache = TokenCache(&Memory::global_general_allocator, view);
+    RUNTIME_ASSERT(cache.store(cache_path, error) && error == ERROR_SUCCESS);
+    RUNTIME_ASSERT(cache.load(cache_path) && cache.token_count() == expected.count());
+
+    TokenStream stream = TokenStream(&cache);
+    for (u64 i = 0; i < expected.count(); i++) {
+        Token a = stream.consume_next_token();
+        const Token& b = expected[i];
+        RUNTIME_ASSERT(a.type == b.type && a.line == b.line && a.sv.data == b.sv.data && a.sv.length == b.sv.length);
+
+        switch (a.type) {
+            case TOKEN_IDENTIFIER: RUNTIME_ASSERT(a.symbol == b.symbol); break;
+            case TL_INTEGER: RUNTIME_ASSERT(a.i == b.i); break;
+            case TL_FLOAT: RUNTIME_ASSERT(a.f == b.f); break;
+            case TL_CHARACTER: RUNTIME_ASSERT(a.c == b.c); break;
+            default: break;
+        }
+    }
+
+    RUNTIME_ASSERT(stream.is_eof());
+
+    // one byte of difference is a miss even with the same length
+    char edited[256];
+    Memory::copy(edited, sizeof(edited), source, source_length);
+    edited[source_length - 3] = 'X';
+    TokenCache other = TokenCache(&Memory::global_general_allocator, DS::View<char>(edited, source_length));
+    RUNTIME_ASSERT(!other.load(cache_path));
+
+    // a truncated file is a miss, not a crash
+    TokenCacheHeader header = {};
+    header.magic = TOKEN_CACHE_MAGIC;
+    header.version = TOKEN_CACHE_VERSION;
+    header.token_type_count = TOKEN_COUNT;
+    header.source_hash = Hashing::fingerprint128(source, source_length);
+    header.source_size = source_length;
+    header.token_count = 1000;
+    RUNTIME_ASSERT(Platform::write_entire_file(cache_path, &header, sizeof(header), error));
+    RUNTIME_ASSERT(!cache.load(cache_path) && cache.token_count() == 0);
+
+    remove(cache_path);
+    RUNTIME_ASSERT(!cache.load(cache_path));
+
+    LOG_INFO("test_token_cache passed\n");
+}
+
+void expect_mapped(const char* file_path, const char* contents, u64 contents_length) {
+    Error error = ERROR_SUCCESS;
+    RUNTIME_ASSERT(Platform::write_entire_file(file_path, contents, contents_length, error));
+
+    byte_t file_size = 0;
+    u8* data = Platform::map_file(file_path, file_size, error);
+    RUNTIME_ASSERT(data && error == ERROR_SUCCESS && file_size == contents_length);
+    RUNTIME_ASSERT(contents_length == 0 || String::equal((char*)data, file_size, contents, contents_length));
+
+    for (u64 i = 0; i < PLATFORM_MAP_PADDING; i++) {
+        RUNTIME_ASSERT(data[file_size + i] == 0);
+    }
+
+    Platform::unmap_file(data, file_size);
+    remove(file_path);
+}
+
+void test_map_file() {
+    const char* file_path = "test_map_file.txt";
+
+    // ends mid page, right before a page boundary, on one and just past one
+    const u64 LENGTHS[] = {0, 1, 100, KB(4) - PLATFORM_MAP_PADDING, KB(4) - 1, KB(4), KB(4) + 1, KB(64)};
+    char* text = (char*)Memory::global_general_allocator.malloc(KB(64));
+    for (u64 i = 0; i < KB(64); i++) {
+        text[i] = (char)('a' + (i % 26));
+    }
+
+    for (u64 i = 0; i < ArrayCount(LENGTHS); i++) {
+        expect_mapped(file_path, text, LENGTHS[i]);
+    }
+
+    Memory::global_general_allocator.free(text);
+
+    Error error = ERROR_SUCCESS;
+    byte_t file_size = 0;
+    RUNTIME_ASSERT(Platform::map_file("does_not_exist.txt", file_size, error) == nullptr && error == ERROR_RESOURCE_NOT_FOUND);
+
+    // parsed straight out of the mapping, the JSON strings point into it until it is unmapped
+    const char* json = "{\"name\": \"ion\", \"files\": [1, 2.5, true, null], \"nested\": {\"key\": \"value\"}}";
+    u64 json_length = String::length(json);
+    error = ERROR_SUCCESS;
+    RUNTIME_ASSERT(Platform::write_entire_file(file_path, json, json_length, error));
+
+    u8* data = Platform::map_file(file_path, file_size, error);
+    RUNTIME_ASSERT(data && file_size == json_length);
+
+    const char* expected = JSON::to_string(JSON::parse(&Memory::global_general_allocator, json, json_length));
+    const char* mapped = JSON::to_string(JSON::parse(&Memory::global_general_allocator, (char*)data, file_size));
+    RUNTIME_ASSERT(String::equal(expected, String::length(expected), mapped, String::length(mapped)));
+
+    Platform::unmap_file(data, file_size);
+    remove(file_path);
+
+    LOG_INFO("test_map_file passed\n");
+}
+
+struct ReadFilesCheck {
+    const char** contents; // nullptr for a path that doesn't exist
+    u64* lengths;
+    u64 file_count;
+    u64 delivered[64];
+};
+
+void check_read_file(u64 file_index, u8* data, byte_t file_size, Error error, void* user_data) {
+    ReadFilesCheck* check = (ReadFilesCheck*)user_data;
+    RUNTIME_ASSERT(file_index < check->file_count);
+    check->delivered[file_index] += 1;
+
+    if (check->contents[file_index] == nullptr) {
+        RUNTIME_ASSERT(data == nullptr && error == ERROR_RESOURCE_NOT_FOUND);
+        return;
+    }
+
+    RUNTIME_ASSERT(data && error == ERROR_SUCCESS && file_size == check->lengths[file_index]);
+    RUNTIME_ASSERT(file_size == 0 || String::equal((char*)data, file_size, check->contents[file_index], file_size));
+    for (u64 i = 0; i < PLATFORM_MAP_PADDING; i++) {
+        RUNTIME_ASSERT(data[file_size + i] == 0);
+    }
+
+    Memory::global_general_allocator.free(data);
+}
+
+void test_read_files_async() {
+    const u64 FILE_COUNT = 40;
+    char paths[FILE_COUNT][32];
+    const char* path_pointers[FILE_COUNT];
+    const char* contents[FILE_COUNT];
+    u64 lengths[FILE_COUNT];
+
+    // sizes from empty to a few pages, so some files need more than one read
+    char* text = (char*)Memory::global_general_allocator.malloc(KB(256));
+    for (u64 i = 0; i < KB(256); i++) {
+        text[i] = (char)('a' + ((i * 7) % 26));
+    }
+
+    Error error = ERROR_SUCCESS;
+    for (u64 i = 0; i < FILE_COUNT; i++) {
+        snprintf(paths[i], sizeof(paths[i]), "test_read_files_%llu.ion", (unsigned long long)i);
+        path_pointers[i] = paths[i];
+        contents[i] = text + i;
+        lengths[i] = (i * i * 157) % KB(200);
+
+        if (i == 13) {
+            contents[i] = nullptr; // never written
+            continue;
+        }
+
+        RUNTIME_ASSERT(Platform::write_entire_file(paths[i], contents[i], lengths[i], error));
+    }
+
+    ReadFilesCheck check = {contents, lengths, FILE_COUNT, {0}};
+    Platform::read_files_async(path_pointers, FILE_COUNT, check_read_file, &check);
+
+    for (u64 i = 0; i < FILE_COUNT; i++) {
+        RUNTIME_ASSERT(check.delivered[i] == 1);
+        remove(paths[i]);
+    }
+
+    Platform::read_files_async(path_pointers, 0, check_read_file, &check);
+    Memory::global_general_allocator.free(text);
+
+    LOG_INFO("test_read_files_async passed\n");
+}
+
+void expect_copied(const char* dest_path, const char* text, u64 length) {
+    Error error = ERROR_SUCCESS;
+    byte_t file_size = 0;
+    u8* data = Platform::map_file(dest_path, file_size, error);
+    RUNTIME_ASSERT(data && error == ERROR_SUCCESS && file_size == length);
+    RUNTIME_ASSERT(length == 0 || String::equal((char*)data, file_size, text, length));
+
+    Platform::unmap_file(data, file_size);
+    remove(dest_path);
+}
+
+void test_copy_file() {
+    const char* source_path = "test_copy_file_source.txt";
+    const char* dest_path = "test_copy_file_dest.txt";
+
+    // not a multiple of the step or the copy buffer, so the last chunk is short
+    const u64 LENGTH = MB(3) + 7;
+    char* text = (char*)Memory::global_general_allocator.malloc(LENGTH);
+    for (u64 i = 0; i < LENGTH; i++) {
+        text[i] = (char)('a' + ((i * 13) % 26));
+    }
+
+    Error error = ERROR_SUCCESS;
+    RUNTIME_ASSERT(Platform::write_entire_file(source_path, text, LENGTH, error));
+
+    RUNTIME_ASSERT(Platform::copy_file(source_path, dest_path));
+    expect_copied(dest_path, text, LENGTH);
+
+    // stepped a megabyte at a time, progress only moves forward and the last step releases the copy
+    Platform::FileCopy copy;
+    RUNTIME_ASSERT(Platform::copy_file_begin(&copy, source_path, dest_path, error));
+    RUNTIME_ASSERT(copy.total_bytes == LENGTH && copy.bytes_copied == 0);
+
+    u64 steps = 0;
+    byte_t previous = 0;
+    bool more = true;
+    while (more) {
+        more = Platform::copy_file_step(&copy, MB(1), error);
+        RUNTIME_ASSERT(copy.bytes_copied > previous && copy.bytes_copied - previous <= MB(1));
+        previous = copy.bytes_copied;
+        steps += 1;
+    }
+
+    RUNTIME_ASSERT(error == ERROR_SUCCESS && steps == 4 && copy.bytes_copied == LENGTH && copy.state == nullptr);
+    expect_copied(dest_path, text, LENGTH);
+
+    // cancelled halfway, the destination keeps what was copied so far
+    RUNTIME_ASSERT(Platform::copy_file_begin(&copy, source_path, dest_path, error));
+    RUNTIME_ASSERT(Platform::copy_file_step(&copy, MB(1), error));
+    Platform::copy_file_cancel(&copy);
+    RUNTIME_ASSERT(copy.state == nullptr);
+    expect_copied(dest_path, text, MB(1));
+
+    RUNTIME_ASSERT(Platform::write_entire_file(source_path, text, 0, error));
+    RUNTIME_ASSERT(Platform::copy_file_begin(&copy, source_path, dest_path, error));
+    RUNTIME_ASSERT(copy.total_bytes == 0 && !Platform::copy_file_step(&copy, 0, error) && error == ERROR_SUCCESS);
+    expect_copied(dest_path, text, 0);
+
+    // the size from copy_file_begin is only a hint, a source that grows afterwards is copied to its end
+    RUNTIME_ASSERT(Platform::copy_file_begin(&copy, source_path, dest_path, error));
+    RUNTIME_ASSERT(copy.total_bytes == 0 && Platform::write_entire_file(source_path, text, KB(5), error));
+    RUNTIME_ASSERT(!Platform::copy_file_step(&copy, 0, error) && error == ERROR_SUCCESS && copy.total_bytes == KB(5));
+    expect_copied(dest_path, text, KB(5));
+
+    #if defined(PLATFORM_LINUX)
+        // stat says 0 bytes and copy_file_range copies nothing, only read sees the contents
+        RUNTIME_ASSERT(Platform::copy_file("/proc/self/status", dest_path, false));
+        byte_t status_size = 0;
+        u8* status = Platform::map_file(dest_path, status_size, error);
+        RUNTIME_ASSERT(status && status_size > 0 && String::starts_with((char*)status, status_size, "Name:", 5));
+        Platform::unmap_file(status, status_size);
+        remove(dest_path);
+    #endif
+
+    RUNTIME_ASSERT(!Platform::copy_file("does_not_exist.txt", dest_path, false));
+    RUNTIME_ASSERT(!Platform::copy_file_begin(&copy, "does_not_exist.txt", dest_path, error) && error == ERROR_RESOURCE_NOT_FOUND);
+
+    remove(source_path);
+    Memory::global_general_allocator.free(text);
+
+    LOG_INFO("test_copy_file passed\n");
+}
+
+// ---------- Benchmarks ----------
+typedef u64(BenchmarkHashFunction)(const void*, u64);
+
+void benchmark_hash_function(const char* name, BenchmarkHashFunction* hash_func) {
+    const u64 KEY_COUNT = 1 << 20;
+    const u64 BUCKET_COUNT = 1 << 12;
+    u8 bulk[KB(4)] = {0};
+    for (u64 i = 0; i < sizeof(bulk); i++) {
+        bulk[i] = (u8)(i * 31);
+    }
+
+    u64 sink = 0;
+    double start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < KEY_COUNT; i++) {
+        u32 key = (u32)i;
+        sink ^= hash_func(&key, sizeof(key));
+    }
+    double int_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < KEY_COUNT; i++) {
+        u64 key[2] = {i, i * 7};
+        sink ^= hash_func(key, sizeof(key));
+    }
+    double small_seconds = Platform::get_seconds_elapsed() - start;
+
+    const u64 BULK_ITERATIONS = 1 << 12;
+    start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < BULK_ITERATIONS; i++) {
+        bulk[0] = (u8)i;
+        sink ^= hash_func(bulk, sizeof(bulk));
+    }
+    double bulk_seconds = Platform::get_seconds_elapsed() - start;
+    double bulk_mb = (double)(BULK_ITERATIONS * sizeof(bulk)) / (double)MB(1);
+
+    // Distribution: sequential int keys into a power of two table, the same way the hashmap indexes
+    u32* buckets = (u32*)Memory::global_general_allocator.malloc(BUCKET_COUNT * sizeof(u32));
+    const u64 DISTRIBUTION_KEY_COUNT = BUCKET_COUNT * 16;
+    for (u64 i = 0; i < DISTRIBUTION_KEY_COUNT; i++) {
+        int key = (int)i;
+        buckets[hash_func(&key, sizeof(key)) % BUCKET_COUNT] += 1;
+    }
+
+    double expected = (double)DISTRIBUTION_KEY_COUNT / (double)BUCKET_COUNT;
+    double chi_squared = 0.0;
+    u32 max_bucket = 0;
+    for (u64 i = 0; i < BUCKET_COUNT; i++) {
+        double delta = (double)buckets[i] - expected;
+        chi_squared += (delta * delta) / expected;
+        max_bucket = MAX(max_bucket, buckets[i]);
+    }
+    Memory::global_general_allocator.free(buckets);
+
+    LOG_INFO("%-12s | int: %6.2f ns/key | 16 bytes: %6.2f ns/key | 4 KB: %8.2f MB/s | chi^2/bucket: %.3f (1.0 is ideal) | max bucket: %u (expected %.0f) | %llx\n",
+        name,
+        (int_seconds * 1e9) / (double)KEY_COUNT,
+        (small_seconds * 1e9) / (double)KEY_COUNT,
+        bulk_mb / bulk_seconds,
+        chi_squared / (double)BUCKET_COUNT,
+        max_bucket, expected,
+        (unsigned long long)(sink & 0xF)
+    );
+}
+
+void benchmark_hash_many() {
+    const u64 KEY_COUNT = 1 << 16;
+    const u64 ITERATIONS = 16;
+    char source[256];
+    for (u64 i = 0; i < sizeof(source); i++) {
+        source[i] = (char)('a' + (i % 26));
+    }
+
+    DS::View<char>* views = (DS::View<char>*)Memory::global_general_allocator.malloc(KEY_COUNT * sizeof(DS::View<char>));
+    u64* hashes = (u64*)Memory::global_general_allocator.malloc(KEY_COUNT * sizeof(u64));
+    for (u64 i = 0; i < KEY_COUNT; i++) {
+        views[i] = DS::View<char>(source + (i % 64), 4 + ((i * 7) % 28)); // identifier sized keys
+    }
+
+    double start = Platform::get_seconds_elapsed();
+    for (u64 iteration = 0; iteration < ITERATIONS; iteration++) {
+        for (u64 i = 0; i < KEY_COUNT; i++) {
+            hashes[i] = Hashing::string_view_hash(&views[i], 0);
+        }
+    }
+    double serial_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    for (u64 iteration = 0; iteration < ITERATIONS; iteration++) {
+        Hashing::hash_many(views, KEY_COUNT, hashes);
+    }
+    double batched_seconds = Platform::get_seconds_elapsed() - start;
+
+    LOG_INFO("string views | serial: %6.2f ns/key | hash_many: %6.2f ns/key\n",
+        (serial_seconds * 1e9) / (double)(KEY_COUNT * ITERATIONS),
+        (batched_seconds * 1e9) / (double)(KEY_COUNT * ITERATIONS)
+    );
+
+    Memory::global_general_allocator.free(views);
+    Memory::global_general_allocator.free(hashes);
+}
+
+void benchmark_hashing() {
+    benchmark_hash_function("siphash24", Hashing::siphash24);
+    benchmark_hash_function("fast_hash", Hashing::fast_hash);
+    benchmark_hash_many();
+}
+
+void benchmark_index_of() {
+    const u64 HAYSTACK_LENGTH = MB(8);
+    char* haystack = (char*)Memory::global_general_allocator.malloc(HAYSTACK_LENGTH);
+    const char* words = "the quick brown fox jumps over the lazy dog while the compiler lexes tokens ";
+    u64 words_length = String::length(words);
+    for (u64 i = 0; i < HAYSTACK_LENGTH; i++) {
+        haystack[i] = words[i % words_length];
+    }
+
+    // one match at each end so both directions have to cover the whole input
+    const char* needles[] = {"zebra_crossing", "the lazy dog while the compiler lexes tokens, the quick brown fox jumps over the fence!"};
+    for (const char* needle : needles) {
+        u64 needle_length = String::length(needle);
+        Memory::copy(haystack + 1024, needle_length, needle, needle_length);
+        Memory::copy(haystack + HAYSTACK_LENGTH - 1024, needle_length, needle, needle_length);
+
+        double start = Platform::get_seconds_elapsed();
+        s64 naive_first = naive_index_of(haystack + 2048, HAYSTACK_LENGTH - 2048, needle, needle_length);
+        double naive_forward_seconds = Platform::get_seconds_elapsed() - start;
+
+        start = Platform::get_seconds_elapsed();
+        s64 first = String::index_of(haystack + 2048, HAYSTACK_LENGTH - 2048, needle, needle_length);
+        double forward_seconds = Platform::get_seconds_elapsed() - start;
+
+        start = Platform::get_seconds_elapsed();
+        s64 naive_last = naive_last_index_of(haystack, HAYSTACK_LENGTH - 2048, needle, needle_length);
+        double naive_reverse_seconds = Platform::get_seconds_elapsed() - start;
+
+        start = Platform::get_seconds_elapsed();
+        s64 last = String::last_index_of(haystack, HAYSTACK_LENGTH - 2048, needle, needle_length);
+        double reverse_seconds = Platform::get_seconds_elapsed() - start;
+
+        RUNTIME_ASSERT(first == naive_first && last == naive_last);
+
+        double mb = (double)HAYSTACK_LENGTH / (double)MB(1);
+        LOG_INFO("needle %3llu bytes | index_of: %8.1f MB/s (naive %7.1f MB/s) | last_index_of: %8.1f MB/s (naive %7.1f MB/s)\n",
+            (unsigned long long)needle_length,
+            mb / forward_seconds, mb / naive_forward_seconds,
+            mb / reverse_seconds, mb / naive_reverse_seconds
+        );
+    }
+
+    Memory::global_general_allocator.free(haystack);
+}
+
+void benchmark_format_numbers() {
+    const u64 VALUE_COUNT = 1 << 20;
+    char buffer[STRING_FORMAT_FLOAT_BUFFER_SIZE];
+    u64 sink = 0;
+
+    double start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < VALUE_COUNT; i++) {
+        sink += snprintf(buffer, sizeof(buffer), "%d", (int)(i * 2654435761u));
+    }
+    double snprintf_int_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < VALUE_COUNT; i++) {
+        sink += String::format_int((int)(i * 2654435761u), buffer, sizeof(buffer));
+    }
+    double format_int_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < VALUE_COUNT; i++) {
+        sink += snprintf(buffer, sizeof(buffer), "%.9g", (double)((float)i * 0.37f));
+    }
+    double snprintf_float_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < VALUE_COUNT; i++) {
+        sink += String::format_float((float)i * 0.37f, buffer, sizeof(buffer));
+    }
+    double format_float_seconds = Platform::get_seconds_elapsed() - start;
+
+    LOG_INFO("int: format_int %5.1f ns (snprintf %5.1f ns) | float: format_float %5.1f ns (snprintf %%.9g %5.1f ns) | %llu\n",
+        (format_int_seconds * 1e9) / (double)VALUE_COUNT, (snprintf_int_seconds * 1e9) / (double)VALUE_COUNT,
+        (format_float_seconds * 1e9) / (double)VALUE_COUNT, (snprintf_float_seconds * 1e9) / (double)VALUE_COUNT,
+        (unsigned long long)(sink & 0xF)
+    );
+}
+
+void benchmark_parse_number() {
+    const u64 VALUE_COUNT = 1 << 18;
+    char* text = (char*)Memory::global_general_allocator.malloc(VALUE_COUNT * STRING_FORMAT_FLOAT_BUFFER_SIZE);
+    DS::View<char>* literals = (DS::View<char>*)Memory::global_general_allocator.malloc(VALUE_COUNT * sizeof(DS::View<char>));
+
+    // half integers, half floats, like a number heavy JSON array
+    u64 offset = 0;
+    for (u64 i = 0; i < VALUE_COUNT; i++) {
+        u64 length = (i % 2) ? String::format_float((float)i * 1.37f, text + offset, STRING_FORMAT_FLOAT_BUFFER_SIZE)
+                             : String::format_int((s64)(i * 2654435761u), text + offset, STRING_FORMAT_FLOAT_BUFFER_SIZE);
+        literals[i] = DS::View<char>(text + offset, length);
+        offset += length + 1;
+    }
+
+    double sink = 0;
+    double start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < VALUE_COUNT; i++) {
+        // the old path: copy, null terminate, strtol then strtof
+        char buffer[128];
+        Memory::copy(buffer, sizeof(buffer), literals[i].data, literals[i].length);
+        buffer[literals[i].length] = '\0';
+        char* end = nullptr;
+        long integer = strtol(buffer, &end, 10);
+        if ((u64)(end - buffer) == literals[i].length) {
+            sink += (double)integer;
+        } else {
+            sink += strtof(buffer, &end);
+        }
+    }
+    double strto_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    for (u64 i = 0; i < VALUE_COUNT; i++) {
+        s64 integer;
+        float floating;
+        if (String::parse_number(literals[i], &integer, &floating) == String::NUMBER_INTEGER) {
+            sink += (double)integer;
+        } else {
+            sink += floating;
+        }
+    }
+    double parse_seconds = Platform::get_seconds_elapsed() - start;
+
+    LOG_INFO("literals | parse_number: %5.1f ns (copy + strtol/strtof %5.1f ns) | %d\n",
+        (parse_seconds * 1e9) / (double)VALUE_COUNT, (strto_seconds * 1e9) / (double)VALUE_COUNT, (int)(sink != 0)
+    );
+
+    Memory::global_general_allocator.free(text);
+    Memory::global_general_allocator.free(literals);
+}
+
+void benchmark_utf8_and_length() {
+    const u64 TEXT_LENGTH = MB(16);
+    char* text = (char*)Memory::global_general_allocator.malloc(TEXT_LENGTH + 1);
+
+    // mostly ascii source with a sprinkle of multi byte characters
+    for (u64 i = 0; i < TEXT_LENGTH; i++) {
+        text[i] = (char)('a' + (i % 26));
+        if (i % 97 == 0 && i + 3 <= TEXT_LENGTH) {
+            Memory::copy(text + i, 3, "\xE2\x82\xAC", 3);
+            i += 2;
+        }
+    }
+    text[TEXT_LENGTH] = '\0';
+
+    double start = Platform::get_seconds_elapsed();
+    u64 length = String::length(text);
+    double length_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    u64 naive_length = 0;
+    while (*(volatile char*)(text + naive_length) != '\0') {
+        naive_length += 1;
+    }
+    double naive_length_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    bool valid = String::utf8_validate(text, TEXT_LENGTH);
+    double validate_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    bool naive_valid = naive_utf8_first_error((u8*)text, TEXT_LENGTH) == TEXT_LENGTH;
+    double naive_validate_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(length == TEXT_LENGTH && naive_length == TEXT_LENGTH && valid && naive_valid);
+
+    double megabytes = (double)TEXT_LENGTH / (double)MB(1);
+    LOG_INFO("length        | simd: %7.0f MB/s (byte loop %7.0f MB/s)\n", megabytes / length_seconds, megabytes / naive_length_seconds);
+    LOG_INFO("utf8_validate | simd: %7.0f MB/s (decoding %7.0f MB/s)\n", megabytes / validate_seconds, megabytes / naive_validate_seconds);
+
+    Memory::global_general_allocator.free(text);
+}
+
+void benchmark_split() {
+    const u64 TEXT_LENGTH = MB(16);
+    char* text = (char*)Memory::global_general_allocator.malloc(TEXT_LENGTH);
+
+    // log file shaped: ~80 byte lines of space separated words
+    for (u64 i = 0; i < TEXT_LENGTH; i++) {
+        text[i] = (i % 81 == 80) ? '\n' : (i % 9 == 8) ? ' ' : (char)('a' + (i % 26));
+    }
+    DS::View<char> source = DS::View<char>(text, TEXT_LENGTH);
+
+    double start = Platform::get_seconds_elapsed();
+    u64 naive_lines = 0;
+    u64 line_start = 0;
+    for (u64 i = 0; i < TEXT_LENGTH; i++) {
+        if (text[i] == '\n') {
+            naive_lines += (i - line_start) != 0;
+            line_start = i + 1;
+        }
+    }
+    naive_lines += line_start < TEXT_LENGTH;
+    double naive_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    u64 line_count = 0;
+    for (DS::View<char> line : String::lines(source)) {
+        line_count += line.length != 0;
+    }
+    double lines_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    u64 word_count = 0;
+    for (DS::View<char> word : String::split_any(source, DS::View<char>(" \n", 2))) {
+        word_count += word.length != 0;
+    }
+    double split_any_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(line_count == naive_lines && word_count > line_count);
+
+    double megabytes = (double)TEXT_LENGTH / (double)MB(1);
+    LOG_INFO("split         | lines: %7.0f MB/s (byte loop %7.0f MB/s) | split_any: %7.0f MB/s\n",
+        megabytes / lines_seconds, megabytes / naive_seconds, megabytes / split_any_seconds
+    );
+
+    Memory::global_general_allocator.free(text);
+}
+
+void benchmark_rope() {
+    const u64 TEXT_LENGTH = MB(8);
+    const int EDIT_COUNT = 20000;
+    char* text = (char*)Memory::global_general_allocator.malloc(TEXT_LENGTH + EDIT_COUNT);
+    for (u64 i = 0; i < TEXT_LENGTH; i++) {
+        text[i] = (i % 60 == 59) ? '\n' : (char)('a' + (i % 26));
+    }
+
+    String::Rope rope = String::Rope(&Memory::global_general_allocator, DS::View<char>(text, TEXT_LENGTH));
+
+    // typing one byte at a time at scattered positions, the flat buffer has to memmove the tail every time
+    u64 seed = 5;
+    u64 flat_length = TEXT_LENGTH;
+    double start = Platform::get_seconds_elapsed();
+    for (int i = 0; i < EDIT_COUNT; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        u64 offset = (seed >> 33) % flat_length;
+        Memory::copy(text + offset + 1, TEXT_LENGTH + EDIT_COUNT - offset - 1, text + offset, flat_length - offset);
+        text[offset] = 'x';
+        flat_length += 1;
+    }
+    double flat_seconds = Platform::get_seconds_elapsed() - start;
+
+    seed = 5;
+    u64 line_sum = 0;
+    start = Platform::get_seconds_elapsed();
+    for (int i = 0; i < EDIT_COUNT; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        u64 offset = (seed >> 33) % rope.length();
+        rope.insert(offset, "x", 1);
+        line_sum += rope.offset_to_line(offset);
+    }
+    double rope_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(rope.length() == flat_length && line_sum > 0);
+    RUNTIME_ASSERT(rope.byte_at(flat_length / 2) == text[flat_length / 2]);
+
+    LOG_INFO("rope          | insert + offset_to_line: %6.0f ns/edit (flat memmove %8.0f ns/edit)\n",
+        (rope_seconds * 1e9) / EDIT_COUNT, (flat_seconds * 1e9) / EDIT_COUNT
+    );
+
+    Memory::global_general_allocator.free(text);
+}
+
+void benchmark_lexer() {
+    // token dense generated source, the worst case for per token overhead
+    const char* parts[] = {
+        "var", "x", "=", "12", "+", "y_2", "*", "3.5", ";", "\n", "if", "(", "a", "==", "b", ")", "{", "}",
+        "func", "name", "->", "int", "\"str\"", "'c'", "// comment\n", "/* block */", ":=", "!=", "-=", "return"
+    };
+
+    const u64 TEXT_LENGTH = MB(16);
+    char* text = (char*)Memory::global_general_allocator.malloc(TEXT_LENGTH);
+    u64 length = 0;
+    u64 seed = 9;
+    while (true) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const char* part = parts[(seed >> 33) % ArrayCount(parts)];
+        u64 part_length = String::length(part);
+        if (length + part_length + 1 > TEXT_LENGTH) {
+            break;
+        }
+
+        Memory::copy(text + length, TEXT_LENGTH - length, part, part_length);
+        length += part_length;
+        text[length++] = ' ';
+    }
+
+    // the first run pays for growing the token array, the second one is lexing only
+    DS::Vector<Token> warm_up = DS::Vector<Token>(&Memory::global_general_allocator, 1);
+    double start = Platform::get_seconds_elapsed();
+    Lexer::generate_tokens((u8*)text, length, warm_up);
+    double cold_seconds = Platform::get_seconds_elapsed() - start;
+
+    DS::Vector<Token> tokens = DS::Vector<Token>(&Memory::global_general_allocator, warm_up.count());
+    start = Platform::get_seconds_elapsed();
+    Lexer::generate_tokens((u8*)text, length, tokens);
+    double warm_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(tokens.count() == warm_up.count());
+
+    // pulling through the lookahead ring never touches more than TOKEN_STREAM_LOOKAHEAD tokens
+    TokenStream stream = TokenStream((u8*)text, length);
+    u64 streamed = 0;
+    start = Platform::get_seconds_elapsed();
+    while (!stream.is_eof()) {
+        stream.consume_next_token();
+        streamed += 1;
+    }
+    double stream_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(streamed == tokens.count());
+
+    double megabytes = (double)length / (double)MB(1);
+    LOG_INFO("lexer         | %7.1f MB/s (with token array growth %7.1f MB/s) | %llu tokens\n",
+        megabytes / warm_seconds, megabytes / cold_seconds, (unsigned long long)tokens.count()
+    );
+    LOG_INFO("token stream  | %7.1f MB/s | %llu tokens resident\n", megabytes / stream_seconds, (unsigned long long)TOKEN_STREAM_LOOKAHEAD);
+
+    DS::Vector<Token> parallel_tokens = DS::Vector<Token>(&Memory::global_general_allocator, warm_up.count());
+    start = Platform::get_seconds_elapsed();
+    Lexer::generate_tokens_parallel((u8*)text, length, parallel_tokens);
+    double parallel_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(parallel_tokens.count() == tokens.count());
+    LOG_INFO("lexer parallel| %7.1f MB/s | %u threads\n", megabytes / parallel_seconds, Platform::get_processor_count());
+
+    DS::Vector<CompactToken> compact_tokens = DS::Vector<CompactToken>(&Memory::global_general_allocator, warm_up.count());
+    DS::Vector<TokenValue> literals = DS::Vector<TokenValue>(&Memory::global_general_allocator, warm_up.count() / 4);
+    start = Platform::get_seconds_elapsed();
+    Lexer::generate_compact_tokens((u8*)text, length, compact_tokens, literals);
+    double compact_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    SourceMap source_map = SourceMap(&Memory::global_general_allocator, DS::View<char>(text, length));
+    double source_map_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(compact_tokens.count() == tokens.count());
+    LOG_INFO("lexer compact | %7.1f MB/s | %llu vs %llu bytes per token | source map %7.1f MB/s\n",
+        megabytes / compact_seconds, (unsigned long long)sizeof(CompactToken), (unsigned long long)sizeof(Token), megabytes / source_map_seconds
+    );
+
+    // a hit pays for hashing the source, the SourceMap and interning names, against the token stream above
+    const char* cache_path = "benchmark_lexer" TOKEN_CACHE_EXTENSION;
+    Error error = ERROR_SUCCESS;
+    TokenCache writer = TokenCache(&Memory::global_general_allocator, DS::View<char>(text, length));
+    RUNTIME_ASSERT(writer.store(cache_path, error));
+
+    start = Platform::get_seconds_elapsed();
+    TokenCache cache = TokenCache(&Memory::global_general_allocator, DS::View<char>(text, length));
+    RUNTIME_ASSERT(cache.load(cache_path));
+    TokenStream cached_stream = TokenStream(&cache);
+    u64 cached = 0;
+    while (!cached_stream.is_eof()) {
+        cached_stream.consume_next_token();
+        cached += 1;
+    }
+    double cache_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(cached == tokens.count());
+    LOG_INFO("token cache   | %7.1f MB/s | hit, streamed from the mapped file\n", megabytes / cache_seconds);
+    remove(cache_path);
+
+    Memory::global_general_allocator.free(text);
+}
+
+void count_read_file(u64 file_index, u8* data, byte_t file_size, Error error, void* user_data) {
+    (void)file_index;
+    RUNTIME_ASSERT(error == ERROR_SUCCESS);
+    *(u64*)user_data += file_size;
+    Memory::global_general_allocator.free(data);
+}
+
+void benchmark_read_files() {
+    // many small sources, where the cost is per file latency rather than bandwidth
+    const u64 FILE_COUNT = 512;
+    const u64 FILE_SIZE = KB(4);
+    char (*paths)[32] = (char(*)[32])Memory::global_general_allocator.malloc(FILE_COUNT * 32);
+    const char** path_pointers = (const char**)Memory::global_general_allocator.malloc(FILE_COUNT * sizeof(char*));
+    char contents[FILE_SIZE];
+    Memory::zero(contents, FILE_SIZE);
+
+    Error error = ERROR_SUCCESS;
+    for (u64 i = 0; i < FILE_COUNT; i++) {
+        snprintf(paths[i], 32, "benchmark_read_%llu.ion", (unsigned long long)i);
+        path_pointers[i] = paths[i];
+        RUNTIME_ASSERT(Platform::write_entire_file(paths[i], contents, FILE_SIZE, error));
+    }
+
+    double start = Platform::get_seconds_elapsed();
+    u64 serial_bytes = 0;
+    for (u64 i = 0; i < FILE_COUNT; i++) {
+        byte_t file_size = 0;
+        u8* data = Platform::read_entire_file(&Memory::global_general_allocator, path_pointers[i], file_size, error);
+        serial_bytes += file_size - 1;
+        Memory::global_general_allocator.free(data);
+    }
+    double serial_seconds = Platform::get_seconds_elapsed() - start;
+
+    start = Platform::get_seconds_elapsed();
+    u64 async_bytes = 0;
+    Platform::read_files_async(path_pointers, FILE_COUNT, count_read_file, &async_bytes);
+    double async_seconds = Platform::get_seconds_elapsed() - start;
+
+    RUNTIME_ASSERT(serial_bytes == async_bytes && async_bytes == FILE_COUNT * FILE_SIZE);
+    LOG_INFO("read files    | read_entire_file %7.0f files/s | read_files_async %7.0f files/s | %llu x %llu bytes, page cache warm\n",
+        (double)FILE_COUNT / serial_seconds, (double)FILE_COUNT / async_seconds, (unsigned long long)FILE_COUNT, (unsigned long long)FILE_SIZE
+    );
+
+    for (u64 i = 0; i < FILE_COUNT; i++) {
+        remove(paths[i]);
+    }
+
+    Memory::global_general_allocator.free(paths);
+    Memory::global_general_allocator.free(path_pointers);
+}
+
 int main() {
+    Platform::initialize();
+
+    test_utf8_validate_threads();
     test_basic_put_get();
     test_overwrite();
     test_remove();
@@ -259,8 +2212,43 @@ int main() {
     test_custom_struct_keys();
     test_edge_cases();
     test_clear();
+    test_string_hash();
+    test_streaming_hasher();
+    test_hash_many();
+    test_put_many();
+    test_hashmap_tombstone_churn();
+    test_lru_cache_eviction_order();
+    test_lru_cache_cost_budget();
+    test_interner();
+    test_index_of();
+    test_string_builder();
+    test_format_numbers();
+    test_parse_number();
+    test_utf8_and_length();
+    test_str();
+    test_split();
+    test_rope();
+    test_lexer();
+    test_token_stream();
+    test_parallel_lexer();
+    test_compact_tokens();
+    test_relex();
+    test_token_cache();
+    test_map_file();
+    test_read_files_async();
+    test_copy_file();
 
     LOG_INFO("All tests passed ✅\n");
+    benchmark_hashing();
+    benchmark_index_of();
+    benchmark_format_numbers();
+    benchmark_parse_number();
+    benchmark_utf8_and_length();
+    benchmark_split();
+    benchmark_rope();
+    benchmark_lexer();
+    benchmark_read_files();
+
     JSON* root = JSON::Object(&Memory::global_general_allocator);
     root->push("name", "Example");
     root->push("age", 200.003f);